@@ -0,0 +1,263 @@
+#ifndef JAASSETPACK_H
+#define JAASSETPACK_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JAASSETPACK_HAS_MMAP 1
+#else
+#define JAASSETPACK_HAS_MMAP 0
+#endif
+
+/*
+ * Binary sprite pack, written by `tools/jasprite_convert --pack`.
+ *
+ *   JaPackHeader
+ *   JaPackEntry[sprite_count]   sorted by name_hash, so lookups are a binary search
+ *   name strings                NUL terminated
+ *   palette and pixel blobs     each starts on a JAPACK_ALIGN boundary
+ *
+ * All fields are little-endian. Nothing is parsed up front: opening a pack only checks the
+ * header, and each JaSprite handed out is a view straight into the mapped file.
+ */
+
+constexpr uint32_t JAPACK_MAGIC = 0x4B41504A; // "JPAK"
+constexpr uint16_t JAPACK_VERSION = 1;
+constexpr uint32_t JAPACK_ALIGN = 16;
+
+struct JaPackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;    // sizeof(JaPackEntry), so readers can reject mismatched builds
+    uint32_t sprite_count;
+    uint32_t index_offset;  // byte offset of the first JaPackEntry
+    uint32_t file_size;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(JaPackHeader) == 32, "JaPackHeader layout is part of the file format");
+
+struct JaPackEntry {
+    uint32_t name_hash;     // japackHash() of the name
+    uint32_t name_offset;
+    uint16_t width;
+    uint16_t height;
+    uint8_t encoding;       // JaSpriteEncoding
+    uint8_t bits_per_pixel;
+    uint16_t palette_count;
+    uint32_t palette_offset;
+    uint32_t pixel_offset;
+    uint32_t pixel_size;
+    uint32_t reserved;
+};
+static_assert(sizeof(JaPackEntry) == 32, "JaPackEntry layout is part of the file format");
+
+/**
+ * @brief FNV-1a hash used to index sprites by name.
+ */
+constexpr uint32_t japackHash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (; *name; ++name) {
+        h = (h ^ static_cast<uint8_t>(*name)) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Read-only view of a sprite pack, either memory-mapped from a file or pointing at data
+ * already in memory (e.g. a pack linked into flash).
+ */
+class JaAssetPack {
+public:
+    JaAssetPack() = default;
+    ~JaAssetPack() { close(); }
+    JaAssetPack(const JaAssetPack&) = delete;
+    JaAssetPack& operator=(const JaAssetPack&) = delete;
+
+    /**
+     * @brief Maps a pack file. Falls back to reading it into memory where mmap isn't available.
+     * @return false if the file can't be opened or isn't a valid pack.
+     */
+    bool open(const char* path) {
+        close();
+#if JAASSETPACK_HAS_MMAP
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (mapping == MAP_FAILED) return false;
+        mapped = mapping;
+        mapped_size = static_cast<size_t>(st.st_size);
+        if (!fromMemory(mapped, mapped_size)) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        std::vector<uint8_t> contents;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            contents.insert(contents.end(), chunk, chunk + n);
+        }
+        fclose(f);
+        owned = std::move(contents);
+        if (!fromMemory(owned.data(), owned.size())) {
+            close();
+            return false;
+        }
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Uses a pack that is already in memory. The data must outlive this object and be
+     * aligned to at least 4 bytes.
+     * @return false if the data isn't a valid pack.
+     */
+    bool fromMemory(const void* data, size_t size) {
+        if (!data || size < sizeof(JaPackHeader)) return false;
+        const auto* h = static_cast<const JaPackHeader*>(data);
+        if (h->magic != JAPACK_MAGIC || h->version != JAPACK_VERSION || h->entry_size != sizeof(JaPackEntry)) return false;
+        if (h->file_size > size) return false;
+        if (h->index_offset % alignof(JaPackEntry) != 0 ||
+            h->index_offset > h->file_size ||
+            static_cast<uint64_t>(h->sprite_count) * sizeof(JaPackEntry) > h->file_size - h->index_offset) {
+            return false;
+        }
+        base = static_cast<const uint8_t*>(data);
+        base_size = h->file_size;
+        entries = {reinterpret_cast<const JaPackEntry*>(base + h->index_offset), h->sprite_count};
+        return true;
+    }
+
+    void close() {
+#if JAASSETPACK_HAS_MMAP
+        if (mapped) munmap(mapped, mapped_size);
+#endif
+        mapped = nullptr;
+        mapped_size = 0;
+        owned.clear();
+        owned.shrink_to_fit();
+        base = nullptr;
+        base_size = 0;
+        entries = {};
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Name of the sprite at `index`, or "" if out of range.
+     */
+    const char* name(size_t index) const {
+        if (index >= entries.size() || entries[index].name_offset >= base_size) return "";
+        const char* n = reinterpret_cast<const char*>(base + entries[index].name_offset);
+        // A name running into the end of the pack is corrupt.
+        if (strnlen(n, base_size - entries[index].name_offset) == base_size - entries[index].name_offset) return "";
+        return n;
+    }
+
+    /**
+     * @brief Returns a view of the sprite at `index`. Out-of-range indices and corrupt entries
+     * (unknown encoding, blobs outside the pack or too small for the sprite) give an empty
+     * sprite, which drawSprite() ignores.
+     */
+    JaSprite sprite(size_t index) const {
+        if (index >= entries.size()) return JaSprite();
+        const JaPackEntry& e = entries[index];
+        if (e.palette_offset % alignof(uint32_t) != 0 ||
+            static_cast<uint64_t>(e.palette_offset) + e.palette_count * sizeof(uint32_t) > base_size ||
+            static_cast<uint64_t>(e.pixel_offset) + e.pixel_size > base_size) {
+            return JaSprite();
+        }
+        if (e.bits_per_pixel != 1 && e.bits_per_pixel != 2 && e.bits_per_pixel != 4 && e.bits_per_pixel != 8) {
+            return JaSprite();
+        }
+        std::span<const uint32_t> palette(reinterpret_cast<const uint32_t*>(base + e.palette_offset), e.palette_count);
+        std::span<const uint8_t> pixels(base + e.pixel_offset, e.pixel_size);
+        const auto encoding = static_cast<JaSpriteEncoding>(e.encoding);
+        const JaSprite s(e.width, e.height, palette, pixels, encoding, e.bits_per_pixel);
+        switch (encoding) {
+            case JaSpriteEncoding::RAW:
+                if (e.pixel_size < static_cast<uint64_t>(e.width) * e.height) return JaSprite();
+                break;
+            case JaSpriteEncoding::PACKED:
+                if (e.pixel_size < static_cast<uint64_t>(s.packedStride()) * e.height) return JaSprite();
+                break;
+            case JaSpriteEncoding::RLE:
+                if (!rleFits(s)) return JaSprite();
+                break;
+            default:
+                return JaSprite();
+        }
+        return s;
+    }
+
+    /**
+     * @brief Index of the sprite called `sprite_name`, or -1 if the pack doesn't have one.
+     */
+    long indexOf(const char* sprite_name) const {
+        const uint32_t h = japackHash(sprite_name);
+        size_t lo = 0, hi = entries.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (entries[mid].name_hash < h) lo = mid + 1; else hi = mid;
+        }
+        // Hash collisions sit next to each other, so compare names until the hash changes.
+        for (size_t i = lo; i < entries.size() && entries[i].name_hash == h; ++i) {
+            if (strcmp(name(i), sprite_name) == 0) return static_cast<long>(i);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Looks a sprite up by name. Returns an empty sprite if it isn't in the pack.
+     */
+    JaSprite find(const char* sprite_name) const {
+        long i = indexOf(sprite_name);
+        return i < 0 ? JaSprite() : sprite(static_cast<size_t>(i));
+    }
+
+private:
+    // Whether every row of an RLE sprite is made of whole runs adding up to exactly its width,
+    // all inside its pixel data, as decodeRow() assumes.
+    static bool rleFits(const JaSprite& s) {
+        size_t pos = 0;
+        for (int row = 0; row < s.height; ++row) {
+            int covered = 0;
+            while (covered < s.width) {
+                if (pos + 2 > s.pixels.size()) return false;
+                covered += s.pixels[pos];
+                pos += 2;
+            }
+            if (covered != s.width) return false;
+        }
+        return true;
+    }
+
+    void* mapped = nullptr;
+    size_t mapped_size = 0;
+    std::vector<uint8_t> owned; // only used when mmap is unavailable
+    const uint8_t* base = nullptr;
+    size_t base_size = 0;
+    std::span<const JaPackEntry> entries;
+};
+
+#endif // JAASSETPACK_H
@@ -0,0 +1,105 @@
+#ifndef JACOLLISIONMASK_H
+#define JACOLLISIONMASK_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Solid/empty bitmap of a sprite for pixel-exact collision tests.
+ *
+ * Each row is one 64-bit word with column 0 in the most significant bit, so masks are limited
+ * to 64 pixels wide. Testing two masks against each other is one shift and one AND per
+ * overlapping row, cheap enough to run on every candidate pair each frame. Build masks once
+ * (e.g. in setup()) and keep them alongside the sprites.
+ */
+class JaCollisionMask {
+public:
+    static constexpr int MAX_WIDTH = 64;
+
+    JaCollisionMask() = default;
+
+    /**
+     * @brief Builds the mask from a sprite's palette alpha. Pixels with alpha above
+     * `alpha_threshold` count as solid. Sprites wider than MAX_WIDTH give an empty mask.
+     */
+    explicit JaCollisionMask(const JaSprite& sprite, uint8_t alpha_threshold = 0) {
+        if (sprite.width <= 0 || sprite.width > MAX_WIDTH || sprite.height <= 0 ||
+            sprite.pixels.empty() || sprite.palette.empty()) {
+            return;
+        }
+        width = sprite.width;
+        height = sprite.height;
+        rows.assign(height, 0);
+
+        uint8_t row_indices[MAX_WIDTH];
+        size_t rle_pos = 0;
+        for (int y = 0; y < height; ++y) {
+            if (sprite.encoding == JaSpriteEncoding::RLE) {
+                sprite.decodeRleRow(rle_pos, 0, width, row_indices);
+            } else {
+                sprite.decodeRow(y, 0, width, row_indices);
+            }
+            uint64_t bits = 0;
+            for (int x = 0; x < width; ++x) {
+                uint8_t index = row_indices[x];
+                if (index < sprite.palette.size() && JADRAW_ALPHA(sprite.palette[index]) > alpha_threshold) {
+                    bits |= columnBit(x);
+                }
+            }
+            rows[y] = bits;
+        }
+    }
+
+    bool isEmpty() const { return rows.empty(); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    /**
+     * @brief Whether the pixel at (x, y) of the mask is solid. Outside the mask is empty.
+     */
+    bool isSolid(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return false;
+        return (rows[y] & columnBit(x)) != 0;
+    }
+
+    /**
+     * @brief Pixel-exact overlap test between this mask placed at (x, y) and `other` placed at
+     * (other_x, other_y), both in the same (screen) coordinates.
+     */
+    bool overlaps(int x, int y, const JaCollisionMask& other, int other_x, int other_y) const {
+        if (isEmpty() || other.isEmpty()) return false;
+
+        // Bounding boxes first; this also keeps the shift below in range.
+        const int dx = other_x - x;
+        if (dx >= width || -dx >= other.width) return false;
+        const int y1 = std::max(y, other_y);
+        const int y2 = std::min(y + height, other_y + other.height);
+        if (y1 >= y2) return false;
+
+        const uint64_t* a = &rows[y1 - y];
+        const uint64_t* b = &other.rows[y1 - other_y];
+        const int count = y2 - y1;
+        if (dx >= 0) {
+            for (int i = 0; i < count; ++i) {
+                if (a[i] & (b[i] >> dx)) return true;
+            }
+        } else {
+            for (int i = 0; i < count; ++i) {
+                if (a[i] & (b[i] << -dx)) return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr uint64_t columnBit(int x) { return uint64_t(1) << (MAX_WIDTH - 1 - x); }
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint64_t> rows;
+};
+
+#endif // JACOLLISIONMASK_H
@@ -0,0 +1,560 @@
+#ifndef JADITHER_H
+#define JADITHER_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JADITHER_SIMD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define JADITHER_SIMD_NEON 1
+#endif
+
+/**
+ * @brief How JaDither::ditherToMono() picks which pixels to light.
+ */
+enum class JaDitherMethod : uint8_t {
+    FLOYD_STEINBERG, // Error diffusion to the right and the row below
+    ATKINSON,        // Error diffusion over two rows, dropping a quarter of it for more contrast
+    BLUE_NOISE,      // Ordered, with BLUE_NOISE_32X32
+    BAYER            // Ordered, with BAYER_8X8
+};
+
+/**
+ * @brief A square, tileable table of ordered-dither thresholds (0-254). A pixel of brightness
+ * level L (0-255) is lit where L > threshold, so 0 is always dark and 255 always lit. N must be
+ * a power of two.
+ */
+template <int N>
+struct JaDitherMatrix {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Dither matrix size must be a power of two");
+    static constexpr int size = N;
+    uint8_t thresholds[N][N];
+
+    constexpr uint8_t at(int x, int y) const { return thresholds[y & (N - 1)][x & (N - 1)]; }
+    constexpr const uint8_t* row(int y) const { return thresholds[y & (N - 1)]; }
+
+    /**
+     * @brief Copies `count` thresholds of row `y`, starting at column `x` and repeating the row as
+     * needed, so JaDither::thresholdSpan() can read them in one run.
+     */
+    void tileRow(int x, int y, int count, uint8_t* out) const {
+        const uint8_t* r = row(y);
+        int column = x & (N - 1);
+        while (count > 0) {
+            const int n = count < N - column ? count : N - column;
+            memcpy(out, r + column, static_cast<size_t>(n));
+            out += n;
+            count -= n;
+            column = 0;
+        }
+    }
+};
+
+namespace JaDither {
+
+/**
+ * @brief The NxN Bayer matrix, scaled to 0-254 so that level 255 lights every pixel. Built at
+ * compile time.
+ */
+template <int N>
+constexpr JaDitherMatrix<N> bayerMatrix() {
+    JaDitherMatrix<N> m = {};
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            // Interleave the bits of x ^ y and y, lowest bits first, into the most significant end.
+            int v = 0;
+            for (int bit = 1; bit < N; bit <<= 1) {
+                v = (v << 2) | (((x ^ y) & bit) ? 2 : 0) | ((y & bit) ? 1 : 0);
+            }
+            m.thresholds[y][x] = static_cast<uint8_t>(v * 255 / (N * N));
+        }
+    }
+    return m;
+}
+
+namespace detail {
+
+// exp() for the Gaussian below; <cmath>'s isn't constexpr.
+constexpr double constexprExp(double x) {
+    int halvings = 0;
+    while (x < -0.5) {
+        x *= 0.5;
+        ++halvings;
+    }
+    double term = 1.0, sum = 1.0;
+    for (int i = 1; i < 12; ++i) {
+        term *= x / i;
+        sum += term;
+    }
+    while (halvings-- > 0) {
+        sum *= sum;
+    }
+    return sum;
+}
+
+} // namespace detail
+
+/**
+ * @brief An NxN blue-noise threshold matrix made with Ulichney's void-and-cluster method, at
+ * compile time. Thresholds have no low-frequency structure, so dithered gradients look like
+ * even grain instead of Bayer's cross-hatching, and the matrix tiles without seams.
+ *
+ * `seed` picks the starting pattern. 32x32 takes a couple of seconds to evaluate at compile
+ * time (BLUE_NOISE_32X32 is a ready-made copy) and is plenty for small screens; much larger ones
+ * can exceed the compiler's constexpr limits, but can still be made at run time.
+ */
+template <int N>
+constexpr JaDitherMatrix<N> blueNoiseMatrix(uint32_t seed = 1) {
+    constexpr int COUNT = N * N;
+    constexpr double SIGMA = 1.5;
+
+    // Gaussian weight by distance; the energy of a pixel is the sum of these over all the set
+    // pixels (wrapping around the edges), so clusters have high energy and voids low. Weights
+    // further out than RADIUS are negligible and left out.
+    constexpr int RADIUS = N / 2 < 5 ? N / 2 : 5;
+    double weight[2 * RADIUS + 1][2 * RADIUS + 1] = {};
+    for (int dy = -RADIUS; dy <= RADIUS; ++dy) {
+        for (int dx = -RADIUS; dx <= RADIUS; ++dx) {
+            weight[dy + RADIUS][dx + RADIUS] = detail::constexprExp(-(dx * dx + dy * dy) / (2.0 * SIGMA * SIGMA));
+        }
+    }
+
+    bool set[COUNT] = {};
+    double energy[COUNT] = {};
+    // Per row, the set pixel with the most energy (tightest cluster) and the empty one with the
+    // least (largest void), or -1, so finding the best pixel overall only looks at N rows.
+    int row_cluster[N] = {};
+    int row_void[N] = {};
+    auto rescanRow = [&](int y) {
+        int cluster = -1, hole = -1;
+        for (int p = y * N; p < (y + 1) * N; ++p) {
+            if (set[p]) {
+                if (cluster < 0 || energy[p] > energy[cluster]) cluster = p;
+            } else if (hole < 0 || energy[p] < energy[hole]) {
+                hole = p;
+            }
+        }
+        row_cluster[y] = cluster;
+        row_void[y] = hole;
+    };
+    for (int y = 0; y < N; ++y) rescanRow(y);
+
+    // Setting a pixel raises the energy around it, which can only make clusters tighter and
+    // voids smaller (and clearing it the reverse). So the pixels that got better are checked
+    // against their row's best as they change, and a row is only rescanned when its best one
+    // got worse.
+    auto toggle = [&](int p, bool on) {
+        set[p] = on;
+        const int px = p % N, py = p / N;
+        for (int dy = -RADIUS; dy <= RADIUS; ++dy) {
+            const int y = (py + dy) & (N - 1);
+            int& improved = on ? row_cluster[y] : row_void[y];
+            const int worsened = on ? row_void[y] : row_cluster[y];
+            bool rescan = worsened == p;
+            for (int dx = -RADIUS; dx <= RADIUS; ++dx) {
+                const int q = y * N + ((px + dx) & (N - 1));
+                const double w = weight[dy + RADIUS][dx + RADIUS];
+                energy[q] += on ? w : -w;
+                if (set[q] != on) {
+                    rescan = rescan || q == worsened;
+                } else if (improved < 0 || (on ? energy[q] > energy[improved] : energy[q] < energy[improved])) {
+                    improved = q;
+                }
+            }
+            if (rescan) rescanRow(y);
+        }
+    };
+    auto find = [&](bool cluster) {
+        int best = -1;
+        for (int y = 0; y < N; ++y) {
+            const int p = cluster ? row_cluster[y] : row_void[y];
+            if (p >= 0 && (best < 0 || (cluster ? energy[p] > energy[best] : energy[p] < energy[best]))) {
+                best = p;
+            }
+        }
+        return best;
+    };
+
+    // 1. A random starting pattern with a tenth of the pixels set, then relaxed by moving
+    //    the tightest cluster's pixel into the largest void until that's the same pixel.
+    uint32_t state = seed ? seed : 1;
+    const int num_initial = COUNT / 10 > 0 ? COUNT / 10 : 1;
+    for (int placed = 0; placed < num_initial;) {
+        state = state * 1664525u + 1013904223u;
+        const int p = static_cast<int>((state >> 8) % COUNT);
+        if (!set[p]) {
+            toggle(p, true);
+            ++placed;
+        }
+    }
+    for (int moves = 0; moves < COUNT; ++moves) {
+        const int cluster = find(true);
+        toggle(cluster, false);
+        const int hole = find(false);
+        toggle(hole, true);
+        if (hole == cluster) break;
+    }
+    bool initial[COUNT] = {};
+    for (int p = 0; p < COUNT; ++p) initial[p] = set[p];
+
+    // 2. Rank the starting pixels by taking tightest clusters away, highest rank first.
+    int rank[COUNT] = {};
+    for (int r = num_initial - 1; r >= 0; --r) {
+        const int p = find(true);
+        toggle(p, false);
+        rank[p] = r;
+    }
+
+    // 3. From the starting pattern again, fill the largest voids until every pixel is set.
+    for (int p = 0; p < COUNT; ++p) {
+        if (initial[p]) toggle(p, true);
+    }
+    for (int r = num_initial; r < COUNT; ++r) {
+        const int p = find(false);
+        toggle(p, true);
+        rank[p] = r;
+    }
+
+    JaDitherMatrix<N> m = {};
+    for (int p = 0; p < COUNT; ++p) {
+        m.thresholds[p / N][p % N] = static_cast<uint8_t>(rank[p] * 255 / COUNT);
+    }
+    return m;
+}
+
+/**
+ * @brief Dithers `count` pixels: pixel i becomes `on_color` where `levels[i]` > `thresholds[i]`,
+ * otherwise `off_color`, or stays as it is if `keep_off`. Compares 16 pixels per instruction
+ * with SSE2 or NEON.
+ *
+ * @param levels Brightness per pixel (0-255), or NULL to use `level` for all of them.
+ */
+inline void thresholdSpan(uint32_t* pixels, int count, const uint8_t* levels, uint8_t level,
+                          const uint8_t* thresholds, uint32_t on_color, uint32_t off_color, bool keep_off = false) {
+    int i = 0;
+#if defined(JADITHER_SIMD_SSE2)
+    // SSE2 only compares signed bytes, so flip the top bits to compare unsigned.
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i flat = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(level)), bias);
+    const __m128i on = _mm_set1_epi32(static_cast<int>(on_color));
+    const __m128i off = _mm_set1_epi32(static_cast<int>(off_color));
+    for (; i + 16 <= count; i += 16) {
+        const __m128i l = levels ? _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i)), bias) : flat;
+        const __m128i t = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds + i)), bias);
+        const __m128i lit = _mm_cmpgt_epi8(l, t);
+        // Widen the byte masks to one 32-bit mask per pixel.
+        const __m128i lit16[2] = {_mm_unpacklo_epi8(lit, lit), _mm_unpackhi_epi8(lit, lit)};
+        for (int half = 0; half < 2; ++half) {
+            const __m128i lit32[2] = {_mm_unpacklo_epi16(lit16[half], lit16[half]), _mm_unpackhi_epi16(lit16[half], lit16[half])};
+            for (int quarter = 0; quarter < 2; ++quarter) {
+                __m128i* p = reinterpret_cast<__m128i*>(pixels + i + half * 8 + quarter * 4);
+                const __m128i other = keep_off ? _mm_loadu_si128(p) : off;
+                _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(lit32[quarter], on), _mm_andnot_si128(lit32[quarter], other)));
+            }
+        }
+    }
+#elif defined(JADITHER_SIMD_NEON)
+    const uint8x16_t flat = vdupq_n_u8(level);
+    const uint32x4_t on = vdupq_n_u32(on_color);
+    const uint32x4_t off = vdupq_n_u32(off_color);
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t lit = vcgtq_u8(levels ? vld1q_u8(levels + i) : flat, vld1q_u8(thresholds + i));
+        // Widen the byte masks to one 32-bit mask per pixel.
+        const uint8x16x2_t lit16 = vzipq_u8(lit, lit);
+        for (int half = 0; half < 2; ++half) {
+            const uint16x8_t l16 = vreinterpretq_u16_u8(lit16.val[half]);
+            const uint16x8x2_t lit32 = vzipq_u16(l16, l16);
+            for (int quarter = 0; quarter < 2; ++quarter) {
+                uint32_t* p = pixels + i + half * 8 + quarter * 4;
+                const uint32x4_t other = keep_off ? vld1q_u32(p) : off;
+                vst1q_u32(p, vbslq_u32(vreinterpretq_u32_u16(lit32.val[quarter]), on, other));
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if ((levels ? levels[i] : level) > thresholds[i]) {
+            pixels[i] = on_color;
+        } else if (!keep_off) {
+            pixels[i] = off_color;
+        }
+    }
+}
+
+/**
+ * @brief thresholdSpan() with one brightness level for the whole span.
+ */
+inline void thresholdSpan(uint32_t* pixels, int count, uint8_t level, const uint8_t* thresholds,
+                          uint32_t on_color, uint32_t off_color, bool keep_off = false) {
+    thresholdSpan(pixels, count, nullptr, level, thresholds, on_color, off_color, keep_off);
+}
+
+/**
+ * @brief Clamps a brightness level to the 0-255 range the threshold functions take.
+ */
+constexpr uint8_t clampLevel(int32_t level) {
+    return static_cast<uint8_t>(level < 0 ? 0 : (level > 255 ? 255 : level));
+}
+
+// Shared tables, so applets don't each carry their own copies.
+inline constexpr JaDitherMatrix<8> BAYER_8X8 = bayerMatrix<8>();
+
+// blueNoiseMatrix<32>(1), written out once: generating it at compile time would cost every
+// file that includes this header a couple of seconds. To regenerate, print the thresholds of
+// a blueNoiseMatrix<32>(1) made at run time.
+inline constexpr JaDitherMatrix<32> BLUE_NOISE_32X32 = {{
+    {217, 100,  21,  75, 198, 253, 121,  26, 191,  48, 146, 253,  35, 220,   0, 113,
+     230, 144,  77, 206,  42,  91,  11,  57, 223, 199,  37, 232, 151, 206, 180,  43},
+    {158, 195, 172,  37, 154,  14,  88, 232,  66, 176,  15, 101, 192,  87, 152, 182,
+      62,  11, 243, 108, 167, 131, 209, 161,  81, 179, 102,  69,  12, 115, 245, 132},
+    { 82,  56, 244, 117, 218,  55, 162, 207, 134,  83, 228, 162,  58, 136,  44, 247,
+     101, 156,  50, 195,  26,  64, 246,  35, 119,   3, 251, 133, 189,  89,  62,  22},
+    {234, 145,   7,  92, 137, 186, 103,  39,   2, 198, 112,  27, 238, 208, 120,  22,
+     215, 187, 129,  85, 229, 175,  99, 191, 146,  53, 157, 213,  40, 226, 165, 201},
+    { 38, 106, 191, 226,  71,  16, 236, 127, 248, 150,  46, 185,  76,   7, 170,  88,
+      67,  34, 235,   4, 149, 122,  13,  70, 235, 203,  87,  19, 109, 144,   4, 122},
+    {214, 173,  54,  29, 165, 211,  51, 176,  68,  94, 222, 130, 155, 106, 231, 199,
+     142, 174, 112,  59, 219,  45, 205, 137,  22, 111, 183,  65, 241,  50, 182,  91},
+    { 14, 139,  81, 247, 123,  86, 149, 109,  29, 208,  10,  60, 249,  32,  52, 124,
+      14, 253,  94, 160, 189,  83, 250,  96, 174,  36, 227, 131, 168, 205,  74, 254},
+    { 59, 113, 217, 152,  41, 198,  12, 226, 189, 156, 116, 180,  91, 194, 165, 220,
+      79,  45, 210,  16, 119,  30, 163,  61, 216, 151,  79,   8,  97,  25, 125, 158},
+    {230,  24, 180,   4, 102, 233,  64, 127,  36,  79, 233,  21, 142,  73,   5, 104,
+     149, 188, 129,  72, 239, 143, 194,   0, 126,  51, 248, 197, 147, 217,  40, 188},
+    {143,  95, 204,  70, 166, 137, 179,  95, 254, 136,  47, 216, 111, 238, 203,  56,
+     244,  20, 166, 224,  50, 105,  77, 234, 102, 178,  20, 119,  54, 242, 107,  80},
+    { 31, 246,  48, 117, 239,  19,  51, 206,   2, 172, 200,  64, 160,  37, 133, 176,
+     114,  39,  97, 197,   9, 168, 205,  25, 159, 218,  88, 184,  72, 164,   2, 212},
+    { 63, 162, 134, 193,  35, 215,  84, 153, 118,  74, 104,  10, 188,  93,  23, 227,
+      77, 211, 138,  67, 122, 248,  38, 137,  68,  44, 141, 229,  28, 202, 132, 179},
+    {229, 100,   8,  78, 148, 105, 185, 230,  33, 241, 147, 219, 126, 250,  66, 150,
+       0, 164, 242,  24, 152,  87, 181, 116, 240, 196,   7, 106, 155,  93,  41, 119},
+    { 20, 200, 222, 175, 248,  65,  13, 134,  57, 193,  25,  80,  46, 164, 207, 121,
+     195,  92,  43, 187, 221,  55, 213,  18,  80, 172, 127, 252,  53, 214, 239,  77},
+    {150,  56, 112,  26,  47, 124, 171, 209,  94, 156, 116, 179, 233,  13, 105,  34,
+      57, 223, 129,  76, 107,   6, 145, 100, 229,  59,  31,  84, 177,  10, 136, 186},
+    {250,  89, 161, 132, 189, 225,  85,  37, 254,   5, 222,  60, 135,  84, 184, 245,
+     145, 177,  21, 161, 253, 194, 169,  41, 130, 156, 221, 204, 146,  73, 111,  32},
+    {173,   1, 207, 241,  75,   7, 152, 118, 182,  74, 104, 202,  27, 158, 213,  72,
+       9, 110, 236,  58,  33, 121,  66, 243, 199,   3,  94, 118,  18, 193, 231,  52},
+    {139, 108,  61,  31, 103, 202,  53, 236,  21, 143, 167,  40, 238, 100,  49, 125,
+     219,  81, 196,  97, 140, 214,  86,  27, 107, 183,  49, 246,  64, 157,  93, 209},
+    { 76, 233, 177, 146, 222, 128, 170,  98, 213,  55, 245, 122, 181,   0, 141, 174,
+      33, 153,  16, 171, 230,  11, 177, 147, 223,  74, 165, 139, 201,  38, 124,  22},
+    {188,  15, 120,  42, 184,  17,  75,  35, 190, 135,  12,  89,  63, 200, 231,  67,
+     249, 118, 210,  41,  73, 113, 202,  42, 128,  12, 232,  29,  88, 242, 166, 224},
+    { 45, 153, 251,  92,  65, 243, 154, 227, 114,  82, 209, 228, 155, 110,  23,  95,
+     190,  52,  86, 135, 240, 158,  59, 247,  95, 210, 109, 130, 185,   4,  63,  98},
+    {133,  71, 193,   6, 211, 136,  96,   1, 178,  46, 168,  30, 132,  44, 216, 163,
+       9, 148, 224, 186,   0, 101,  28, 169,  69, 178,  39,  58, 218, 148, 117, 203},
+    { 27, 221, 108, 173, 121,  46, 197,  62, 246, 144,  69, 102, 254, 192,  82, 128,
+     243, 107,  30,  65, 124, 199, 220, 131,  17, 196, 141, 252,  78,  20, 170, 237},
+    { 58, 163,  23,  80, 235,  28, 159, 216, 120,  15, 204, 181,   6,  60, 172,  34,
+      71, 204, 178, 159, 251,  47,  78, 153, 240,  90,   6, 160, 103, 197,  38,  86},
+    {249, 139, 205,  54, 143, 183,  73, 103,  39, 235,  83, 123, 151, 237, 114, 221,
+     144,  49,  98,  13,  90, 182, 120,  36,  61, 215, 123, 207,  50, 231, 115, 186},
+    { 99,  14, 125, 220,  91, 252,  19, 135, 192, 166,  26, 224,  45,  90,  23, 195,
+       3, 239, 126, 225, 142,  24, 237, 192, 110, 171,  32,  68, 175, 138,   1, 154},
+    { 71, 194,  40, 167,   3, 114, 163, 228,  55,  96, 142,  67, 201, 170, 134,  99,
+     155,  78, 187,  57, 208,  75, 164,   9, 228,  85, 149, 244,  24,  82, 210,  47},
+    {223, 113, 236,  68, 191,  52, 212,  81,  11, 249, 183, 111,   8, 218,  62, 251,
+      44, 212,  17, 109, 173,  43,  98, 145,  56,  19, 219,  99, 191, 125, 238, 167},
+    {133,  16, 148, 101, 244, 129,  31, 150, 203, 127,  33, 234, 151,  84,  30, 184,
+     116, 169, 140,  34, 234, 131, 212, 252, 115, 200, 130,  43, 162,  61,  15,  92},
+    {185,  60, 206,  28, 159,  85, 187, 110,  66, 175,  90,  54, 190, 106, 138, 226,
+      10,  70, 245,  89, 196,   1,  83,  29, 157,  70, 181,   5, 247, 112, 198,  36},
+    {250,  87, 176,  48, 215,   8, 225,  42, 242,   5, 160, 208,  18, 241,  49, 161,
+      97, 214,  51, 157, 117,  63, 190, 174,  48, 237,  93, 211,  79, 140, 225, 154},
+    {  2, 127, 232, 141, 108,  63, 169, 140,  96, 217, 115,  69, 128, 171,  76, 201,
+      32, 126, 180,  18, 227, 147, 240, 105, 138,  17, 123, 168,  53,  25, 104,  72}
+}};
+
+/**
+ * @brief Brightness (0-255) of an RGBA color, weighting green most as the eye does.
+ */
+constexpr uint8_t luma(uint32_t color) {
+    return static_cast<uint8_t>((JADRAW_RED(color) * 77 + JADRAW_GREEN(color) * 150 + JADRAW_BLUE(color) * 29) >> 8);
+}
+
+/**
+ * @brief luma() of `count` pixels, 16 at a time with SSE2 or NEON.
+ */
+inline void lumaRow(const uint32_t* pixels, int count, uint8_t* out) {
+    int i = 0;
+#if defined(JADITHER_SIMD_SSE2)
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    // One 16-bit channel value per pixel for 8 pixels.
+    auto channel = [&](const __m128i& a, const __m128i& b, int shift) {
+        const __m128i count_v = _mm_cvtsi32_si128(shift);
+        return _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(a, count_v), byte_mask),
+                               _mm_and_si128(_mm_srl_epi32(b, count_v), byte_mask));
+    };
+    for (; i + 16 <= count; i += 16) {
+        __m128i y16[2];
+        for (int half = 0; half < 2; ++half) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i + half * 8));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i + half * 8 + 4));
+            // At most 255 * 256, which fits unsigned 16-bit lanes.
+            const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(channel(a, b, 24), _mm_set1_epi16(77)),
+                                _mm_add_epi16(_mm_mullo_epi16(channel(a, b, 16), _mm_set1_epi16(150)),
+                                              _mm_mullo_epi16(channel(a, b, 8), _mm_set1_epi16(29))));
+            y16[half] = _mm_srli_epi16(sum, 8);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(y16[0], y16[1]));
+    }
+#elif defined(JADITHER_SIMD_NEON)
+    for (; i + 16 <= count; i += 16) {
+        // Splits the pixels' bytes into channels: alpha, blue, green, red on a little-endian CPU.
+        const uint8x16x4_t px = vld4q_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+        uint16x8_t lo = vmull_u8(vget_low_u8(px.val[3]), vdup_n_u8(77));
+        lo = vmlal_u8(lo, vget_low_u8(px.val[2]), vdup_n_u8(150));
+        lo = vmlal_u8(lo, vget_low_u8(px.val[1]), vdup_n_u8(29));
+        uint16x8_t hi = vmull_u8(vget_high_u8(px.val[3]), vdup_n_u8(77));
+        hi = vmlal_u8(hi, vget_high_u8(px.val[2]), vdup_n_u8(150));
+        hi = vmlal_u8(hi, vget_high_u8(px.val[1]), vdup_n_u8(29));
+        vst1q_u8(out + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = luma(pixels[i]);
+    }
+}
+
+/**
+ * @brief Sets bit i of `bits` (most significant bit first, as in a 1-bit JaSprite) where
+ * `levels[i]` > `thresholds[i]` and clears it otherwise. Compares 16 pixels per instruction
+ * with SSE2 or NEON.
+ */
+inline void thresholdBits(const uint8_t* levels, const uint8_t* thresholds, int count, uint8_t* bits) {
+    int i = 0;
+#if defined(JADITHER_SIMD_SSE2)
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    for (; i + 16 <= count; i += 16) {
+        __m128i lit = _mm_cmpgt_epi8(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i)), bias),
+                                     _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds + i)), bias));
+        // movemask puts the first pixel in the lowest bit, so reverse each group of 8 bytes first.
+        lit = _mm_or_si128(_mm_slli_epi16(lit, 8), _mm_srli_epi16(lit, 8));
+        lit = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lit, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        const int mask = _mm_movemask_epi8(lit);
+        bits[i / 8] = static_cast<uint8_t>(mask);
+        bits[i / 8 + 1] = static_cast<uint8_t>(mask >> 8);
+    }
+#elif defined(JADITHER_SIMD_NEON)
+    static const uint8_t BIT_WEIGHTS[16] = {128, 64, 32, 16, 8, 4, 2, 1, 128, 64, 32, 16, 8, 4, 2, 1};
+    const uint8x16_t weights = vld1q_u8(BIT_WEIGHTS);
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t lit = vandq_u8(vcgtq_u8(vld1q_u8(levels + i), vld1q_u8(thresholds + i)), weights);
+        // Add up each group of 8 weights into one byte.
+        uint8x8_t sum = vpadd_u8(vget_low_u8(lit), vget_high_u8(lit));
+        sum = vpadd_u8(sum, sum);
+        sum = vpadd_u8(sum, sum);
+        bits[i / 8] = vget_lane_u8(sum, 0);
+        bits[i / 8 + 1] = vget_lane_u8(sum, 1);
+    }
+#endif
+    if (i < count) memset(bits + i / 8, 0, static_cast<size_t>((count + 7) / 8 - i / 8));
+    for (; i < count; ++i) {
+        if (levels[i] > thresholds[i]) bits[i / 8] |= static_cast<uint8_t>(0x80 >> (i & 7));
+    }
+}
+
+/**
+ * @brief Bytes per row of a 1-bit image `width` pixels wide.
+ */
+constexpr int monoRowBytes(int width) { return (width + 7) / 8; }
+
+/**
+ * @brief Reduces the canvas to 1 bit per pixel for a monochrome display, so applets can draw in
+ * gray (or color) and dither the whole frame once at the end.
+ *
+ * `out` gets H rows of monoRowBytes(W) bytes, most significant bit first; a set bit is a lit
+ * pixel. The error-diffusion methods keep the brightness of large areas best and go row by row
+ * with two rows of error. The ordered ones are faster (SIMD) and stay stable in animation;
+ * `offset_x` and `offset_y` shift their thresholds, e.g. to make the noise shimmer over time.
+ */
+template <int W, int H>
+void ditherToMono(const JaDraw<W, H>& canvas, uint8_t* out, JaDitherMethod method, int offset_x = 0, int offset_y = 0) {
+    const int row_bytes = monoRowBytes(W);
+    uint8_t levels[W];
+
+    if (method == JaDitherMethod::BLUE_NOISE || method == JaDitherMethod::BAYER) {
+        uint8_t thresholds[W];
+        for (int y = 0; y < H; ++y) {
+            lumaRow(&canvas.canvas[static_cast<size_t>(y) * W], W, levels);
+            if (method == JaDitherMethod::BLUE_NOISE) {
+                BLUE_NOISE_32X32.tileRow(offset_x, y + offset_y, W, thresholds);
+            } else {
+                BAYER_8X8.tileRow(offset_x, y + offset_y, W, thresholds);
+            }
+            thresholdBits(levels, thresholds, W, out + y * row_bytes);
+        }
+        return;
+    }
+
+    // Error still to be added to a row's pixels, at index x + 1 so the spill off both edges has
+    // somewhere to go. `current` is for this row and `next` for the one below. A pixel's entry in
+    // `current` is free once read, so Atkinson's error for two rows down goes there.
+    int errors[2][W + 3] = {};
+    int* current = errors[0];
+    int* next = errors[1];
+    for (int y = 0; y < H; ++y) {
+        lumaRow(&canvas.canvas[static_cast<size_t>(y) * W], W, levels);
+        uint8_t* bits = out + y * row_bytes;
+        memset(bits, 0, static_cast<size_t>(row_bytes));
+        for (int x = 0; x < W; ++x) {
+            const int value = levels[x] + current[x + 1];
+            current[x + 1] = 0;
+            const bool lit = value > 127;
+            if (lit) bits[x / 8] |= static_cast<uint8_t>(0x80 >> (x & 7));
+            const int error = value - (lit ? 255 : 0);
+            if (method == JaDitherMethod::FLOYD_STEINBERG) {
+                // 7/16 right, 3/16 below left, 5/16 below, and what rounding left below right.
+                const int right = (error * 7) >> 4;
+                const int below_left = (error * 3) >> 4;
+                const int below = (error * 5) >> 4;
+                current[x + 2] += right;
+                next[x] += below_left;
+                next[x + 1] += below;
+                next[x + 2] += error - right - below_left - below;
+            } else {
+                // 1/8 to each of two pixels right, three below and one two rows down.
+                const int part = error >> 3;
+                current[x + 2] += part;
+                current[x + 3] += part;
+                next[x] += part;
+                next[x + 1] += part;
+                next[x + 2] += part;
+                current[x + 1] += part;
+            }
+        }
+        current[0] = current[W + 1] = current[W + 2] = 0; // What spilled off the edges
+        std::swap(current, next);
+    }
+}
+
+/**
+ * @brief Draws a 1-bit image from ditherToMono() onto the canvas, e.g. to preview a monochrome
+ * display on a color screen.
+ */
+template <int W, int H>
+void expandMono(const uint8_t* bits, JaDraw<W, H>& canvas, uint32_t on_color = Colors::White,
+                uint32_t off_color = Colors::Black) {
+    const int row_bytes = monoRowBytes(W);
+    for (int y = 0; y < H; ++y) {
+        const uint8_t* row = bits + y * row_bytes;
+        uint32_t* pixels = &canvas.canvas[static_cast<size_t>(y) * W];
+        for (int x = 0; x < W; ++x) {
+            pixels[x] = (row[x / 8] & (0x80 >> (x & 7))) ? on_color : off_color;
+        }
+    }
+}
+
+} // namespace JaDither
+
+#endif // JADITHER_H
@@ -9,6 +9,7 @@
 #include <cassert>
 #include <limits>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 enum class BlendMode {
@@ -17,6 +18,12 @@ enum class BlendMode {
     ADDITIVE  // Add source RGB (scaled by `intensity`) to destination RGB, clamp result. Destination alpha remains unchanged.
 };
 
+enum class JaPointShape : uint8_t {
+    SQUARE, // 2 * radius pixels wide, at least one
+    ROUND,  // The pixels whose centers are within the radius
+    SOFT    // Round with an antialiased edge
+};
+
 #define JADRAW_RED(color)   (((color) >> 24) & 0xFFU)
 #define JADRAW_GREEN(color) (((color) >> 16)  & 0xFFU)
 #define JADRAW_BLUE(color)  (((color) >> 8) & 0xFFU)
@@ -292,6 +299,15 @@ namespace VectorFont {
     }
 } // VectorFont
 
+/**
+ * @brief How a JaSprite's `pixels` span stores its palette indices.
+ */
+enum class JaSpriteEncoding : uint8_t {
+    RAW,    // One palette index per byte, row-major.
+    PACKED, // `bits_per_pixel` (1, 2 or 4) indices per byte, MSB first. Each row starts on a new byte.
+    RLE     // Per row, (run length, palette index) byte pairs. Runs never cross a row boundary.
+};
+
 /**
  * @brief Structure holding non-owning views (spans) to paletted sprite data.
  * Designed to work with statically allocated sprite data. Requires C++20.
@@ -300,7 +316,9 @@ struct JaSprite {
     int width = 0;
     int height = 0;
     std::span<const uint32_t> palette; // Non-owning view of palette colors
-    std::span<const uint8_t> pixels;   // Non-owning view of pixel indices
+    std::span<const uint8_t> pixels;   // Non-owning view of pixel indices (layout depends on `encoding`)
+    JaSpriteEncoding encoding = JaSpriteEncoding::RAW;
+    uint8_t bits_per_pixel = 8;        // Only meaningful for PACKED
 
     // Default constructor creates an invalid sprite
     constexpr JaSprite() = default;
@@ -347,12 +365,106 @@ struct JaSprite {
         // }
     }
 
+    /**
+     * @brief Constructs a JaSprite view over packed or run-length encoded pixel data.
+     * @param w Sprite width.
+     * @param h Sprite height.
+     * @param p A span viewing the palette data.
+     * @param data A span viewing the encoded pixel data.
+     * @param enc How `data` is laid out.
+     * @param bpp Bits per pixel for PACKED data (1, 2 or 4). Ignored otherwise.
+     */
+    constexpr JaSprite(int w, int h, std::span<const uint32_t> p, std::span<const uint8_t> data, JaSpriteEncoding enc, uint8_t bpp = 8)
+        : width(w), height(h), palette(p), pixels(data), encoding(enc),
+          bits_per_pixel(enc == JaSpriteEncoding::PACKED ? bpp : 8)
+    {
+    }
+
+    /**
+     * @brief Bytes per row of PACKED data.
+     */
+    constexpr size_t packedStride() const {
+        return (static_cast<size_t>(width) * bits_per_pixel + 7) / 8;
+    }
+
     /**
      * @brief Gets the palette index at sprite coordinates (x, y). Assumes valid coordinates.
+     * RLE sprites have to walk their runs from the start, so prefer decodeRow() for those.
      */
     constexpr uint8_t getPixelIndexUnsafe(int x, int y) const {
         // No bounds check here for speed - JaDraw::drawSprite performs clipping
-        return pixels[static_cast<size_t>(y) * width + x];
+        switch (encoding) {
+            case JaSpriteEncoding::PACKED: {
+                size_t bit = static_cast<size_t>(x) * bits_per_pixel;
+                uint8_t byte = pixels[static_cast<size_t>(y) * packedStride() + bit / 8];
+                int shift = 8 - bits_per_pixel - static_cast<int>(bit % 8);
+                return (byte >> shift) & ((1u << bits_per_pixel) - 1);
+            }
+            case JaSpriteEncoding::RLE: {
+                uint8_t index = 0;
+                decodeRow(y, x, 1, &index);
+                return index;
+            }
+            default:
+                return pixels[static_cast<size_t>(y) * width + x];
+        }
+    }
+
+    /**
+     * @brief Decodes `count` palette indices of row `y`, starting at column `x0`, into `out`.
+     * Assumes the requested range lies inside the sprite.
+     */
+    constexpr void decodeRow(int y, int x0, int count, uint8_t* out) const {
+        switch (encoding) {
+            case JaSpriteEncoding::PACKED: {
+                const uint8_t mask = static_cast<uint8_t>((1u << bits_per_pixel) - 1);
+                const size_t row = static_cast<size_t>(y) * packedStride();
+                size_t bit = static_cast<size_t>(x0) * bits_per_pixel;
+                for (int i = 0; i < count; ++i, bit += bits_per_pixel) {
+                    int shift = 8 - bits_per_pixel - static_cast<int>(bit % 8);
+                    out[i] = (pixels[row + bit / 8] >> shift) & mask;
+                }
+                break;
+            }
+            case JaSpriteEncoding::RLE: {
+                size_t pos = rleRowStart(y);
+                decodeRleRow(pos, x0, count, out);
+                break;
+            }
+            default:
+                for (int i = 0; i < count; ++i) {
+                    out[i] = pixels[static_cast<size_t>(y) * width + x0 + i];
+                }
+                break;
+        }
+    }
+
+    /**
+     * @brief Byte offset of row `y` in RLE data. Every row's runs add up to exactly `width` pixels.
+     */
+    constexpr size_t rleRowStart(int y) const {
+        size_t pos = 0;
+        for (int row = 0; row < y; ++row) {
+            for (int covered = 0; covered < width; pos += 2) {
+                covered += pixels[pos];
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Decodes part of the RLE row starting at byte offset `pos`, then advances `pos` to the next row.
+     */
+    constexpr void decodeRleRow(size_t& pos, int x0, int count, uint8_t* out) const {
+        const int x1 = x0 + count;
+        for (int x = 0; x < width; pos += 2) {
+            int run_end = x + pixels[pos];
+            uint8_t index = pixels[pos + 1];
+            for (int px = std::max(x, x0); px < std::min(run_end, x1); ++px) {
+                out[px - x0] = index;
+            }
+            x = run_end;
+        }
     }
 
      /**
@@ -369,7 +481,7 @@ struct JaSprite {
             return 0; 
             //throw std::out_of_range("Sprite pixel coordinates out of bounds.");
         }
-        return pixels[static_cast<size_t>(y) * width + x];
+        return getPixelIndexUnsafe(x, y);
      }
      uint32_t getColorFromIndex(uint8_t index) const {
          if (index >= palette.size()) {
@@ -380,6 +492,109 @@ struct JaSprite {
      }
 };
 
+/**
+ * @brief A triangle corner for JaDraw::rasterizeTriangle().
+ * @tparam N Number of attributes (brightness, texture coordinates, ...) interpolated across the triangle.
+ * @tparam T float, or int32_t for Q16.16 fixed point, whose positions go straight into the
+ *           rasterizer's 1/16-pixel grid without passing through float.
+ */
+template <int N = 0, typename T = float>
+struct JaRasterVertex {
+    T x, y;        // Screen position in pixels; pixel (x, y) covers [x, x + 1) x [y, y + 1).
+    T depth = T(); // 1/w scaled into [0, 1], larger is closer. Used by JaDepthBuffer and rasterizeTrianglePerspective().
+    std::array<T, N> attributes{};
+};
+
+/**
+ * @brief A horizontal run of covered pixels, handed to the shader of JaDraw::rasterizeTriangle().
+ */
+template <int N = 0>
+struct JaRasterSpan {
+    int y;
+    int x_begin;                     // First covered pixel
+    int x_end;                       // One past the last covered pixel
+    uint32_t* pixels;                // Canvas row y; write pixels[x] for x in [x_begin, x_end)
+    std::array<float, N> attributes; // Interpolated attributes at the center of pixel x_begin
+    std::array<float, N> step;       // Change in attributes per pixel to the right
+};
+
+/**
+ * @brief Per-pixel depth for JaDraw::rasterizeTriangle(), so triangles can be drawn in any order.
+ *
+ * Stores quantized inverse depth (see JaRasterVertex::depth): 0 is infinitely far and larger
+ * values are closer. Inverse depth is linear in screen space, so it can be interpolated exactly
+ * across a triangle. Each 8x8 tile also keeps the range of values it holds, letting the
+ * rasterizer skip blocks that are hidden without testing their pixels.
+ */
+template <int W, int H, typename T = uint16_t>
+class JaDepthBuffer {
+    static_assert(std::is_unsigned_v<T>, "Depth values must be an unsigned integer type");
+
+public:
+    static constexpr int TILE_SIZE = 8;
+    static constexpr int TILES_X = (W + TILE_SIZE - 1) / TILE_SIZE;
+    static constexpr int TILES_Y = (H + TILE_SIZE - 1) / TILE_SIZE;
+
+    std::array<T, static_cast<std::size_t>(W) * H> depth;
+    std::array<T, TILES_X * TILES_Y> tile_min; // Farthest value in each tile
+    std::array<T, TILES_X * TILES_Y> tile_max; // Closest value in each tile
+
+    JaDepthBuffer() { clear(); }
+
+    /**
+     * @brief Resets every pixel to infinitely far. Call once per frame before drawing.
+     */
+    void clear() {
+        depth.fill(0);
+        tile_min.fill(0);
+        tile_max.fill(0);
+    }
+
+    /**
+     * @brief Converts a depth in [0, 1] (larger is closer) to a stored value.
+     */
+    static T quantize(float d) {
+        if (!(d > 0.0f)) return 0;
+        if (d >= 1.0f) return std::numeric_limits<T>::max();
+        return static_cast<T>(d * std::numeric_limits<T>::max() + 0.5f);
+    }
+
+    // The rasterizer steps depth across a triangle as a fixed-point stored value, value << PLANE_SHIFT,
+    // so testing a pixel takes no float math. Up to 16-bit depths, that and twice its range fit in
+    // an int32_t.
+    using Plane = std::conditional_t<(sizeof(T) <= 2), int32_t, int64_t>;
+    static constexpr int PLANE_SHIFT = sizeof(T) <= 2 ? 28 - 8 * static_cast<int>(sizeof(T)) : 0;
+    static constexpr Plane PLANE_ONE = static_cast<Plane>(std::numeric_limits<T>::max()) << PLANE_SHIFT; // Depth 1
+    static constexpr Plane PLANE_ROUND = PLANE_SHIFT > 0 ? Plane{1} << (PLANE_SHIFT - 1) : 0;
+
+    /**
+     * @brief quantize() for a depth in plane units, with PLANE_ROUND already added.
+     */
+    static T fromPlane(Plane z) {
+        if (z <= 0) return 0;
+        if (z >= PLANE_ONE) return std::numeric_limits<T>::max();
+        return static_cast<T>(z >> PLANE_SHIFT);
+    }
+
+    /**
+     * @brief Recomputes the min/max of tile (tile_x, tile_y) after its pixels changed.
+     */
+    void updateTile(int tile_x, int tile_y) {
+        const int x_end = std::min(W, (tile_x + 1) * TILE_SIZE);
+        const int y_end = std::min(H, (tile_y + 1) * TILE_SIZE);
+        T lo = std::numeric_limits<T>::max(), hi = 0;
+        for (int y = tile_y * TILE_SIZE; y < y_end; ++y) {
+            const T* row = &depth[static_cast<std::size_t>(y) * W];
+            for (int x = tile_x * TILE_SIZE; x < x_end; ++x) {
+                lo = std::min(lo, row[x]);
+                hi = std::max(hi, row[x]);
+            }
+        }
+        tile_min[tile_y * TILES_X + tile_x] = lo;
+        tile_max[tile_y * TILES_X + tile_x] = hi;
+    }
+};
+
 template <int W, int H>
 class JaDraw {
     static_assert(W > 0, "Need positive width");
@@ -459,6 +674,21 @@ private:
     }
 
 
+    // Covers x_begin to x_end of row y (already clipped), storing the color directly when
+    // blending would give it anyway.
+    inline void fillSpanUnsafe(int y, int x_begin, int x_end, uint32_t color, BlendMode mode) {
+        if (x_begin >= x_end) return;
+        uint32_t* row = &canvas[static_cast<std::size_t>(y) * W];
+        if (mode == BlendMode::OPAQUE || (mode == BlendMode::BLEND && JADRAW_ALPHA(color) == 0xFF)) {
+            std::fill(row + x_begin, row + x_end, color | 0xFFU);
+            return;
+        }
+        for (int x = x_begin; x < x_end; ++x) {
+            plotPixelUnsafeWithIntensityMode(x, y, color, 1.0f, mode);
+        }
+    }
+
+
 public:
     static constexpr int width = W;
     static constexpr int height = H;
@@ -536,6 +766,93 @@ public:
         }
     }
 
+    /**
+     * @brief Draws a batch of single pixels in one color, e.g. projected particles. Points off the
+     * canvas are skipped.
+     * @param xs X coordinates.
+     * @param ys Y coordinates, as many as `xs`.
+     * @param intensities Per point color scale (0-1), or empty for full intensity.
+     * @param color Point color (RGBA).
+     * @param mode Drawing mode (defaults to ADDITIVE, so overlapping points add up).
+     */
+    void drawPoints(std::span<const int> xs, std::span<const int> ys, std::span<const float> intensities,
+                    uint32_t color, BlendMode mode = BlendMode::ADDITIVE) {
+        const size_t count = std::min(xs.size(), ys.size());
+        for (size_t i = 0; i < count; ++i) {
+            const int x = xs[i];
+            const int y = ys[i];
+            // One unsigned compare per axis covers both ends.
+            if (static_cast<unsigned>(x) < static_cast<unsigned>(W) && static_cast<unsigned>(y) < static_cast<unsigned>(H)) {
+                plotPixelUnsafeWithIntensityMode(x, y, color, i < intensities.size() ? intensities[i] : 1.0f, mode);
+            }
+        }
+    }
+
+    /**
+     * @brief Fills a rectangle, clipped to the canvas, one row span at a time.
+     * @param x Left edge.
+     * @param y Top edge.
+     * @param w Width in pixels.
+     * @param h Height in pixels.
+     * @param color Fill color (RGBA).
+     * @param mode Drawing mode (OPAQUE, BLEND, ADDITIVE).
+     */
+    void fillRect(int x, int y, int w, int h, uint32_t color, BlendMode mode = BlendMode::BLEND) {
+        const int x_begin = std::max(x, 0);
+        const int x_end = std::min(x + w, W);
+        const int y_end = std::min(y + h, H);
+        for (int row = std::max(y, 0); row < y_end; ++row) {
+            fillSpanUnsafe(row, x_begin, x_end, color, mode);
+        }
+    }
+
+    /**
+     * @brief Draws a dot of any size centered on (x, y), where pixel (px, py) spans px to px + 1,
+     * e.g. a projected point sprite. Dots under a pixel across are drawn as one-pixel squares
+     * whatever their shape, so they never vanish.
+     * @param radius Radius in pixels.
+     * @param color Dot color (RGBA).
+     * @param shape Square, round, or round with an antialiased edge.
+     * @param mode Drawing mode (OPAQUE, BLEND, ADDITIVE).
+     */
+    void drawPointSprite(float x, float y, float radius, uint32_t color, JaPointShape shape = JaPointShape::SQUARE,
+                         BlendMode mode = BlendMode::BLEND) {
+        if (shape == JaPointShape::SQUARE || !(radius >= 0.5f)) {
+            const int size = std::max(1, static_cast<int>(radius * 2.0f));
+            fillRect(ipart(x) - size / 2, ipart(y) - size / 2, size, size, color, mode);
+            return;
+        }
+        // SOFT fades out from radius - 0.5 to radius + 0.5, by the distance to each pixel's center.
+        const float outer = shape == JaPointShape::SOFT ? radius + 0.5f : radius;
+        const float inner = shape == JaPointShape::SOFT ? radius - 0.5f : radius;
+        const int y_begin = std::max(0, ipart(y - outer));
+        const int y_end = std::min(H, ipart(y + outer) + 1);
+        for (int py = y_begin; py < y_end; ++py) {
+            const float dy = py + 0.5f - y;
+            const float outer_sq = outer * outer - dy * dy;
+            if (outer_sq < 0.0f) continue;
+            // The pixels whose centers are within half_width of x.
+            auto centers_within = [&](float half_width, int& begin, int& end) {
+                begin = std::max(0, static_cast<int>(std::ceil(x - half_width - 0.5f)));
+                end = std::min(W, static_cast<int>(std::floor(x + half_width - 0.5f)) + 1);
+            };
+            int outer_begin, outer_end;
+            centers_within(std::sqrt(outer_sq), outer_begin, outer_end);
+            const float inner_sq = inner * inner - dy * dy;
+            int inner_begin = outer_end, inner_end = outer_end;
+            if (inner_sq >= 0.0f) {
+                centers_within(std::sqrt(inner_sq), inner_begin, inner_end);
+                fillSpanUnsafe(py, inner_begin, inner_end, color, mode);
+            }
+            for (int px = outer_begin; px < outer_end; ++px) {
+                if (px == inner_begin && inner_begin < inner_end) px = inner_end;
+                if (px >= outer_end) break;
+                const float dx = px + 0.5f - x;
+                plotPixelUnsafeWithIntensityMode(px, py, color, radius + 0.5f - std::sqrt(dx * dx + dy * dy), mode);
+            }
+        }
+    }
+
 
     /**
      * @brief Draws an integer-based line with thickness and specified mode (defaults to BLEND).
@@ -765,6 +1082,23 @@ public:
      * @param mode Drawing mode for non-transparent pixels.
      */
     void drawSprite(int dest_x, int dest_y, const JaSprite& sprite, BlendMode mode = BlendMode::BLEND) {
+        drawSpriteRegion(dest_x, dest_y, sprite, 0, 0, sprite.width, sprite.height, mode);
+    }
+
+    /**
+     * @brief Draws a rectangular part of a paletted sprite (e.g. one tile of an atlas) using spans.
+     * Pixels referencing palette entries with alpha 0 are skipped (transparent).
+     * @param dest_x Top-left X coordinate on the canvas.
+     * @param dest_y Top-left Y coordinate on the canvas.
+     * @param sprite The sprite to take pixels from.
+     * @param src_x Left edge of the region within the sprite.
+     * @param src_y Top edge of the region within the sprite.
+     * @param src_w Region width. Clamped to the sprite.
+     * @param src_h Region height. Clamped to the sprite.
+     * @param mode Drawing mode for non-transparent pixels.
+     */
+    void drawSpriteRegion(int dest_x, int dest_y, const JaSprite& sprite, int src_x, int src_y, int src_w, int src_h,
+                          BlendMode mode = BlendMode::BLEND) {
         // Basic check if sprite has valid dimensions and data spans
         if (sprite.width <= 0 || sprite.height <= 0 || sprite.pixels.empty() || sprite.palette.empty()) {
             return; // Nothing to draw
@@ -772,37 +1106,66 @@ public:
         // Optional runtime check (if not done reliably in constructor)
         // assert(static_cast<size_t>(sprite.width) * sprite.height == sprite.pixels.size());
 
+        // Keep the region inside the sprite, shifting the destination along with it.
+        if (src_x < 0) { dest_x -= src_x; src_w += src_x; src_x = 0; }
+        if (src_y < 0) { dest_y -= src_y; src_h += src_y; src_y = 0; }
+        src_w = std::min(src_w, sprite.width - src_x);
+        src_h = std::min(src_h, sprite.height - src_y);
+
         int clip_x1 = std::max(0, dest_x);
         int clip_y1 = std::max(0, dest_y);
-        int clip_x2 = std::min(W, dest_x + sprite.width);
-        int clip_y2 = std::min(H, dest_y + sprite.height);
+        int clip_x2 = std::min(W, dest_x + src_w);
+        int clip_y2 = std::min(H, dest_y + src_h);
 
         if (clip_x1 >= clip_x2 || clip_y1 >= clip_y2) {
             return; // Fully clipped
         }
 
+        // Sprite coordinates of the first visible pixel
+        const int sx1 = src_x + (clip_x1 - dest_x);
+        const int sy1 = src_y + (clip_y1 - dest_y);
+        const int span_w = clip_x2 - clip_x1;
+        // A fully opaque source pixel blended at full intensity just replaces the destination,
+        // so those can be stored directly unless we're adding.
+        const bool store_opaque = (mode != BlendMode::ADDITIVE);
+
+        // PACKED and RLE rows are decoded into this buffer first; RAW rows are read in place.
+        std::array<uint8_t, W> row_buffer;
+        size_t rle_pos = (sprite.encoding == JaSpriteEncoding::RLE) ? sprite.rleRowStart(sy1) : 0;
         for (int cy = clip_y1; cy < clip_y2; ++cy) {
-            int sy = cy - dest_y;
-            // Use the span directly now
+            int sy = sy1 + (cy - clip_y1);
             // Note: Accessing span with [] is usually unchecked in release builds.
             // The clipping ensures cx/cy are valid canvas coords.
             // sx/sy calculation ensures they map to valid sprite coords *within the clipped view*.
-            size_t sprite_row_start_index = static_cast<size_t>(sy) * sprite.width;
+            const uint8_t* row_indices;
+            if (sprite.encoding == JaSpriteEncoding::RAW) {
+                row_indices = sprite.pixels.data() + static_cast<size_t>(sy) * sprite.width + sx1;
+            } else if (sprite.encoding == JaSpriteEncoding::RLE) {
+                sprite.decodeRleRow(rle_pos, sx1, span_w, row_buffer.data());
+                row_indices = row_buffer.data();
+            } else {
+                sprite.decodeRow(sy, sx1, span_w, row_buffer.data());
+                row_indices = row_buffer.data();
+            }
 
+            uint32_t* dest_row = &canvas[static_cast<size_t>(cy) * W];
             for (int cx = clip_x1; cx < clip_x2; ++cx) {
-                int sx = cx - dest_x;
-
-                // Get palette index from pixel span (unsafe access is okay due to clipping/structure logic)
-                uint8_t palette_index = sprite.pixels[sprite_row_start_index + sx]; // Using span::operator[]
+                // Get palette index for this pixel (unsafe access is okay due to clipping/structure logic)
+                uint8_t palette_index = row_indices[cx - clip_x1];
 
                 // Get color from palette span (unsafe access assumes index is valid)
                 // We rely on the constructor check or trusted input data.
                 uint32_t source_color = sprite.palette[palette_index]; // Using span::operator[]
 
                 // Universal Transparency Check (based on palette color's alpha)
-                if (JADRAW_ALPHA(source_color) == 0) {
+                uint32_t alpha = JADRAW_ALPHA(source_color);
+                if (alpha == 0) {
                     continue; // Skip transparent pixels
                 }
+                if (alpha == 0xFF && store_opaque) {
+                    dest_row[cx] = source_color;
+                    continue;
+                }
 
                 // Plot using the existing unsafe plotter (cx, cy are canvas-bounds checked by clipping)
                 plotPixelUnsafeWithIntensityMode(cx, cy, source_color, 1.0f, mode);
@@ -1080,6 +1443,325 @@ public:
             */
         }
     }
+    /**
+     * @brief Fills a triangle, calling `shader` for every run of covered pixels.
+     *
+     * The shader is any callable taking a `const JaRasterSpan<N>&`. It decides what ends up in
+     * the pixels, so flat, dithered, Gouraud or textured fills all share this rasterizer and the
+     * compiler builds a specialised inner loop for each one.
+     *
+     * Pixels are covered when their center is inside the triangle. Pixels exactly on an edge go
+     * to the triangle on its top or left side only, so meshes never draw a shared edge twice.
+     * Positions are handled with 1/16 pixel precision and must be within about +-1000 pixels.
+     * Both windings are drawn; do any culling before calling this.
+     *
+     * Fixed-point vertices (T = int32_t) only skip float for the edges; attributes and depth
+     * still reach the shader as float.
+     *
+     * @tparam N Number of attributes per vertex, interpolated linearly in screen space.
+     */
+    template <int N, typename T, typename Shader>
+    void rasterizeTriangle(const JaRasterVertex<N, T>& v0, const JaRasterVertex<N, T>& v1, const JaRasterVertex<N, T>& v2,
+                           Shader&& shader)
+    {
+        rasterizeTriangleImpl<N, T, void, false>(v0, v1, v2, nullptr, shader);
+    }
+
+    /**
+     * @brief Same as above, but only covers pixels where the triangle is closer than what
+     * `depth_buffer` holds (using each vertex's `depth`), and records the new depth there.
+     * Blocks that are entirely behind what's already drawn are skipped.
+     */
+    template <int N, typename T, typename D, typename Shader>
+    void rasterizeTriangle(const JaRasterVertex<N, T>& v0, const JaRasterVertex<N, T>& v1, const JaRasterVertex<N, T>& v2,
+                           JaDepthBuffer<W, H, D>& depth_buffer, Shader&& shader)
+    {
+        rasterizeTriangleImpl<N, T, JaDepthBuffer<W, H, D>, false>(v0, v1, v2, &depth_buffer, shader);
+    }
+
+    /**
+     * @brief Like rasterizeTriangle(), but attributes are interpolated perspective-correctly,
+     * which textures need so they don't bend. Each vertex's `depth` is used as its 1/w.
+     *
+     * Spans reach the shader in pieces of at most PERSPECTIVE_STEP pixels: attributes are exact
+     * at the ends of each piece and linear in between, so there is one division per piece
+     * instead of one per pixel, and shaders are the same as for rasterizeTriangle().
+     */
+    template <int N, typename T, typename Shader>
+    void rasterizeTrianglePerspective(const JaRasterVertex<N, T>& v0, const JaRasterVertex<N, T>& v1,
+                                      const JaRasterVertex<N, T>& v2, Shader&& shader)
+    {
+        rasterizeTriangleImpl<N, T, void, true>(v0, v1, v2, nullptr, shader);
+    }
+
+    template <int N, typename T, typename D, typename Shader>
+    void rasterizeTrianglePerspective(const JaRasterVertex<N, T>& v0, const JaRasterVertex<N, T>& v1,
+                                      const JaRasterVertex<N, T>& v2, JaDepthBuffer<W, H, D>& depth_buffer, Shader&& shader)
+    {
+        rasterizeTriangleImpl<N, T, JaDepthBuffer<W, H, D>, true>(v0, v1, v2, &depth_buffer, shader);
+    }
+
+    static constexpr int PERSPECTIVE_STEP = 16;
+
+private:
+    // DepthBuffer is void when there's no depth test.
+    template <int N, typename T, typename DepthBuffer, bool PERSPECTIVE, typename Shader>
+    void rasterizeTriangleImpl(const JaRasterVertex<N, T>& v0, const JaRasterVertex<N, T>& v1, const JaRasterVertex<N, T>& v2,
+                               DepthBuffer* depth_buffer, Shader& shader)
+    {
+        // Half-space rasterizer working on 8x8 blocks. Coordinates are 28.4 fixed point.
+        constexpr int SUBPIXEL_BITS = 4;
+        constexpr int SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+        constexpr int BLOCK_SIZE = 8;
+        constexpr bool DEPTH_TEST = !std::is_void_v<DepthBuffer>;
+        constexpr bool FIXED = std::is_integral_v<T>;
+        static_assert(FIXED ? std::is_same_v<T, int32_t> : std::is_same_v<T, float>, "Vertices are float or Q16.16 int32_t");
+        constexpr int FIXED_TO_SUBPIXEL = 16 - SUBPIXEL_BITS;
+
+        const JaRasterVertex<N, T>* p[3] = {&v0, &v1, &v2};
+        int32_t vx[3], vy[3];
+        for (int i = 0; i < 3; ++i) {
+            if constexpr (FIXED) {
+                vx[i] = (p[i]->x + (1 << (FIXED_TO_SUBPIXEL - 1))) >> FIXED_TO_SUBPIXEL;
+                vy[i] = (p[i]->y + (1 << (FIXED_TO_SUBPIXEL - 1))) >> FIXED_TO_SUBPIXEL;
+            } else {
+                vx[i] = static_cast<int32_t>(std::lround(p[i]->x * SUBPIXEL_ONE));
+                vy[i] = static_cast<int32_t>(std::lround(p[i]->y * SUBPIXEL_ONE));
+            }
+        }
+
+        // Make the winding consistent so that "inside" is always the positive side of every edge.
+        int32_t area = (vx[1] - vx[0]) * (vy[2] - vy[0]) - (vy[1] - vy[0]) * (vx[2] - vx[0]);
+        if (area == 0) return;
+        if (area < 0) {
+            std::swap(p[1], p[2]);
+            std::swap(vx[1], vx[2]);
+            std::swap(vy[1], vy[2]);
+            area = -area;
+        }
+
+        // Bounding box in pixels, clipped to the canvas.
+        const int min_x = std::max(0, std::min({vx[0], vx[1], vx[2]}) >> SUBPIXEL_BITS);
+        const int min_y = std::max(0, std::min({vy[0], vy[1], vy[2]}) >> SUBPIXEL_BITS);
+        const int max_x = std::min(W - 1, (std::max({vx[0], vx[1], vx[2]}) + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS);
+        const int max_y = std::min(H - 1, (std::max({vy[0], vy[1], vy[2]}) + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS);
+        if (min_x > max_x || min_y > max_y) return;
+
+        // Edge equations E(x, y) = a * x + b * y + c for the edge from vertex i to vertex i + 1,
+        // evaluated at the center of pixel (min_x, min_y). Edges that aren't top or left edges get
+        // a bias of -1, so pixels exactly on them are left to the neighbouring triangle.
+        const int32_t center_x = (min_x << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+        const int32_t center_y = (min_y << SUBPIXEL_BITS) + SUBPIXEL_ONE / 2;
+        int32_t origin[3], step_x[3], step_y[3];
+        for (int e = 0; e < 3; ++e) {
+            const int next = (e + 1) % 3;
+            int32_t a = vy[e] - vy[next];
+            int32_t b = vx[next] - vx[e];
+            bool top_left = (a > 0) || (a == 0 && b > 0);
+            origin[e] = a * (center_x - vx[e]) + b * (center_y - vy[e]) - (top_left ? 0 : 1);
+            step_x[e] = a * SUBPIXEL_ONE;
+            step_y[e] = b * SUBPIXEL_ONE;
+        }
+
+        // Attribute planes: value at the first pixel center plus gradients along x and y.
+        // With a depth test, depth is interpolated the same way as one extra attribute.
+        // For perspective correction, the planes hold attribute * depth (i.e. attribute / w),
+        // which is linear in screen space, and depth is needed to divide it back out.
+        constexpr int PLANES = N + ((DEPTH_TEST || PERSPECTIVE) ? 1 : 0);
+        std::array<float, PLANES> plane_origin{}, plane_dx{}, plane_dy{};
+        if constexpr (PLANES > 0) {
+            const float inv_area = static_cast<float>(SUBPIXEL_ONE * SUBPIXEL_ONE) / static_cast<float>(area);
+            const float e1x = static_cast<float>(vx[1] - vx[0]) / SUBPIXEL_ONE, e1y = static_cast<float>(vy[1] - vy[0]) / SUBPIXEL_ONE;
+            const float e2x = static_cast<float>(vx[2] - vx[0]) / SUBPIXEL_ONE, e2y = static_cast<float>(vy[2] - vy[0]) / SUBPIXEL_ONE;
+            const float ox = static_cast<float>(center_x - vx[0]) / SUBPIXEL_ONE;
+            const float oy = static_cast<float>(center_y - vy[0]) / SUBPIXEL_ONE;
+            for (int i = 0; i < PLANES; ++i) {
+                auto to_float = [](T t) {
+                    if constexpr (FIXED) return static_cast<float>(t) * (1.0f / 65536.0f);
+                    else return t;
+                };
+                auto value = [&](int v) {
+                    const float depth = to_float(p[v]->depth);
+                    if (i == N) return depth;
+                    return PERSPECTIVE ? to_float(p[v]->attributes[i]) * depth : to_float(p[v]->attributes[i]);
+                };
+                float d1 = value(1) - value(0);
+                float d2 = value(2) - value(0);
+                plane_dx[i] = (d1 * e2y - d2 * e1y) * inv_area;
+                plane_dy[i] = (d2 * e1x - d1 * e2x) * inv_area;
+                plane_origin[i] = value(0) + plane_dx[i] * ox + plane_dy[i] * oy;
+            }
+        }
+        auto plane_at = [&](int i, int x, int y) {
+            return plane_origin[i] + plane_dx[i] * (x - min_x) + plane_dy[i] * (y - min_y);
+        };
+
+        // The depth plane again, in the depth buffer's fixed point (see JaDepthBuffer::Plane). Kept
+        // in int64_t here, as it may be evaluated well outside the triangle, and clamped to the
+        // buffer's Plane type where pixels are tested.
+        int64_t depth_origin = 0, depth_dx = 0, depth_dy = 0, depth_limit = 0;
+        if constexpr (DEPTH_TEST) {
+            // Far beyond any real gradient, but small enough that depth_at() can't overflow.
+            constexpr float LIMIT = static_cast<float>(std::numeric_limits<int64_t>::max() / (2 * (W + H) + 4));
+            const float one = static_cast<float>(DepthBuffer::PLANE_ONE);
+            auto to_fixed = [&](float v) { return static_cast<int64_t>(std::clamp(v * one, -LIMIT, LIMIT)); };
+            depth_origin = to_fixed(plane_origin[N]) + DepthBuffer::PLANE_ROUND;
+            depth_dx = to_fixed(plane_dx[N]);
+            depth_dy = to_fixed(plane_dy[N]);
+            depth_limit = 2 * static_cast<int64_t>(DepthBuffer::PLANE_ONE);
+        }
+        auto depth_at = [&](int x, int y) {
+            const int64_t z = depth_origin + depth_dx * (x - min_x) + depth_dy * (y - min_y);
+            return std::clamp(z, -depth_limit, depth_limit);
+        };
+
+        JaRasterSpan<N> span;
+        for (int i = 0; i < N; ++i) span.step[i] = plane_dx[i];
+        auto emit = [&](int y, int x_begin, int x_end) {
+            span.y = y;
+            span.pixels = &canvas[static_cast<size_t>(y) * W];
+            if constexpr (!PERSPECTIVE) {
+                span.x_begin = x_begin;
+                span.x_end = x_end;
+                for (int i = 0; i < N; ++i) {
+                    span.attributes[i] = plane_at(i, x_begin, y);
+                }
+                shader(static_cast<const JaRasterSpan<N>&>(span));
+            } else {
+                // Exact attributes at pixel x, reusing the end of one piece as the start of the next.
+                auto exact_at = [&](int x, std::array<float, N>& out) {
+                    const float w = 1.0f / plane_at(N, x, y);
+                    for (int i = 0; i < N; ++i) out[i] = plane_at(i, x, y) * w;
+                };
+                std::array<float, N> next_attributes{};
+                exact_at(x_begin, span.attributes);
+                for (int x = x_begin; x < x_end;) {
+                    const int next = std::min(x + PERSPECTIVE_STEP, x_end - 1);
+                    const int piece_end = (next == x_end - 1) ? x_end : next;
+                    if (next > x) {
+                        exact_at(next, next_attributes);
+                        const float inv_length = 1.0f / (next - x);
+                        for (int i = 0; i < N; ++i) span.step[i] = (next_attributes[i] - span.attributes[i]) * inv_length;
+                    }
+                    span.x_begin = x;
+                    span.x_end = piece_end;
+                    shader(static_cast<const JaRasterSpan<N>&>(span));
+                    span.attributes = next_attributes;
+                    x = piece_end;
+                }
+            }
+        };
+
+        // Hands a covered run to the shader. With a depth test, the run is first cut down to the
+        // pixels that pass, which get their depth written. Returns true if anything was drawn.
+        // `depth_known_pass` skips the per-pixel test when the whole block is known to be in front.
+        auto emit_run = [&](int y, int x_begin, int x_end, bool depth_known_pass) {
+            if constexpr (!DEPTH_TEST) {
+                emit(y, x_begin, x_end);
+                return true;
+            } else {
+                using Plane = typename DepthBuffer::Plane;
+                auto* row = &depth_buffer->depth[static_cast<size_t>(y) * W];
+                // Covered pixels lie between the corners' depths, so stepping stays in range. A
+                // steeper step than depth_limit only happens in runs of one pixel.
+                Plane z = static_cast<Plane>(depth_at(x_begin, y));
+                const Plane dz = static_cast<Plane>(std::clamp(depth_dx, -depth_limit, depth_limit));
+                bool drawn = false;
+                int pass_begin = -1;
+                for (int x = x_begin; x < x_end; ++x, z += dz) {
+                    auto q = DepthBuffer::fromPlane(z);
+                    if (depth_known_pass || q > row[x]) {
+                        row[x] = q;
+                        if (pass_begin < 0) pass_begin = x;
+                    } else if (pass_begin >= 0) {
+                        emit(y, pass_begin, x);
+                        pass_begin = -1;
+                        drawn = true;
+                    }
+                }
+                if (pass_begin >= 0) {
+                    emit(y, pass_begin, x_end);
+                    drawn = true;
+                }
+                return drawn;
+            }
+        };
+
+        // Blocks sit on the canvas-wide 8x8 grid so they line up with the depth buffer's tiles.
+        for (int block_y = min_y & ~(BLOCK_SIZE - 1); block_y <= max_y; block_y += BLOCK_SIZE) {
+            const int y0 = std::max(block_y, min_y);
+            const int y1 = std::min(block_y + BLOCK_SIZE - 1, max_y);
+            for (int block_x = min_x & ~(BLOCK_SIZE - 1); block_x <= max_x; block_x += BLOCK_SIZE) {
+                const int x0 = std::max(block_x, min_x);
+                const int x1 = std::min(block_x + BLOCK_SIZE - 1, max_x);
+                const int w = x1 - x0, h = y1 - y0;
+
+                // Edge values at the corner pixels of the part of the block inside the bounding box.
+                // Edges are linear, so a block whose corners are all inside every edge is fully
+                // covered, and one whose corners are all outside a single edge is empty.
+                int32_t corner[3];
+                bool all_inside = true, all_outside = false;
+                for (int e = 0; e < 3; ++e) {
+                    corner[e] = origin[e] + (x0 - min_x) * step_x[e] + (y0 - min_y) * step_y[e];
+                    int32_t c10 = corner[e] + w * step_x[e];
+                    int32_t c01 = corner[e] + h * step_y[e];
+                    int32_t c11 = c10 + h * step_y[e];
+                    int inside = (corner[e] >= 0) + (c10 >= 0) + (c01 >= 0) + (c11 >= 0);
+                    all_inside = all_inside && inside == 4;
+                    all_outside = all_outside || inside == 0;
+                }
+                if (all_outside) continue;
+
+                // Depth is linear too, so the corners bound the triangle's depth over the block.
+                // Compare that against the tile's stored range (with one step of slack for rounding).
+                bool depth_known_pass = false;
+                if constexpr (DEPTH_TEST) {
+                    static_assert(DepthBuffer::TILE_SIZE == BLOCK_SIZE, "Depth tiles must match raster blocks");
+                    const int tile = (block_y / BLOCK_SIZE) * DepthBuffer::TILES_X + block_x / BLOCK_SIZE;
+                    using Plane = typename DepthBuffer::Plane;
+                    const int64_t z00 = depth_at(x0, y0), z10 = depth_at(x1, y0);
+                    const int64_t z01 = depth_at(x0, y1), z11 = depth_at(x1, y1);
+                    auto q_near = DepthBuffer::fromPlane(static_cast<Plane>(std::max({z00, z10, z01, z11})));
+                    auto q_far = DepthBuffer::fromPlane(static_cast<Plane>(std::min({z00, z10, z01, z11})));
+                    if (q_near < depth_buffer->tile_min[tile]) continue; // Hidden behind everything in the tile
+                    depth_known_pass = all_inside && q_far > 1 && q_far - 1 > depth_buffer->tile_max[tile];
+                }
+
+                bool drawn = false;
+                if (all_inside) {
+                    for (int y = y0; y <= y1; ++y) {
+                        drawn |= emit_run(y, x0, x1 + 1, depth_known_pass);
+                    }
+                } else {
+                    // Partially covered: step the edge values per pixel. A triangle is convex, so
+                    // the covered pixels of each row form a single run.
+                    for (int y = y0; y <= y1; ++y) {
+                        int32_t e0 = corner[0], e1 = corner[1], e2 = corner[2];
+                        int run_begin = -1, run_end = -1;
+                        for (int x = x0; x <= x1; ++x) {
+                            if ((e0 | e1 | e2) >= 0) {
+                                if (run_begin < 0) run_begin = x;
+                                run_end = x + 1;
+                            }
+                            e0 += step_x[0];
+                            e1 += step_x[1];
+                            e2 += step_x[2];
+                        }
+                        if (run_begin >= 0) {
+                            drawn |= emit_run(y, run_begin, run_end, false);
+                        }
+                        corner[0] += step_y[0];
+                        corner[1] += step_y[1];
+                        corner[2] += step_y[2];
+                    }
+                }
+                if constexpr (DEPTH_TEST) {
+                    if (drawn) depth_buffer->updateTile(block_x / BLOCK_SIZE, block_y / BLOCK_SIZE);
+                }
+                (void)drawn;
+            }
+        }
+    }
 }; // JaDraw<W, H>
 
 
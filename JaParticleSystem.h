@@ -0,0 +1,160 @@
+#ifndef JAPARTICLESYSTEM_H
+#define JAPARTICLESYSTEM_H
+
+#include "JaDraw.h"
+#include "math_3d.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Many single-pixel points moving in 3D: stars, sparks, debris.
+ *
+ * Particles are stored as structure-of-arrays (all x's, then all y's, ...) so that update() and
+ * draw() go through math_3d.h's SIMD backend several particles at a time. The capacity is fixed
+ * when the system is made, so emitting never allocates. Dead particles are replaced by the last
+ * live one, which keeps the live ones packed at the front.
+ *
+ * Each particle has a position, a velocity (units per second) and a lifetime in seconds, which
+ * can be HUGE_VALF for particles that never die. They fade out over their last `fade_time`
+ * seconds and are drawn in one color, added to the canvas by default.
+ */
+class JaParticleSystem {
+public:
+    explicit JaParticleSystem(size_t capacity)
+        : xs(capacity), ys(capacity), zs(capacity), vxs(capacity), vys(capacity), vzs(capacity),
+          lives(capacity), screen_x(capacity), screen_y(capacity), intensities(capacity),
+          visible(new bool[capacity]) {}
+
+    size_t size() const { return count; }
+    size_t capacity() const { return xs.size(); }
+    bool isEmpty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    void setColor(uint32_t c, BlendMode mode = BlendMode::ADDITIVE) {
+        color = c;
+        blend_mode = mode;
+    }
+
+    void setFadeTime(float seconds) { fade_time = seconds; }
+
+    /**
+     * @brief Makes particles leaving the box from `min` to `max` come back in on the other side, on
+     * the axes where min < max (e.g. only z for a starfield flying past).
+     */
+    void setWrap(Vec3f min, Vec3f max) {
+        wrap_min = min;
+        wrap_max = max;
+    }
+
+    /**
+     * @brief Adds a particle.
+     * @return false if the system is full.
+     */
+    bool emit(Vec3f position, Vec3f velocity, float lifetime) {
+        if (count >= capacity() || !(lifetime > 0.0f)) return false;
+        xs[count] = position.x;
+        ys[count] = position.y;
+        zs[count] = position.z;
+        vxs[count] = velocity.x;
+        vys[count] = velocity.y;
+        vzs[count] = velocity.z;
+        lives[count] = lifetime;
+        ++count;
+        return true;
+    }
+
+    /**
+     * @brief Moves every particle by `dt` seconds, wraps them and removes the ones that died.
+     */
+    void update(float dt) {
+        integrate(xs.data(), vxs.data(), dt, wrap_min.x, wrap_max.x);
+        integrate(ys.data(), vys.data(), dt, wrap_min.y, wrap_max.y);
+        integrate(zs.data(), vzs.data(), dt, wrap_min.z, wrap_max.z);
+        integrate(lives.data(), NULL, -dt, 0.0f, 0.0f);
+
+        for (size_t i = 0; i < count;) {
+            if (lives[i] > 0.0f) {
+                ++i;
+                continue;
+            }
+            --count;
+            xs[i] = xs[count];
+            ys[i] = ys[count];
+            zs[i] = zs[count];
+            vxs[i] = vxs[count];
+            vys[i] = vys[count];
+            vzs[i] = vzs[count];
+            lives[i] = lives[count];
+        }
+    }
+
+    /**
+     * @brief Projects the particles with `vp_matrix` (see project_points()) and draws them as
+     * pixels. No depth test: draw them after whatever they should cover.
+     */
+    template <int W, int H>
+    void draw(JaDraw<W, H>& canvas, const Mat4f* vp_matrix) {
+        if (count == 0) return;
+        project_points(vp_matrix, xs.data(), ys.data(), zs.data(), static_cast<int>(count), W, H,
+                       screen_x.data(), screen_y.data(), visible.get());
+        const float fade_scale = fade_time > 0.0f ? 1.0f / fade_time : HUGE_VALF;
+        for (size_t i = 0; i < count; ++i) {
+            if (!visible[i]) screen_x[i] = -1; // Behind the camera; drawPoints() skips it
+            intensities[i] = lives[i] * fade_scale; // Clamped to 1 when plotted
+        }
+        canvas.drawPoints(std::span<const int>(screen_x.data(), count), std::span<const int>(screen_y.data(), count),
+                          std::span<const float>(intensities.data(), count), color, blend_mode);
+    }
+
+private:
+    // values[i] += rates[i] * dt (or just dt without rates), wrapped into low..high if that isn't empty.
+    void integrate(float* values, const float* rates, float dt, float low, float high) {
+        const bool wrap = low < high;
+        const float range = high - low;
+        size_t i = 0;
+#if MATH_3D_SIMD_LANES
+        const m3d_float step = m3d_set1(dt);
+        const m3d_float lo = m3d_set1(low);
+        const m3d_float hi = m3d_set1(high);
+        const m3d_float range_v = m3d_set1(range);
+        for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+            m3d_float v = m3d_load(values + i);
+            v = m3d_add(v, rates ? m3d_mul(m3d_load(rates + i), step) : step);
+            if (wrap) {
+                // Add or subtract the range in the lanes that left it, without branching.
+                v = m3d_add(v, m3d_and(m3d_lt(v, lo), range_v));
+                v = m3d_sub(v, m3d_and(m3d_lt(hi, v), range_v));
+            }
+            m3d_store(values + i, v);
+        }
+#endif
+        for (; i < count; ++i) {
+            float v = values[i] + (rates ? rates[i] * dt : dt);
+            if (wrap) {
+                if (v < low) v += range;
+                if (high < v) v -= range;
+            }
+            values[i] = v;
+        }
+    }
+
+    std::vector<float> xs, ys, zs;
+    std::vector<float> vxs, vys, vzs;
+    std::vector<float> lives; // Seconds left
+    // Scratch for draw()
+    std::vector<int> screen_x, screen_y;
+    std::vector<float> intensities;
+    std::unique_ptr<bool[]> visible;
+    size_t count = 0;
+
+    uint32_t color = Colors::White;
+    BlendMode blend_mode = BlendMode::ADDITIVE;
+    float fade_time = 0.0f;
+    Vec3f wrap_min = {0.0f, 0.0f, 0.0f};
+    Vec3f wrap_max = {0.0f, 0.0f, 0.0f};
+};
+
+#endif // JAPARTICLESYSTEM_H
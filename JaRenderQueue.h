@@ -0,0 +1,97 @@
+#ifndef JARENDERQUEUE_H
+#define JARENDERQUEUE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A list of things to draw (usually triangles), sorted by a 16-bit depth key.
+ *
+ * Meant to be kept alive across frames: clear() keeps the allocated memory, so once the queue
+ * has grown to its working size, filling and sorting it doesn't allocate. Sorting is an LSB
+ * radix sort on the key (two 8-bit passes over indices), so it's linear in the number of items
+ * and items with equal keys keep their submission order.
+ */
+template <typename Item>
+class JaRenderQueue {
+public:
+    /**
+     * @brief Maps a depth in [min_depth, max_depth] to a sort key, clamping values outside it.
+     */
+    static uint16_t depthKey(float depth, float min_depth, float max_depth) {
+        float t = (depth - min_depth) / (max_depth - min_depth);
+        if (!(t > 0.0f)) return 0;
+        if (t >= 1.0f) return UINT16_MAX;
+        return static_cast<uint16_t>(t * UINT16_MAX + 0.5f);
+    }
+
+    /**
+     * @brief Empties the queue without giving back its memory.
+     */
+    void clear() {
+        items.clear();
+        keys.clear();
+        order.clear();
+    }
+
+    void reserve(size_t count) {
+        items.reserve(count);
+        keys.reserve(count);
+        order.reserve(count);
+        scratch.reserve(count);
+    }
+
+    void push(const Item& item, uint16_t key) {
+        order.push_back(static_cast<uint32_t>(items.size()));
+        items.push_back(item);
+        keys.push_back(key);
+    }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    /**
+     * @brief Sorts by key, ascending, or descending if `descending` (e.g. far-to-near for painter's order).
+     * Either way, items with equal keys stay in submission order. Afterwards operator[] walks the
+     * items in sorted order.
+     */
+    void sort(bool descending = false) {
+        const size_t n = order.size();
+        scratch.resize(n);
+        // Descending is ascending on the complemented keys, which keeps the sort stable.
+        const uint16_t flip = descending ? 0xFFFF : 0;
+        radixPass(order.data(), scratch.data(), n, 0, flip);
+        radixPass(scratch.data(), order.data(), n, 8, flip);
+    }
+
+    /**
+     * @brief The i-th item in sorted order (or submission order before sort() is called).
+     */
+    const Item& operator[](size_t i) const { return items[order[i]]; }
+
+private:
+    // Stable counting sort of `in` by one byte of the key (xor `flip`) into `out`.
+    void radixPass(const uint32_t* in, uint32_t* out, size_t n, int shift, uint16_t flip) {
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < n; ++i) {
+            ++offsets[((keys[in[i]] ^ flip) >> shift) & 0xFF];
+        }
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            size_t count = offset;
+            offset = total;
+            total += count;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            out[offsets[((keys[in[i]] ^ flip) >> shift) & 0xFF]++] = in[i];
+        }
+    }
+
+    std::vector<Item> items;
+    std::vector<uint16_t> keys;
+    std::vector<uint32_t> order;   // indices into items, in sorted order
+    std::vector<uint32_t> scratch; // ping-pong buffer for the radix passes
+};
+
+#endif // JARENDERQUEUE_H
@@ -0,0 +1,167 @@
+#ifndef JASPRITEANIMATION_H
+#define JASPRITEANIMATION_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Changed-pixel runs that turn one animation frame into the next.
+ *
+ * `runs` is a sequence of records: a 16-bit little-endian pixel offset (y * width + x), an 8-bit
+ * run length, then that many palette indices. A run never crosses a row boundary, so each one is
+ * a single horizontal span. `tools/jasprite_convert --anim` generates these.
+ */
+struct JaSpriteFrameDelta {
+    std::span<const uint8_t> runs;
+};
+
+/**
+ * @brief A sprite animation stored as one keyframe plus per-frame deltas.
+ *
+ * `deltas[i]` turns frame i into frame i + 1, and the last one turns the final frame back into
+ * the keyframe, so there are as many deltas as frames. The current frame lives in a RAM buffer
+ * (width * height bytes); only the keyframe and the changed runs need to be kept in flash.
+ */
+class JaSpriteAnimation {
+public:
+    /**
+     * @param keyframe First frame. Any JaSpriteEncoding works; it is decoded once into the frame buffer.
+     * @param deltas One delta per frame, see JaSpriteFrameDelta.
+     * @param frame_duration Seconds each frame stays on screen.
+     * @param loop If false, the animation stops on its last frame.
+     */
+    JaSpriteAnimation(const JaSprite& keyframe, std::span<const JaSpriteFrameDelta> deltas, float frame_duration, bool loop = true)
+        : keyframe(keyframe), deltas(deltas), frame_duration(frame_duration), looping(loop),
+          frame_pixels(static_cast<size_t>(keyframe.width) * keyframe.height),
+          dirty_x0(keyframe.height), dirty_x1(keyframe.height)
+    {
+        reset();
+    }
+
+    /**
+     * @brief Rewinds to the keyframe. The next drawChanges() redraws the whole sprite.
+     */
+    void reset() {
+        for (int y = 0; y < keyframe.height; ++y) {
+            keyframe.decodeRow(y, 0, keyframe.width, &frame_pixels[static_cast<size_t>(y) * keyframe.width]);
+        }
+        frame = 0;
+        elapsed = 0.0f;
+        invalidate();
+    }
+
+    /**
+     * @brief Marks the whole sprite as changed, e.g. after the layer it sits on was cleared or it moved.
+     */
+    void invalidate() {
+        std::fill(dirty_x0.begin(), dirty_x0.end(), static_cast<int16_t>(0));
+        std::fill(dirty_x1.begin(), dirty_x1.end(), static_cast<int16_t>(keyframe.width));
+    }
+
+    /**
+     * @brief Moves the animation forward by `dt` seconds, applying one delta per frame passed.
+     * Meant to be called with the `dt` from IApplet::loop().
+     * @return true if the visible frame changed.
+     */
+    bool advance(float dt) {
+        if (deltas.empty() || frame_duration <= 0.0f) return false;
+        elapsed += dt;
+        bool changed = false;
+        while (elapsed >= frame_duration) {
+            if (!looping && frame + 1 >= static_cast<int>(deltas.size())) {
+                elapsed = 0.0f;
+                break;
+            }
+            elapsed -= frame_duration;
+            applyDelta(deltas[frame]);
+            frame = (frame + 1) % static_cast<int>(deltas.size());
+            changed = true;
+        }
+        return changed;
+    }
+
+    int currentFrame() const { return frame; }
+    int frameCount() const { return deltas.empty() ? 1 : static_cast<int>(deltas.size()); }
+
+    /**
+     * @brief A RAW view of the current frame, usable with JaDraw::drawSprite().
+     */
+    JaSprite sprite() const {
+        return JaSprite(keyframe.width, keyframe.height, keyframe.palette, std::span<const uint8_t>(frame_pixels), false);
+    }
+
+    /**
+     * @brief Draws the whole current frame.
+     */
+    template <int W, int H>
+    void draw(JaDraw<W, H>& canvas, int dest_x, int dest_y, BlendMode mode = BlendMode::BLEND) const {
+        canvas.drawSprite(dest_x, dest_y, sprite(), mode);
+    }
+
+    /**
+     * @brief Redraws only the pixels that changed since the last call, for a layer that is not
+     * cleared between frames. Changed pixels replace what is underneath; transparent ones are
+     * filled with `background`. Call invalidate() if the sprite moves or the layer is cleared.
+     */
+    template <int W, int H>
+    void drawChanges(JaDraw<W, H>& canvas, int dest_x, int dest_y, uint32_t background) {
+        const int y_start = std::max(0, -dest_y);
+        const int y_end = std::min(keyframe.height, H - dest_y);
+        for (int sy = y_start; sy < y_end; ++sy) {
+            int x0 = std::max<int>(dirty_x0[sy], -dest_x);
+            int x1 = std::min<int>(dirty_x1[sy], W - dest_x);
+            if (x0 >= x1) continue;
+            const uint8_t* row = &frame_pixels[static_cast<size_t>(sy) * keyframe.width];
+            // Canvas pixel of sprite column x0, which clipping keeps on the canvas.
+            uint32_t* out = &canvas.canvas[static_cast<size_t>(dest_y + sy) * W + (dest_x + x0)];
+            for (int sx = x0; sx < x1; ++sx, ++out) {
+                uint32_t color = keyframe.palette[row[sx]];
+                uint32_t alpha = JADRAW_ALPHA(color);
+                if (alpha == 0xFF) {
+                    *out = color;
+                } else {
+                    *out = background;
+                    if (alpha != 0) canvas.drawPixel(dest_x + sx, dest_y + sy, color);
+                }
+            }
+        }
+        std::fill(dirty_x0.begin(), dirty_x0.end(), static_cast<int16_t>(keyframe.width));
+        std::fill(dirty_x1.begin(), dirty_x1.end(), static_cast<int16_t>(0));
+    }
+
+private:
+    void applyDelta(const JaSpriteFrameDelta& delta) {
+        const std::span<const uint8_t> runs = delta.runs;
+        size_t pos = 0;
+        while (pos + 3 <= runs.size()) {
+            size_t offset = runs[pos] | (static_cast<size_t>(runs[pos + 1]) << 8);
+            size_t length = runs[pos + 2];
+            pos += 3;
+            if (pos + length > runs.size() || offset + length > frame_pixels.size()) break; // malformed data
+            std::copy(runs.begin() + pos, runs.begin() + pos + length, frame_pixels.begin() + offset);
+            pos += length;
+
+            // Grow this row's dirty span to cover the run.
+            int y = static_cast<int>(offset / keyframe.width);
+            int x = static_cast<int>(offset % keyframe.width);
+            dirty_x0[y] = static_cast<int16_t>(std::min<int>(dirty_x0[y], x));
+            dirty_x1[y] = static_cast<int16_t>(std::max<int>(dirty_x1[y], x + static_cast<int>(length)));
+        }
+    }
+
+    JaSprite keyframe;
+    std::span<const JaSpriteFrameDelta> deltas;
+    float frame_duration;
+    bool looping;
+    int frame = 0;
+    float elapsed = 0.0f;
+    std::vector<uint8_t> frame_pixels;   // current frame, RAW layout
+    std::vector<int16_t> dirty_x0;       // per row: changed columns [x0, x1) not yet drawn
+    std::vector<int16_t> dirty_x1;
+};
+
+#endif // JASPRITEANIMATION_H
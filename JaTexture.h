@@ -0,0 +1,157 @@
+#ifndef JATEXTURE_H
+#define JATEXTURE_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <span>
+#include <vector>
+
+/**
+ * @brief What texture coordinates outside the texture map to.
+ */
+enum class JaTextureAddress : uint8_t {
+    WRAP,  // Repeat the texture
+    CLAMP  // Repeat the edge texels
+};
+
+/**
+ * @brief A sprite prepared for sampling at arbitrary texel positions, e.g. by textured triangles.
+ *
+ * Texels stay palette indices. RAW sprites are used in place; other encodings can't be read at
+ * random positions cheaply, so they are decoded ("baked") into a RAW copy once here. Power-of-two
+ * sizes wrap with a mask instead of a modulo.
+ */
+class JaTexture {
+public:
+    JaTexture() = default;
+
+    explicit JaTexture(const JaSprite& sprite, JaTextureAddress address_u = JaTextureAddress::WRAP,
+                       JaTextureAddress address_v = JaTextureAddress::WRAP)
+        : palette(sprite.palette), address_u(address_u), address_v(address_v)
+    {
+        if (sprite.width <= 0 || sprite.height <= 0 || sprite.pixels.empty() || sprite.palette.empty()) {
+            return;
+        }
+        if (sprite.encoding == JaSpriteEncoding::RAW) {
+            if (sprite.pixels.size() < static_cast<size_t>(sprite.width) * sprite.height) return;
+            indices = sprite.pixels;
+        } else {
+            baked.resize(static_cast<size_t>(sprite.width) * sprite.height);
+            size_t rle_pos = 0;
+            for (int y = 0; y < sprite.height; ++y) {
+                uint8_t* row = &baked[static_cast<size_t>(y) * sprite.width];
+                if (sprite.encoding == JaSpriteEncoding::RLE) {
+                    sprite.decodeRleRow(rle_pos, 0, sprite.width, row);
+                } else {
+                    sprite.decodeRow(y, 0, sprite.width, row);
+                }
+            }
+            indices = baked;
+        }
+        width = sprite.width;
+        height = sprite.height;
+        mask_u = (width & (width - 1)) == 0 ? width - 1 : -1;
+        mask_v = (height & (height - 1)) == 0 ? height - 1 : -1;
+    }
+
+    // Copies must point at their own baked data.
+    JaTexture(const JaTexture& other) { *this = other; }
+    JaTexture& operator=(const JaTexture& other) {
+        if (this != &other) {
+            baked = other.baked;
+            indices = other.baked.empty() ? other.indices : std::span<const uint8_t>(baked);
+            palette = other.palette;
+            width = other.width;
+            height = other.height;
+            mask_u = other.mask_u;
+            mask_v = other.mask_v;
+            address_u = other.address_u;
+            address_v = other.address_v;
+        }
+        return *this;
+    }
+
+    bool isEmpty() const { return width == 0; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    void setAddress(JaTextureAddress u, JaTextureAddress v) {
+        address_u = u;
+        address_v = v;
+    }
+
+    /**
+     * @brief Color of texel (x, y), with the addressing modes applied to coordinates outside the texture.
+     * Indices outside the palette give transparent black.
+     */
+    uint32_t texel(int x, int y) const {
+        if (isEmpty()) return 0;
+        uint8_t index = indices[static_cast<size_t>(addressV(y)) * width + addressU(x)];
+        return index < palette.size() ? palette[index] : 0;
+    }
+
+    /**
+     * @brief Samples the texture across a span from JaDraw::rasterizeTriangle() or
+     * rasterizeTrianglePerspective(), calling `fn(x, color)` for each pixel.
+     *
+     * The texture coordinates are the span's attributes `u_attribute` and `u_attribute + 1`,
+     * in texels (so 0..width covers the texture once). Nearest-texel sampling, stepped in 16.16
+     * fixed point, so each pixel costs two adds and a lookup.
+     */
+    template <int N, typename Fn>
+    void forEachTexel(const JaRasterSpan<N>& span, int u_attribute, Fn&& fn) const {
+        static_assert(N >= 2, "Textured spans need u and v attributes");
+        if (isEmpty()) return;
+        int32_t u = toFixed(span.attributes[u_attribute]);
+        int32_t v = toFixed(span.attributes[u_attribute + 1]);
+        const int32_t du = toFixed(span.step[u_attribute]);
+        const int32_t dv = toFixed(span.step[u_attribute + 1]);
+        for (int x = span.x_begin; x < span.x_end; ++x, u += du, v += dv) {
+            const uint8_t index = indices[static_cast<size_t>(addressV(v >> 16)) * width + addressU(u >> 16)];
+            fn(x, index < palette.size() ? palette[index] : 0u);
+        }
+    }
+
+    /**
+     * @brief Span shader body that copies texels to the canvas, skipping fully transparent ones.
+     */
+    template <int N>
+    void drawSpan(const JaRasterSpan<N>& span, int u_attribute = 0) const {
+        forEachTexel(span, u_attribute, [&](int x, uint32_t color) {
+            if (JADRAW_ALPHA(color) != 0) span.pixels[x] = color;
+        });
+    }
+
+private:
+    static int32_t toFixed(float f) {
+        // Keep far-off coordinates from overflowing; they only matter modulo the texture size.
+        const float limit = 32767.0f;
+        f = std::fmax(-limit, std::fmin(limit, f));
+        return static_cast<int32_t>(std::floor(f * 65536.0f));
+    }
+
+    int addressU(int x) const { return address(x, width, mask_u, address_u); }
+    int addressV(int y) const { return address(y, height, mask_v, address_v); }
+
+    static int address(int c, int size, int mask, JaTextureAddress mode) {
+        if (c >= 0 && c < size) return c;
+        if (mode == JaTextureAddress::CLAMP) return c < 0 ? 0 : size - 1;
+        if (mask >= 0) return c & mask;
+        int r = c % size;
+        return r < 0 ? r + size : r;
+    }
+
+    std::vector<uint8_t> baked;       // Decoded pixels for non-RAW sprites
+    std::span<const uint8_t> indices; // RAW texels: the sprite's own pixels or `baked`
+    std::span<const uint32_t> palette;
+    int width = 0;
+    int height = 0;
+    int mask_u = -1; // width - 1 for power-of-two widths, else -1
+    int mask_v = -1;
+    JaTextureAddress address_u = JaTextureAddress::WRAP;
+    JaTextureAddress address_v = JaTextureAddress::WRAP;
+};
+
+#endif // JATEXTURE_H
@@ -0,0 +1,151 @@
+#ifndef JATILEMAP_H
+#define JATILEMAP_H
+
+#include "JaDraw.h"
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <span>
+
+/**
+ * @brief A grid of tiles taken from a sprite atlas, drawn as one scrolling layer.
+ *
+ * Tiles are numbered left to right, top to bottom across the atlas. The map stores one tile
+ * number per cell (row-major); EMPTY_TILE leaves the cell see-through. Stack several maps with
+ * different parallax factors to get layered side-scroller backgrounds.
+ */
+class JaTileMap {
+public:
+    static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+    /**
+     * @param atlas Sprite holding the tiles. Any JaSpriteEncoding works, but RAW is fastest.
+     * @param tile_w Width of one tile in pixels.
+     * @param tile_h Height of one tile in pixels.
+     * @param map_w Map width in tiles.
+     * @param map_h Map height in tiles.
+     * @param tiles map_w * map_h tile numbers. Not copied, so it can be edited while the map is in use.
+     */
+    JaTileMap(const JaSprite& atlas, int tile_w, int tile_h, int map_w, int map_h, std::span<const uint16_t> tiles)
+        : atlas(atlas), tile_w(tile_w), tile_h(tile_h), map_w(map_w), map_h(map_h), tiles(tiles),
+          atlas_columns(tile_w > 0 ? atlas.width / tile_w : 0),
+          atlas_tiles(tile_h > 0 ? atlas_columns * (atlas.height / tile_h) : 0)
+    {
+    }
+
+    /**
+     * @brief How far this layer moves per unit of camera movement. 1 scrolls with the camera,
+     * smaller values make a distant background, 0 keeps it fixed.
+     */
+    void setParallax(float factor_x, float factor_y) {
+        parallax_x = factor_x;
+        parallax_y = factor_y;
+    }
+
+    /**
+     * @brief Whether the map repeats outside its bounds instead of leaving them empty.
+     */
+    void setWrap(bool wrap_x, bool wrap_y) {
+        this->wrap_x = wrap_x;
+        this->wrap_y = wrap_y;
+    }
+
+    int widthInPixels() const { return map_w * tile_w; }
+    int heightInPixels() const { return map_h * tile_h; }
+
+    /**
+     * @brief Tile number at map cell (x, y), honouring wrap. Returns EMPTY_TILE outside the map.
+     */
+    uint16_t tileAt(int x, int y) const {
+        if (wrap_x) x = wrapIndex(x, map_w);
+        if (wrap_y) y = wrapIndex(y, map_h);
+        if (x < 0 || y < 0 || x >= map_w || y >= map_h) return EMPTY_TILE;
+        size_t i = static_cast<size_t>(y) * map_w + x;
+        return i < tiles.size() ? tiles[i] : EMPTY_TILE;
+    }
+
+    /**
+     * @brief Draws the part of the map seen by the camera into a viewport on the canvas.
+     * Only the tiles overlapping the viewport are visited, so the cost doesn't depend on map size.
+     * @param camera_x Map pixel shown at the viewport's left edge (before parallax). May be fractional.
+     * @param camera_y Map pixel shown at the viewport's top edge (before parallax).
+     * @param mode Drawing mode for the tile pixels.
+     * @param view_x Viewport left edge on the canvas.
+     * @param view_y Viewport top edge on the canvas.
+     * @param view_w Viewport width. -1 means up to the canvas edge.
+     * @param view_h Viewport height. -1 means up to the canvas edge.
+     */
+    template <int W, int H>
+    void draw(JaDraw<W, H>& canvas, float camera_x, float camera_y, BlendMode mode = BlendMode::BLEND,
+              int view_x = 0, int view_y = 0, int view_w = -1, int view_h = -1) const {
+        if (tile_w <= 0 || tile_h <= 0 || atlas_tiles <= 0) return;
+        if (view_w < 0) view_w = W - view_x;
+        if (view_h < 0) view_h = H - view_y;
+
+        // Clip the viewport to the canvas.
+        int vx1 = std::max(0, view_x);
+        int vy1 = std::max(0, view_y);
+        int vx2 = std::min(W, view_x + view_w);
+        int vy2 = std::min(H, view_y + view_h);
+        if (vx1 >= vx2 || vy1 >= vy2) return;
+
+        // Map pixel at the viewport origin. Flooring keeps sub-pixel camera motion from jittering
+        // between layers.
+        const int scroll_x = static_cast<int>(std::floor(camera_x * parallax_x));
+        const int scroll_y = static_cast<int>(std::floor(camera_y * parallax_y));
+
+        // Range of map cells touching the clipped viewport.
+        const int first_col = floorDiv(scroll_x + (vx1 - view_x), tile_w);
+        const int last_col = floorDiv(scroll_x + (vx2 - 1 - view_x), tile_w);
+        const int first_row = floorDiv(scroll_y + (vy1 - view_y), tile_h);
+        const int last_row = floorDiv(scroll_y + (vy2 - 1 - view_y), tile_h);
+
+        for (int row = first_row; row <= last_row; ++row) {
+            // Canvas rows covered by this tile row, clipped to the viewport.
+            const int tile_top = view_y + row * tile_h - scroll_y;
+            const int y1 = std::max(vy1, tile_top);
+            const int y2 = std::min(vy2, tile_top + tile_h);
+
+            for (int col = first_col; col <= last_col; ++col) {
+                uint16_t tile = tileAt(col, row);
+                if (tile == EMPTY_TILE || tile >= atlas_tiles) continue;
+
+                const int tile_left = view_x + col * tile_w - scroll_x;
+                const int x1 = std::max(vx1, tile_left);
+                const int x2 = std::min(vx2, tile_left + tile_w);
+
+                // Only tiles on the viewport border lose any pixels here.
+                const int src_x = (tile % atlas_columns) * tile_w + (x1 - tile_left);
+                const int src_y = (tile / atlas_columns) * tile_h + (y1 - tile_top);
+                canvas.drawSpriteRegion(x1, y1, atlas, src_x, src_y, x2 - x1, y2 - y1, mode);
+            }
+        }
+    }
+
+private:
+    static int floorDiv(int a, int b) {
+        int q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    static int wrapIndex(int i, int n) {
+        if (n <= 0) return i;
+        int r = i % n;
+        return r < 0 ? r + n : r;
+    }
+
+    JaSprite atlas;
+    int tile_w;
+    int tile_h;
+    int map_w;
+    int map_h;
+    std::span<const uint16_t> tiles;
+    int atlas_columns;
+    int atlas_tiles;
+    float parallax_x = 1.0f;
+    float parallax_y = 1.0f;
+    bool wrap_x = false;
+    bool wrap_y = false;
+};
+
+#endif // JATILEMAP_H
@@ -3,6 +3,11 @@
 #pragma once
 #include "IApplet.h"
 #include "JaDraw.h"
+#include "JaRenderQueue.h"
+#include "JaDither.h"
+#include "math_3d.h"
+#include "mesh_3d.h"
+#include "myapplet_model.h" // The spinning model, quantized by tools/jamesh_convert
 #include "vmath_all.hpp"
 #include <vector>
 #include <limits>
@@ -32,16 +37,6 @@ void MyApplet::setup() { }
 
 const float PI = 3.14159265358f;
 
-// A simple 3D vector/point structure
-struct Vec3 {
-    float x, y, z;
-};
-
-// A 2D vector for projected screen coordinates
-struct Vec2i {
-    int x, y;
-};
-
 // Represents a single triangle to be rendered
 struct RenderTriangle {
     Vec2i p[3];      // 2D projected points
@@ -49,438 +44,30 @@ struct RenderTriangle {
     float brightness; // Brightness level (0.0 to 1.0)
 };
 
-// --- Cube Model Definition (Unit cube centered at origin) ---
-
-const Vec3 CUBE_VERTICES[] = {
-    {0.010339f, -0.061077f, 0.321988f},
-{0.030634f, -0.118241f, -0.284320f},
-{-0.157669f, -0.409149f, 0.197574f},
-{0.104475f, -0.093989f, 0.253589f},
-{0.102440f, 0.281312f, 0.322327f},
-{0.000000f, -0.081642f, 0.313504f},
-{0.000000f, -0.058782f, 0.310238f},
-{-0.329512f, 0.014450f, 0.210762f},
-{-0.104104f, 0.315183f, 0.319152f},
-{-0.002051f, 0.164069f, 0.306324f},
-{-0.038166f, -0.049432f, 0.331222f},
-{0.048231f, -0.072961f, 0.326080f},
-{-0.042552f, -0.120692f, 0.321909f},
-{-0.000730f, -0.351769f, 0.291014f},
-{-0.123473f, 0.161874f, 0.334230f},
-{-0.231196f, 0.109070f, 0.289935f},
-{-0.173056f, 0.036714f, 0.300512f},
-{0.128917f, 0.161575f, 0.338910f},
-{0.093171f, 0.055323f, 0.316271f},
-{0.173275f, 0.028922f, 0.291475f},
-{0.234337f, 0.104445f, 0.283176f},
-{-0.091788f, 0.054809f, 0.315092f},
-{-0.326318f, 0.164228f, 0.225070f},
-{0.371658f, 0.100093f, 0.203606f},
-{-0.144281f, 0.403229f, 0.077034f},
-{-0.352844f, 0.219879f, -0.182010f},
-{-0.104360f, -0.114234f, 0.177619f},
-{0.154379f, -0.411700f, 0.213185f},
-{0.070712f, -0.187195f, 0.123097f},
-{0.123865f, 0.284086f, -0.325201f},
-{0.194626f, 0.376615f, 0.063628f},
-{0.299997f, 0.182766f, 0.151634f},
-{-0.265603f, -0.037652f, -0.146414f},
-{-0.496771f, 0.013253f, -0.186005f},
-{0.382083f, 0.176905f, -0.103227f},
-{0.318316f, 0.002299f, -0.103358f},
-{-0.328479f, 0.004234f, -0.105603f},
-{-0.355811f, 0.151986f, -0.080206f},
-{-0.496120f, 0.181195f, -0.178169f},
-{0.503229f, 0.171405f, -0.185858f},
-{0.496681f, 0.008987f, -0.192762f},
-{0.291129f, -0.025899f, -0.156631f}
-};
-
-
-const int CUBE_TRIANGLES[][3] = {
-{8, 27, 11},
-{5, 10, 18},
-{15, 10, 9},
-{23, 15, 9},
-{24, 5, 21},
-{8, 16, 23},
-{12, 4, 19},
-{19, 22, 12},
-{28, 14, 3},
-{12, 14, 28},
-{14, 13, 3},
-{1, 7, 6},
-{1, 7, 11},
-{7, 12, 22},
-{11, 7, 22},
-{4, 21, 20},
-{16, 8, 17},
-{24, 32, 5},
-{29, 28, 3},
-{29, 3, 27},
-{26, 25, 30},
-{31, 32, 35},
-{23, 25, 26},
-{10, 5, 32},
-{9, 10, 23},
-{26, 38, 23},
-{2, 36, 29},
-{42, 30, 35},
-{26, 2, 33},
-{24, 36, 35},
-{38, 39, 37},
-{8, 38, 37},
-{36, 40, 35},
-{41, 40, 36},
-{39, 34, 37},
-{38, 26, 39},
-{34, 39, 33},
-{4, 12, 28},
-{3, 13, 27},
-{4, 24, 21},
-{23, 16, 15},
-{11, 22, 8},
-{29, 33, 2},
-{22, 10, 15},
-{12, 13, 14},
-{1, 12, 7},
-{11, 12, 1},
-{13, 12, 11},
-{13, 11, 27},
-{19, 4, 20},
-{17, 8, 22},
-{5, 18, 21},
-{19, 10, 22},
-{4, 28, 29},
-{10, 31, 25},
-{30, 42, 2},
-{26, 30, 2},
-{25, 31, 30},
-{30, 31, 35},
-{37, 27, 8},
-{23, 10, 25},
-{24, 35, 32},
-{23, 38, 8},
-{36, 4, 29},
-{35, 41, 42},
-{2, 42, 36},
-{41, 36, 42},
-{33, 37, 34},
-{33, 39, 26},
-{29, 27, 33},
-{19, 18, 10},
-{10, 32, 31},
-{37, 33, 27},
-{36, 24, 4},
-{35, 40, 41}
-};
-
-// --- Dithering Patterns (4x4 Bayer Matrix based) ---
-// We'll have 5 levels of brightness: 0%, 25%, 50%, 75%, 100%
-const int NUM_DITHER_PATTERNS = 5;
-const bool DITHER_PATTERNS[NUM_DITHER_PATTERNS][4][4] = {
-    // 0% (Black)
-    {{0,0,0,0}, {0,0,0,0}, {0,0,0,0}, {0,0,0,0}},
-    // 25% 
-    {{1,0,0,0}, {0,0,0,0}, {0,0,1,0}, {0,0,0,0}},
-    // 50%
-    {{1,0,1,0}, {0,1,0,1}, {1,0,1,0}, {0,1,0,1}},
-    // 75%
-    {{1,1,1,0}, {1,0,1,1}, {1,1,0,1}, {0,1,1,1}},
-    // 100% (White)
-    {{1,1,1,1}, {1,1,1,1}, {1,1,1,1}, {1,1,1,1}}
-};
+// Depth range of the spinning model once it's moved away from the camera, for sort keys.
+const float RENDER_MIN_Z = 0.0f;
+const float RENDER_MAX_Z = 2.0f;
 
-const uint8_t BAYER_MATRIX_8x8[8][8] = {
-    {  0, 32,  8, 40,  2, 34, 10, 42 },
-    { 48, 16, 56, 24, 50, 18, 58, 26 },
-    { 12, 44,  4, 36, 14, 46,  6, 38 },
-    { 60, 28, 52, 20, 62, 30, 54, 22 },
-    {  3, 35, 11, 43,  1, 33,  9, 41 },
-    { 51, 19, 59, 27, 49, 17, 57, 25 },
-    { 15, 47,  7, 39, 13, 45,  5, 37 },
-    { 63, 31, 55, 23, 61, 29, 53, 21 }
-};
+// Reused every frame, so it only allocates until it has grown to fit the model.
+static JaRenderQueue<RenderTriangle> trianglesToRender;
 
-// --- ADD THIS a 64x64 Blue Noise Texture (replaces the Bayer Matrix) ---
-// This tileable texture provides high-quality stochastic dithering.
-// NOTE: This array consumes 4096 bytes of memory.
-const uint8_t BLUE_NOISE_64x64[64][64] = {
-  {0xe5, 0x91, 0xf4, 0x9e, 0xc0, 0xf9, 0x3d, 0xdc, 0xa6, 0x2e, 0x1f, 0xc2, 0xf2, 0x15, 0xcd, 0x27, 0x6e, 0x59, 0x97, 0x7a, 0x20, 0x70, 0x07, 0x7f, 0xa8, 0x3e, 0x99, 0xff, 0x5c, 0xbf, 0x09, 0x6c, 0x30, 0x95, 0x0a, 0xb4, 0x34, 0xfc, 0x97, 0xc7, 0xb1, 0x03, 0x61, 0xe3, 0xa8, 0x59, 0xda, 0x70, 0x3e, 0x5d, 0x7a, 0xa7, 0x2f, 0x86, 0x40, 0x5b, 0x26, 0xcf, 0x00, 0x99, 0x5c, 0xd3, 0x7c, 0xa1, },
-  {0x2d, 0xba, 0x48, 0x08, 0xcd, 0x7c, 0x1c, 0xb3, 0x6d, 0xfe, 0x9c, 0x4b, 0x79, 0x68, 0x91, 0x3e, 0xf1, 0xb1, 0x47, 0xfc, 0xc5, 0xe3, 0x5d, 0x49, 0xda, 0x10, 0xcb, 0x26, 0x36, 0x90, 0xed, 0x41, 0x85, 0x60, 0xe9, 0xd3, 0x82, 0x5c, 0x1c, 0x6a, 0xe8, 0x3b, 0x4c, 0x77, 0x8e, 0x15, 0x48, 0x85, 0xbd, 0xfd, 0x0b, 0xdd, 0x66, 0xf0, 0x9c, 0xf8, 0x7a, 0xbc, 0x6c, 0xfa, 0x2a, 0xaa, 0x49, 0x21, },
-  {0xa2, 0xd4, 0x23, 0x89, 0x68, 0x31, 0x51, 0x8f, 0x0e, 0x5a, 0x86, 0xe3, 0xb5, 0x30, 0xd9, 0x07, 0x82, 0xbe, 0x2e, 0x0d, 0xa1, 0x3a, 0xb2, 0x94, 0xf0, 0x55, 0x68, 0xe2, 0xaf, 0x73, 0xdb, 0x11, 0xc4, 0xac, 0x17, 0x74, 0x3f, 0xbe, 0xdf, 0x27, 0x8d, 0xa3, 0xf9, 0x25, 0xd5, 0xb6, 0xf3, 0x9f, 0x1f, 0xcf, 0x54, 0x45, 0xc5, 0x20, 0x0d, 0xaa, 0x36, 0x19, 0xdc, 0x89, 0x0b, 0xc0, 0xe4, 0x69, },
-  {0x39, 0x77, 0x5d, 0xef, 0xa8, 0xe5, 0xbb, 0xd6, 0xee, 0x39, 0xc9, 0x01, 0x41, 0xa3, 0xf8, 0x62, 0x9c, 0x14, 0xdb, 0x67, 0x52, 0x83, 0x25, 0xc3, 0x19, 0x89, 0xa3, 0x03, 0x4b, 0x1c, 0xa0, 0x57, 0xf2, 0x27, 0x4a, 0x9d, 0xf4, 0x05, 0xad, 0x52, 0x7a, 0xbb, 0x19, 0xc9, 0x6a, 0x30, 0x08, 0x62, 0xaf, 0x2b, 0x98, 0x8a, 0xb4, 0x72, 0x4e, 0xcc, 0x64, 0x45, 0xa2, 0x52, 0x75, 0x39, 0x90, 0x58, },
-  {0x00, 0xb1, 0xdd, 0x14, 0x40, 0x73, 0x27, 0x7f, 0x18, 0xaa, 0x71, 0x25, 0xd5, 0x58, 0x1c, 0xc3, 0x50, 0xe6, 0x76, 0xaa, 0xcf, 0x01, 0xf8, 0x72, 0x35, 0xd3, 0x7b, 0xbe, 0xf7, 0x87, 0x2d, 0xba, 0x7a, 0x92, 0xdf, 0xcb, 0x2f, 0x67, 0x95, 0x43, 0xef, 0x0e, 0x85, 0x55, 0x41, 0x98, 0x80, 0xec, 0x3b, 0x77, 0xe8, 0x15, 0x34, 0xda, 0x83, 0xec, 0x91, 0xe3, 0x2e, 0xc9, 0xf1, 0x1c, 0xd9, 0xb7, },
-  {0x99, 0xc8, 0x4f, 0x90, 0xc2, 0x04, 0xa1, 0x60, 0x46, 0xbf, 0xe8, 0x97, 0x7c, 0xb0, 0x8b, 0x70, 0x34, 0x23, 0x8f, 0x40, 0xea, 0x98, 0xb7, 0x60, 0x45, 0xe9, 0x2b, 0x5d, 0x3e, 0xcd, 0x66, 0xd6, 0x3b, 0x03, 0x6d, 0x58, 0x83, 0x15, 0xd5, 0xc5, 0x34, 0x62, 0xd8, 0xad, 0xf6, 0xbf, 0xe0, 0x4e, 0x0e, 0xd7, 0x6a, 0xa2, 0xfa, 0x5f, 0x27, 0x07, 0xaf, 0x14, 0x7e, 0xb4, 0x60, 0x9a, 0x10, 0x83, },
-  {0x43, 0x1e, 0xf2, 0x2d, 0x5a, 0xfc, 0xd2, 0x94, 0xf4, 0x2e, 0x66, 0x13, 0x4c, 0xed, 0x09, 0xce, 0xfe, 0xb4, 0xc8, 0x5b, 0x1c, 0x30, 0xdf, 0x11, 0xab, 0x91, 0x0b, 0xb1, 0xe7, 0x97, 0x0d, 0x50, 0xfb, 0xb2, 0x1c, 0xea, 0xb9, 0xa5, 0xff, 0x08, 0x72, 0xe5, 0x93, 0x29, 0x02, 0x70, 0x1e, 0xcc, 0x90, 0xb6, 0x58, 0x02, 0xbd, 0x40, 0x9d, 0xc2, 0x55, 0x6d, 0xfc, 0x23, 0x41, 0xab, 0x6d, 0x4d, },
-  {0x60, 0x80, 0xa5, 0x6d, 0xb5, 0x84, 0x3a, 0x0d, 0xca, 0x53, 0x86, 0xb8, 0xd8, 0x2a, 0x3e, 0xa4, 0x4a, 0x81, 0x0c, 0xf4, 0x6e, 0x89, 0x4c, 0x7d, 0xca, 0xfa, 0x53, 0x70, 0x17, 0x7d, 0xa8, 0x23, 0x88, 0x9f, 0xc7, 0x33, 0x46, 0x24, 0x54, 0x8b, 0xb3, 0x20, 0x4a, 0xa6, 0x7d, 0x38, 0x5e, 0xa5, 0x83, 0x43, 0xf3, 0x23, 0xd2, 0x8c, 0x75, 0xf1, 0x3b, 0xd0, 0x96, 0x0c, 0xd6, 0xe7, 0x2f, 0xc1, },
-  {0xd5, 0x36, 0x07, 0xe7, 0x1b, 0x4a, 0xe1, 0x23, 0x75, 0xa7, 0x05, 0xfa, 0x9d, 0x60, 0x78, 0xde, 0x17, 0x63, 0x99, 0x39, 0xbd, 0xa4, 0xd5, 0x21, 0x66, 0x9e, 0x25, 0xda, 0xc6, 0x32, 0xee, 0xdd, 0x43, 0x75, 0x5e, 0x90, 0xd8, 0x6a, 0x7c, 0xa0, 0x3d, 0xc1, 0x5b, 0xee, 0xd1, 0xb9, 0xfe, 0x2b, 0x13, 0xc5, 0x32, 0x7e, 0xac, 0x4b, 0x0f, 0xde, 0x2f, 0x88, 0x49, 0xbd, 0x58, 0x7d, 0x8e, 0x1f, },
-  {0x4d, 0x97, 0xc3, 0x78, 0xce, 0x9e, 0x67, 0xb0, 0x8c, 0xe5, 0x43, 0x35, 0xc2, 0x1e, 0x92, 0xbb, 0xee, 0x2e, 0xac, 0xe2, 0x08, 0x57, 0xed, 0x40, 0x04, 0xbf, 0x38, 0x8d, 0x49, 0xb4, 0x6c, 0x58, 0xbc, 0x0a, 0xf5, 0x13, 0xab, 0xed, 0xcc, 0x17, 0xf8, 0xdb, 0x0c, 0x87, 0x18, 0x51, 0x94, 0xdd, 0x65, 0xe9, 0x9b, 0x6d, 0xe4, 0x19, 0x66, 0xb6, 0xa0, 0x05, 0xec, 0x69, 0xa5, 0xf3, 0x01, 0x63, },
-  {0x18, 0xb3, 0xf7, 0x57, 0x32, 0x11, 0xbe, 0xf1, 0x59, 0x19, 0xd1, 0x6e, 0x80, 0xf2, 0x54, 0x04, 0x6c, 0xd1, 0x50, 0x77, 0xc8, 0x29, 0x95, 0xb5, 0x73, 0xe1, 0x81, 0xf0, 0x61, 0x01, 0x92, 0x1a, 0xcf, 0x2c, 0xe0, 0x82, 0x3a, 0x00, 0x4e, 0x2b, 0x65, 0x76, 0x32, 0x9d, 0x6b, 0x40, 0x05, 0x76, 0xb1, 0x49, 0x08, 0x55, 0xbe, 0x95, 0xfe, 0x21, 0x59, 0x79, 0xca, 0x28, 0x19, 0x38, 0xcf, 0xac, },
-  {0xde, 0x6a, 0x42, 0x25, 0x92, 0xdb, 0x7e, 0x3d, 0x2a, 0x97, 0xb4, 0x4d, 0x0d, 0xab, 0xc9, 0x44, 0x84, 0x20, 0x8e, 0xf8, 0x17, 0x6a, 0x85, 0xfd, 0x14, 0x59, 0xac, 0x10, 0xa0, 0xd6, 0xfe, 0x3c, 0xa6, 0x98, 0x68, 0x53, 0xc3, 0x9b, 0xb8, 0xe4, 0x94, 0xac, 0xce, 0xbc, 0xe2, 0xf2, 0xa9, 0xd4, 0x20, 0x89, 0xf7, 0xd5, 0x2b, 0x3e, 0xcc, 0x84, 0xda, 0xae, 0x40, 0x93, 0xb9, 0x53, 0x9a, 0x47, },
-  {0xa7, 0x0d, 0x81, 0xe8, 0xab, 0x63, 0x4e, 0x01, 0xc4, 0xff, 0x5e, 0xdf, 0x27, 0xe7, 0x32, 0x9b, 0xdb, 0xb7, 0x3c, 0x9f, 0x48, 0xda, 0x36, 0xa5, 0x4b, 0xd2, 0x2c, 0x43, 0xc1, 0x21, 0x73, 0x85, 0xe8, 0x47, 0xb4, 0x1a, 0xf9, 0x70, 0x88, 0x40, 0x09, 0x55, 0x1b, 0x48, 0x25, 0x81, 0x30, 0x59, 0xc1, 0x39, 0xa2, 0x10, 0x75, 0x5f, 0xa8, 0x34, 0x4e, 0x13, 0xe3, 0xfb, 0x74, 0x85, 0xe0, 0xf0, },
-  {0x38, 0x8b, 0xd1, 0xbb, 0x0a, 0xf6, 0x9d, 0xd3, 0x70, 0x84, 0x10, 0xa2, 0x8b, 0x74, 0x64, 0xfc, 0x13, 0x5c, 0xe5, 0x00, 0xad, 0x5e, 0xc4, 0x1e, 0xe8, 0x8a, 0x69, 0xf6, 0x7c, 0x52, 0x30, 0xca, 0x5c, 0x07, 0x7b, 0xce, 0x33, 0x23, 0x5f, 0xd4, 0xf6, 0x7e, 0xec, 0x8f, 0x60, 0xc6, 0x9c, 0x13, 0xe8, 0x64, 0x7e, 0xb8, 0xec, 0x90, 0x01, 0xf5, 0xc2, 0x6f, 0x61, 0x08, 0x31, 0xc4, 0x0c, 0x6d, },
-  {0xc2, 0x20, 0x5a, 0x4a, 0x72, 0x38, 0x21, 0xe5, 0xad, 0x31, 0x46, 0xce, 0xbd, 0x3e, 0x09, 0xa8, 0x7b, 0x2d, 0xc1, 0x72, 0x83, 0xf2, 0x0d, 0x7a, 0x99, 0xcb, 0x08, 0xb4, 0x91, 0xda, 0xae, 0x14, 0xbc, 0x28, 0xf0, 0x8f, 0xa3, 0xe0, 0xae, 0x15, 0xbf, 0x37, 0x6e, 0xb4, 0x07, 0xfc, 0x70, 0x4a, 0x8e, 0xd0, 0x26, 0x42, 0x51, 0xdf, 0x19, 0x7c, 0x9b, 0x25, 0x8c, 0xd5, 0xaa, 0x5c, 0x22, 0x3e, },
-  {0xfe, 0x9c, 0xed, 0x16, 0x90, 0xcb, 0x82, 0x57, 0x14, 0x94, 0x69, 0xf6, 0x1f, 0x58, 0xd6, 0xc5, 0x8e, 0x50, 0xf6, 0x21, 0xd0, 0x2e, 0xb7, 0x53, 0x3e, 0x27, 0x5b, 0xe3, 0x19, 0x3f, 0x66, 0xf8, 0x97, 0x70, 0xd7, 0x55, 0x43, 0x05, 0x77, 0x4b, 0x98, 0x28, 0xa3, 0xd1, 0x17, 0x3d, 0xd9, 0xb7, 0x0a, 0xa6, 0xfb, 0x1b, 0xc7, 0xaf, 0x66, 0x46, 0xb6, 0xf0, 0x3b, 0xa0, 0x49, 0xf5, 0xdc, 0x7b, },
-  {0x67, 0xad, 0x7b, 0xdf, 0x2d, 0xa4, 0xbe, 0x42, 0xef, 0xb8, 0xde, 0x04, 0x7c, 0x98, 0xf1, 0x47, 0x1b, 0xb3, 0x68, 0x9d, 0x43, 0x92, 0x6c, 0xed, 0xa1, 0xbe, 0x72, 0x34, 0xa7, 0xec, 0x03, 0x88, 0x4b, 0x39, 0xab, 0x11, 0x6a, 0xfe, 0xc8, 0x84, 0xe9, 0x64, 0xde, 0x45, 0x58, 0x95, 0x7c, 0xeb, 0x35, 0x55, 0x73, 0x99, 0x84, 0x2a, 0xd3, 0xea, 0x0a, 0x56, 0xc8, 0x1b, 0x81, 0xb6, 0x93, 0x13, },
-  {0x48, 0x01, 0x3f, 0xb5, 0x6a, 0xfb, 0x06, 0x64, 0x79, 0x25, 0x51, 0xa7, 0x36, 0xb5, 0x2a, 0x6e, 0xeb, 0x39, 0xd9, 0x12, 0x59, 0xe4, 0x08, 0xd4, 0x18, 0xfa, 0x86, 0xd0, 0x50, 0x78, 0x9f, 0xcb, 0xe0, 0x20, 0xc0, 0xeb, 0x8c, 0xb6, 0x34, 0x59, 0x0c, 0x1e, 0xc4, 0x88, 0xf6, 0xab, 0x27, 0x1a, 0x69, 0xb0, 0xda, 0x04, 0x5d, 0x3a, 0xa3, 0x8a, 0x31, 0x77, 0xe1, 0x67, 0x02, 0x2e, 0x53, 0xbf, },
-  {0x8c, 0xc5, 0x26, 0xd3, 0x4e, 0x12, 0xe3, 0x8d, 0xd8, 0x3b, 0xc5, 0x87, 0x61, 0xe4, 0x0f, 0x83, 0x95, 0x05, 0xa5, 0xc6, 0x87, 0xb0, 0x36, 0x7e, 0x62, 0x48, 0x05, 0x95, 0x21, 0xbf, 0x2d, 0x5f, 0x0d, 0x80, 0x9c, 0x61, 0x2b, 0x1b, 0xd4, 0x9f, 0xf2, 0xb0, 0x77, 0x30, 0x04, 0x61, 0xc0, 0xcd, 0x8b, 0xf0, 0x45, 0xbb, 0xe3, 0xf9, 0x70, 0x1d, 0xc0, 0x94, 0xac, 0xfe, 0xce, 0x73, 0xed, 0x38, },
-  {0x57, 0xf8, 0x99, 0x85, 0x5d, 0x9e, 0x33, 0xad, 0x1a, 0x99, 0xfd, 0x14, 0xd4, 0x49, 0xa2, 0xca, 0x5e, 0xe1, 0x76, 0x2a, 0xff, 0x4b, 0xc2, 0x23, 0xaa, 0xdd, 0xb5, 0xe8, 0x6b, 0xfd, 0x41, 0xad, 0xee, 0x53, 0xd2, 0x41, 0x79, 0xe5, 0x48, 0x6f, 0x8e, 0x3c, 0x52, 0xe5, 0xa1, 0xdb, 0x3a, 0x4f, 0x9e, 0x2e, 0x16, 0x7c, 0x93, 0x0d, 0x49, 0xcc, 0x60, 0x0f, 0x4e, 0x26, 0x40, 0x8f, 0xd7, 0xab, },
-  {0xa3, 0x35, 0x6d, 0x1c, 0xed, 0xc6, 0x75, 0x49, 0xcd, 0x5a, 0x6d, 0x2f, 0xbc, 0x76, 0xf9, 0x25, 0x51, 0xb9, 0x41, 0x65, 0x1c, 0x9b, 0x71, 0xf4, 0x8d, 0x3d, 0x2f, 0x5a, 0x13, 0x83, 0xd8, 0x1a, 0x72, 0x33, 0xf6, 0x09, 0x93, 0xc3, 0xab, 0x02, 0x26, 0xcc, 0xb9, 0x0f, 0x6b, 0x84, 0xf3, 0x79, 0x08, 0xd5, 0x66, 0xc6, 0x23, 0x58, 0xa8, 0xde, 0xf3, 0x39, 0xb9, 0x83, 0xa6, 0x5e, 0x1c, 0x6c, },
-  {0xe0, 0xbc, 0x06, 0xdb, 0x3d, 0xb8, 0x23, 0xf5, 0x82, 0x00, 0xb2, 0xe6, 0x8f, 0x08, 0x3c, 0xae, 0x18, 0xf3, 0x80, 0xcc, 0xe7, 0x01, 0x56, 0xce, 0x0e, 0x9d, 0x7a, 0xc8, 0xa8, 0x4b, 0x97, 0xb9, 0x8b, 0xc8, 0xa4, 0xb5, 0x17, 0x55, 0xf9, 0x63, 0xd9, 0x7e, 0xfd, 0x96, 0x48, 0x23, 0x13, 0xbd, 0x5e, 0xff, 0xac, 0x37, 0xed, 0xb6, 0x87, 0x2b, 0x7d, 0x9d, 0xd5, 0xeb, 0x07, 0xc5, 0xf7, 0x2b, },
-  {0x12, 0x4c, 0xab, 0x7a, 0x8c, 0x55, 0x0b, 0x66, 0xde, 0xa0, 0x43, 0x21, 0x55, 0x9d, 0x66, 0xd9, 0x8b, 0x34, 0x0f, 0xab, 0x91, 0xbb, 0x2d, 0xeb, 0x69, 0x4f, 0xd7, 0xf3, 0x09, 0x2a, 0xe6, 0x65, 0x00, 0x27, 0x4d, 0x67, 0xe0, 0x86, 0x32, 0x9b, 0x43, 0x15, 0x5c, 0x2e, 0xd5, 0xb5, 0xa8, 0xe6, 0x41, 0x94, 0x83, 0x4d, 0x73, 0xd8, 0x41, 0x09, 0x69, 0x1c, 0x56, 0x6f, 0x16, 0x4b, 0x9b, 0xbb, },
-  {0x83, 0xe9, 0xc5, 0x2d, 0xf8, 0xa5, 0xd5, 0x92, 0x2c, 0xc0, 0x74, 0xf3, 0xcc, 0x80, 0xeb, 0xc2, 0x71, 0x99, 0xd5, 0x48, 0x5d, 0x38, 0x86, 0xa7, 0x15, 0xb8, 0x22, 0x8c, 0x6f, 0xc1, 0x38, 0x56, 0xf9, 0xdc, 0x81, 0x38, 0xcc, 0x21, 0x74, 0xb4, 0xec, 0xc1, 0xa6, 0x73, 0xeb, 0x8d, 0x55, 0x6f, 0x2a, 0x1c, 0xce, 0x00, 0xa2, 0x18, 0x95, 0xfc, 0xc3, 0xaf, 0x31, 0xe3, 0x93, 0x77, 0x36, 0xd9, },
-  {0x9a, 0x59, 0x21, 0x67, 0x47, 0x15, 0xb3, 0x3a, 0xef, 0x51, 0x0d, 0xa9, 0x34, 0x12, 0x46, 0x29, 0x03, 0x55, 0xe4, 0x21, 0x79, 0xfa, 0xda, 0x46, 0x76, 0xe3, 0x3a, 0x5e, 0xa1, 0xd4, 0x7c, 0xb1, 0x1e, 0x9c, 0x71, 0xee, 0xa2, 0x0e, 0xe4, 0x50, 0x09, 0x89, 0x3b, 0x1a, 0xc7, 0x03, 0x35, 0x9c, 0xc2, 0xe2, 0x5b, 0xf3, 0x31, 0xbb, 0x62, 0x4f, 0xdf, 0x8b, 0x44, 0xcb, 0xfb, 0xb5, 0x20, 0xa9, },
-  {0x73, 0x09, 0x90, 0xce, 0xe3, 0x86, 0x71, 0x5d, 0x1c, 0xcf, 0x8b, 0x63, 0xb9, 0xdf, 0x5d, 0xa7, 0xfd, 0xb6, 0x6a, 0xc0, 0xa0, 0x07, 0x64, 0x26, 0xc5, 0x95, 0x03, 0xfe, 0x44, 0x19, 0xf0, 0x92, 0x48, 0xc4, 0x11, 0x42, 0xbd, 0x5c, 0x94, 0xd3, 0x27, 0x69, 0xf6, 0x4f, 0x7f, 0x64, 0xfb, 0xda, 0x0c, 0x7a, 0xb3, 0x8d, 0x6d, 0xe7, 0xca, 0x27, 0x78, 0x04, 0xa3, 0x64, 0x0f, 0x5a, 0x8a, 0xef, },
-  {0xc1, 0xb1, 0xfc, 0xa1, 0x35, 0x02, 0xc8, 0xe7, 0x9c, 0x7b, 0x40, 0xf7, 0x97, 0x1e, 0x89, 0xce, 0x7b, 0x3e, 0x2f, 0xf0, 0x14, 0xcf, 0xb4, 0x89, 0xed, 0x50, 0xad, 0x80, 0xbb, 0x0c, 0x6a, 0x2f, 0xd1, 0x60, 0xad, 0x2b, 0x8b, 0xf2, 0x35, 0x7c, 0xac, 0xdf, 0x9d, 0xcf, 0xaf, 0x22, 0x43, 0x87, 0x4d, 0xa6, 0x3b, 0x22, 0x48, 0x0a, 0x9d, 0x3c, 0xee, 0x1e, 0xbe, 0x80, 0x28, 0x3e, 0xd1, 0x6d, },
-  {0x2a, 0x3e, 0x51, 0x18, 0x78, 0xb9, 0x49, 0x27, 0xab, 0x06, 0xd9, 0x2b, 0x71, 0x51, 0xed, 0x0d, 0x9e, 0x18, 0x91, 0x82, 0x53, 0x41, 0x98, 0x1b, 0x33, 0x6e, 0xcd, 0x2a, 0xde, 0x55, 0xa7, 0xea, 0x85, 0x05, 0xfb, 0xd9, 0x6b, 0x4a, 0x01, 0xc8, 0x5f, 0x44, 0x11, 0x31, 0xe3, 0x95, 0xba, 0xd0, 0x13, 0x68, 0xf9, 0xc6, 0xdc, 0x82, 0xad, 0x5c, 0x91, 0xd1, 0x52, 0xdd, 0xf2, 0x99, 0xbf, 0x47, },
-  {0x11, 0xdd, 0x82, 0x62, 0xd7, 0xf3, 0x90, 0x6b, 0xff, 0xbe, 0x4d, 0x15, 0xc5, 0xad, 0x33, 0x65, 0xdd, 0x4e, 0xca, 0xaf, 0xe9, 0x72, 0xdf, 0x5b, 0xf9, 0x0f, 0x9d, 0x61, 0x8f, 0xc7, 0x78, 0x1c, 0x3e, 0x98, 0x51, 0x7a, 0x14, 0xb4, 0x9b, 0xff, 0x1b, 0xbb, 0x8f, 0x78, 0x07, 0x5a, 0xf1, 0x72, 0x2d, 0xe4, 0x57, 0x98, 0x1b, 0x74, 0xf4, 0x11, 0xb8, 0x6e, 0x35, 0xaa, 0x73, 0x02, 0xe7, 0x30, },
-  {0xf4, 0x96, 0xc3, 0xaa, 0x21, 0x56, 0x3d, 0x10, 0x84, 0x5b, 0xe2, 0xa0, 0x83, 0xd3, 0x43, 0xb7, 0x74, 0xf4, 0x22, 0x63, 0x0b, 0x2b, 0xc2, 0xa7, 0x7e, 0xd5, 0x40, 0x1f, 0xf6, 0x34, 0x4d, 0xb0, 0xe2, 0xbc, 0x23, 0xa8, 0xe7, 0xcd, 0x27, 0x6f, 0x86, 0x54, 0xea, 0xc3, 0x6a, 0x3c, 0x1a, 0x9e, 0xb2, 0x8e, 0x03, 0xba, 0x32, 0x50, 0xd5, 0x29, 0x45, 0xfe, 0x0b, 0x8d, 0x4a, 0xb6, 0x21, 0x5c, },
-  {0xb5, 0x44, 0x06, 0x31, 0xe9, 0x9e, 0xb2, 0xd4, 0x2f, 0x94, 0x38, 0x67, 0x07, 0xfa, 0x24, 0x8b, 0x02, 0xbd, 0x37, 0xa3, 0xd4, 0x8d, 0x3b, 0x00, 0xbb, 0x4b, 0xe7, 0xb5, 0x05, 0x83, 0xef, 0x0e, 0x6f, 0xd4, 0x62, 0x37, 0x83, 0x59, 0x40, 0xe4, 0xa7, 0x37, 0x23, 0xf9, 0xab, 0xd6, 0x82, 0x51, 0xcb, 0x3a, 0x7c, 0xee, 0xa7, 0x65, 0xc3, 0x85, 0xe1, 0x9f, 0x5e, 0x1a, 0xcc, 0x81, 0x69, 0xd4, },
-  {0x5b, 0x74, 0xcc, 0x8b, 0x67, 0x0b, 0xc7, 0x74, 0xe8, 0x20, 0xb8, 0xf0, 0x78, 0x57, 0xa7, 0xe7, 0x5c, 0x97, 0x47, 0xfc, 0x79, 0x52, 0xed, 0x69, 0x24, 0x93, 0x75, 0xa4, 0x65, 0xd8, 0x96, 0x5a, 0x2d, 0x8a, 0xc5, 0x18, 0xf7, 0x95, 0x0b, 0xc1, 0xd9, 0x04, 0x63, 0x99, 0x47, 0x2b, 0xe8, 0x0b, 0xfe, 0x25, 0x5e, 0xd8, 0x0e, 0x3e, 0x96, 0x1e, 0x77, 0xae, 0x2e, 0xe5, 0xf7, 0x3b, 0xa0, 0x15, },
-  {0xfe, 0x1c, 0xe1, 0x4e, 0xf9, 0x80, 0x46, 0x16, 0x62, 0xa7, 0xcd, 0x42, 0x1b, 0x9a, 0x31, 0xc8, 0x15, 0xd7, 0x84, 0x0e, 0xb1, 0x1c, 0x9c, 0xcc, 0xf7, 0x57, 0x14, 0x37, 0xc3, 0x26, 0x45, 0xb7, 0xa1, 0xe9, 0x06, 0x4d, 0xa4, 0x68, 0x2f, 0x76, 0x4c, 0xb5, 0x80, 0xcc, 0x10, 0x8d, 0xbd, 0xa6, 0x6d, 0x45, 0xc4, 0x8a, 0x72, 0xfa, 0xb4, 0x01, 0x4e, 0xc8, 0x67, 0xbb, 0x95, 0x54, 0xde, 0x31, },
-  {0x7f, 0x9a, 0xa8, 0x27, 0xbb, 0x34, 0xdb, 0x9c, 0xf5, 0x4f, 0x0d, 0x8d, 0xda, 0xb2, 0x4c, 0x7e, 0x6e, 0xf0, 0x29, 0x66, 0xc3, 0xe3, 0x44, 0x84, 0x2f, 0xac, 0xe1, 0x8a, 0xfe, 0x71, 0xcf, 0x16, 0xf9, 0x3c, 0x78, 0xdd, 0xb9, 0xd2, 0xed, 0x8a, 0xa1, 0xf4, 0x18, 0xde, 0x53, 0x75, 0x5f, 0x1d, 0xdf, 0x98, 0xb0, 0x17, 0x2e, 0xe3, 0x5c, 0xd1, 0xf0, 0x3a, 0x0f, 0x75, 0x24, 0x05, 0xab, 0x78, },
-  {0xbf, 0x3c, 0x61, 0x02, 0x6f, 0x92, 0x58, 0xc2, 0x85, 0x2b, 0x76, 0xeb, 0x6a, 0xc0, 0x09, 0xe0, 0x3c, 0xa9, 0x55, 0xd1, 0x36, 0x73, 0x08, 0x5e, 0xb8, 0xd3, 0x0a, 0x41, 0x5e, 0xa9, 0x07, 0x7e, 0x54, 0x69, 0x23, 0x90, 0x43, 0x1d, 0x0f, 0x56, 0x24, 0x3f, 0x6c, 0x33, 0xb0, 0xf7, 0x3d, 0xd1, 0x80, 0x09, 0xea, 0x55, 0x9e, 0x48, 0x22, 0x8d, 0x7e, 0x9c, 0xda, 0x47, 0x87, 0xf1, 0xc4, 0x8f, },
-  {0x8d, 0xda, 0xeb, 0xc8, 0xb0, 0xef, 0x21, 0x08, 0x3c, 0xb0, 0xc9, 0x59, 0x36, 0x24, 0xfe, 0x93, 0x1b, 0xba, 0x89, 0x98, 0x22, 0xa7, 0xf3, 0x91, 0x18, 0x7a, 0x4f, 0x9b, 0x1e, 0xe7, 0x8e, 0xbe, 0xda, 0x9b, 0xaf, 0xf4, 0x5e, 0x81, 0xac, 0xc4, 0xd5, 0x91, 0xe7, 0xc2, 0x96, 0x01, 0xa1, 0x2e, 0x4e, 0x68, 0x37, 0xce, 0x7a, 0xbd, 0xac, 0x6b, 0x30, 0x17, 0xf9, 0xa6, 0xcf, 0x5a, 0x3e, 0x1a, },
-  {0x22, 0x10, 0x52, 0x7b, 0x15, 0x42, 0xa5, 0xe2, 0x69, 0xfa, 0x95, 0x01, 0xa3, 0x87, 0x51, 0x64, 0xcd, 0x46, 0x03, 0xf8, 0xd9, 0x4e, 0xbf, 0x3c, 0xeb, 0x6c, 0xc4, 0xf1, 0xb5, 0x2c, 0x4b, 0x38, 0x19, 0xc9, 0x30, 0x00, 0xce, 0x71, 0x38, 0xfe, 0x64, 0x06, 0x7b, 0x5b, 0x1f, 0xeb, 0x87, 0xc5, 0xf3, 0xb7, 0x90, 0xf7, 0x05, 0xdb, 0x10, 0xeb, 0xc4, 0x50, 0xb3, 0x62, 0x0c, 0x2f, 0xdf, 0x6e, },
-  {0x72, 0xa3, 0x36, 0xd5, 0x8a, 0x5f, 0xd1, 0x79, 0xba, 0x14, 0x47, 0xde, 0xd1, 0x7a, 0xec, 0xae, 0x2d, 0xe7, 0x79, 0x5c, 0x13, 0x7f, 0x68, 0xdf, 0x24, 0xa5, 0x32, 0x82, 0x65, 0xdd, 0x74, 0xf6, 0x60, 0x84, 0xe8, 0x50, 0xa2, 0xe3, 0x2a, 0x97, 0x4a, 0xbb, 0xa9, 0x2b, 0x45, 0xd5, 0x64, 0x0e, 0xaa, 0x25, 0x1b, 0x70, 0x42, 0x87, 0x63, 0x3c, 0x93, 0xe4, 0x25, 0x72, 0x99, 0xbd, 0x7e, 0x9d, },
-  {0x5a, 0xb2, 0xfc, 0x28, 0x9b, 0xf3, 0x30, 0x4e, 0x8d, 0x26, 0x63, 0xac, 0x1c, 0x3f, 0xbf, 0x0c, 0x9d, 0x6b, 0x37, 0xc6, 0xa2, 0x2c, 0xb2, 0x05, 0x59, 0x96, 0xd7, 0x15, 0x02, 0xc7, 0x98, 0xa6, 0x0e, 0xb8, 0x76, 0x40, 0x17, 0x89, 0xb3, 0x0b, 0xde, 0x15, 0x85, 0xf9, 0x72, 0xb8, 0x52, 0x79, 0x3e, 0xe5, 0x5c, 0xa4, 0xc8, 0x2a, 0xff, 0xa8, 0x58, 0x03, 0x85, 0xd6, 0x42, 0xed, 0x21, 0x52, },
-  {0x3e, 0x82, 0xbc, 0x4a, 0x0a, 0x6e, 0x1b, 0xcb, 0x9f, 0xe4, 0x7f, 0xf2, 0x2e, 0x71, 0x5b, 0x17, 0x8d, 0xd3, 0xb5, 0xed, 0x92, 0x45, 0xff, 0x8b, 0xcd, 0x4a, 0xf4, 0x3e, 0xad, 0x56, 0x20, 0x44, 0xd4, 0x28, 0x93, 0xf7, 0xc5, 0x57, 0x6a, 0xed, 0x3c, 0x55, 0xc6, 0xda, 0x37, 0x92, 0x17, 0xde, 0x9b, 0x81, 0xd3, 0xba, 0x50, 0x97, 0x13, 0xd1, 0x77, 0xbb, 0x34, 0xfb, 0x11, 0x8e, 0xb0, 0xe4, },
-  {0xd0, 0x00, 0x62, 0xde, 0xac, 0xc2, 0xe8, 0x5a, 0x04, 0x39, 0xbd, 0x4c, 0x98, 0xc7, 0xf6, 0xdb, 0x49, 0x25, 0x53, 0x07, 0x1f, 0xdc, 0x70, 0x37, 0x11, 0xb6, 0x5f, 0x78, 0x90, 0xfc, 0x86, 0xe5, 0x6c, 0x53, 0xab, 0x0a, 0xd9, 0x23, 0xbc, 0x79, 0xa5, 0x90, 0x68, 0x1b, 0x9f, 0x05, 0xc9, 0xfd, 0x31, 0x49, 0x19, 0xed, 0x35, 0x6a, 0xe2, 0x1f, 0x47, 0x9d, 0x67, 0xc7, 0x4d, 0x5e, 0xce, 0x0b, },
-  {0xc3, 0xf0, 0x1f, 0x93, 0x7a, 0x3d, 0x86, 0xb3, 0xfd, 0x6f, 0xd2, 0x11, 0x89, 0x06, 0xb0, 0x7d, 0xa5, 0xfb, 0x75, 0x85, 0xbe, 0x61, 0xc9, 0xa8, 0x81, 0xe4, 0x1b, 0xc0, 0x2a, 0xd0, 0x35, 0x07, 0xbe, 0xed, 0x38, 0x64, 0x7f, 0x9c, 0x33, 0x1a, 0xd1, 0xf4, 0x28, 0x4d, 0xe9, 0xad, 0x5a, 0x6c, 0xbd, 0x0a, 0x8d, 0x76, 0x01, 0xb3, 0x80, 0xc2, 0x2d, 0xf0, 0xad, 0x1a, 0x7b, 0xa4, 0x2b, 0x73, },
-  {0xa1, 0x75, 0x34, 0x52, 0xf8, 0x0d, 0x2a, 0x46, 0x94, 0x21, 0xa7, 0x56, 0xe8, 0x67, 0x42, 0x33, 0x1a, 0x63, 0xe1, 0x3d, 0x9f, 0x4f, 0x0a, 0xf6, 0x29, 0x6a, 0x9c, 0xec, 0x4d, 0x66, 0xb4, 0x7e, 0x9b, 0x1a, 0xcc, 0x8c, 0x4b, 0xe5, 0xf9, 0x46, 0x5f, 0x0c, 0x7f, 0xb6, 0x74, 0x40, 0x87, 0x29, 0xa8, 0xf3, 0x62, 0xd8, 0xa0, 0xf6, 0x5b, 0x90, 0xda, 0x08, 0x8a, 0xe9, 0x3a, 0xdc, 0xf7, 0x41, },
-  {0x89, 0x45, 0xd3, 0xa9, 0xc6, 0x69, 0xa3, 0xd8, 0x7b, 0x61, 0x34, 0xdd, 0xb6, 0x27, 0xef, 0xd1, 0x97, 0xc4, 0xad, 0x0f, 0xef, 0x31, 0x7a, 0x95, 0x47, 0xda, 0x3b, 0x05, 0xa9, 0x13, 0xe1, 0x5a, 0x47, 0x73, 0xff, 0x2b, 0xb6, 0x03, 0x6d, 0xc7, 0xb0, 0x97, 0xde, 0x31, 0xf2, 0xcf, 0x1f, 0xd9, 0x51, 0x96, 0xc7, 0x40, 0x26, 0x4b, 0x0f, 0x38, 0x72, 0x4f, 0x5f, 0x27, 0x9a, 0x04, 0xba, 0x92, },
-  {0xdd, 0xb8, 0x0f, 0xed, 0x1b, 0x59, 0xe4, 0xba, 0x07, 0xf5, 0xc9, 0x1a, 0x74, 0xa0, 0x50, 0x86, 0x03, 0x58, 0x2a, 0x8c, 0xce, 0xb5, 0xdf, 0x20, 0xad, 0x5a, 0xcc, 0x83, 0x73, 0x94, 0xf3, 0x20, 0xd9, 0xa3, 0x0f, 0x5e, 0xd6, 0xa8, 0x15, 0x88, 0x3a, 0x54, 0xc2, 0x01, 0x8e, 0x60, 0x0f, 0xe8, 0x6f, 0x39, 0x1d, 0xb1, 0x86, 0xe7, 0xce, 0xa7, 0xfb, 0xc0, 0xb1, 0xd3, 0x6e, 0x53, 0x83, 0x63, },
-  {0x23, 0x61, 0x80, 0x30, 0x9c, 0x8b, 0x38, 0x16, 0x50, 0x9a, 0x81, 0x3e, 0x8f, 0x10, 0xbc, 0x6e, 0xe3, 0xf3, 0x47, 0x70, 0x16, 0x65, 0x54, 0xc3, 0x8b, 0x12, 0xb8, 0xf9, 0x26, 0xc3, 0x41, 0x32, 0xb0, 0x81, 0xc4, 0x3b, 0x92, 0x52, 0x7b, 0xe1, 0xf1, 0x24, 0x67, 0xa4, 0x48, 0xbe, 0x9c, 0xb3, 0x82, 0x0c, 0xe1, 0x74, 0x58, 0xba, 0x69, 0x96, 0x23, 0x12, 0x82, 0x40, 0xc3, 0xe5, 0x16, 0x25, },
-  {0x39, 0x94, 0xe5, 0x70, 0x49, 0xcf, 0xf1, 0x73, 0xc3, 0x29, 0xb2, 0xe9, 0x5d, 0xff, 0xcb, 0x1f, 0x39, 0xb3, 0x7e, 0xd7, 0x9c, 0xfd, 0x3d, 0x00, 0xf1, 0x6d, 0x33, 0x51, 0xa2, 0x5e, 0xd1, 0x8e, 0x07, 0x68, 0xf2, 0x21, 0xeb, 0xbb, 0x30, 0xa0, 0x1a, 0x73, 0xd2, 0xfe, 0x19, 0x7a, 0x3b, 0xf6, 0x2d, 0xcd, 0xa3, 0xfd, 0x07, 0x32, 0x16, 0x7d, 0x46, 0xe9, 0xa1, 0x0d, 0xf8, 0x34, 0xa9, 0xcf, },
-  {0xd0, 0x51, 0xc0, 0x06, 0xb4, 0x24, 0x7f, 0xa8, 0x65, 0xde, 0x4b, 0x00, 0xd4, 0x2f, 0x46, 0xa5, 0x62, 0x92, 0x12, 0x33, 0xab, 0x23, 0x86, 0x78, 0xe4, 0x9a, 0xd4, 0x1c, 0xe7, 0x11, 0x6e, 0xba, 0xde, 0x53, 0x99, 0x45, 0x72, 0x11, 0x63, 0xca, 0x44, 0xaf, 0x8a, 0x34, 0xe3, 0x57, 0xc8, 0x68, 0x4e, 0x91, 0x5e, 0x43, 0x8b, 0xd7, 0xf2, 0xc7, 0x60, 0xdb, 0x2c, 0x58, 0x77, 0x90, 0x68, 0x50, },
-  {0xef, 0x18, 0xa6, 0xfb, 0x5f, 0xdb, 0x0b, 0x40, 0xf9, 0x14, 0x8c, 0x6b, 0xac, 0x99, 0x80, 0x09, 0xdc, 0xf8, 0xc1, 0x5c, 0xe9, 0xc8, 0x4a, 0xa7, 0x2b, 0x5f, 0x44, 0xb1, 0x7b, 0x89, 0x4b, 0xf7, 0x2b, 0x19, 0xad, 0xcf, 0x8a, 0xdb, 0xfa, 0x08, 0x98, 0xe7, 0x50, 0x0a, 0x83, 0xaa, 0x23, 0x04, 0xec, 0x17, 0xaf, 0xc3, 0x21, 0x9d, 0x53, 0x3b, 0xb3, 0x6d, 0x8b, 0xbc, 0xd6, 0x06, 0xb6, 0xf0, },
-  {0x86, 0x45, 0x29, 0x8e, 0x35, 0x9f, 0x53, 0xcc, 0x94, 0x32, 0xbf, 0x79, 0x23, 0xf2, 0x55, 0xba, 0x71, 0x27, 0x4f, 0x07, 0x8e, 0x6b, 0x18, 0xdb, 0xbc, 0x09, 0x91, 0xfd, 0xc5, 0x02, 0x38, 0xa5, 0x79, 0x5f, 0xe5, 0x04, 0x35, 0xa8, 0x4d, 0x7f, 0x5f, 0x29, 0xbb, 0xce, 0x6d, 0xda, 0x97, 0xba, 0x77, 0xd3, 0x37, 0x6b, 0x7f, 0xe5, 0xab, 0x0b, 0x94, 0x18, 0xed, 0x4a, 0x20, 0x9e, 0x41, 0x13, },
-  {0xb8, 0xd8, 0x78, 0xc7, 0x6a, 0xe9, 0x85, 0x1f, 0xb1, 0x59, 0xee, 0x3d, 0xc5, 0x0e, 0xe3, 0x8a, 0x3d, 0x9d, 0xd3, 0x7b, 0xb7, 0x39, 0xf5, 0x57, 0xcd, 0x75, 0x3b, 0x67, 0x29, 0xd8, 0x98, 0xec, 0xca, 0x3e, 0xbd, 0x81, 0x6a, 0x24, 0xc5, 0xb5, 0x38, 0xf5, 0x15, 0x93, 0x41, 0x2e, 0xf9, 0x46, 0x87, 0xe1, 0x28, 0xf8, 0x00, 0x48, 0x75, 0x29, 0xff, 0xcf, 0x38, 0xac, 0x64, 0xfb, 0xda, 0x7e, },
-  {0x20, 0x57, 0xec, 0x02, 0x42, 0x16, 0xbc, 0x70, 0xe2, 0x05, 0xa0, 0xd5, 0x50, 0x68, 0x33, 0xcd, 0x1a, 0xae, 0xee, 0x44, 0xe0, 0x98, 0x0d, 0x83, 0xa1, 0x21, 0xdf, 0xaa, 0x4f, 0xb6, 0x59, 0x22, 0x0a, 0x91, 0xfd, 0x51, 0xa0, 0xee, 0x17, 0x8e, 0xda, 0x77, 0xa6, 0x64, 0xeb, 0x10, 0x5b, 0xa1, 0x0b, 0x53, 0xa6, 0x95, 0xb6, 0xd0, 0x64, 0xbd, 0x85, 0x56, 0x08, 0x80, 0xc8, 0x2d, 0x52, 0x71, },
-  {0xfa, 0x38, 0xb0, 0x96, 0xd3, 0xa5, 0xfc, 0x28, 0x48, 0x63, 0x80, 0x17, 0x97, 0xb4, 0x7a, 0xfb, 0x5d, 0x02, 0x6a, 0x2d, 0x1b, 0x60, 0xb2, 0x31, 0x4c, 0xf1, 0x12, 0x7f, 0xe8, 0x18, 0x72, 0x87, 0x66, 0xb0, 0x2a, 0x14, 0xce, 0x5b, 0x40, 0x6d, 0x00, 0xcb, 0x54, 0x1f, 0xc1, 0xb0, 0x74, 0xcf, 0x1e, 0x67, 0xc7, 0x3b, 0x5a, 0x16, 0xe9, 0x34, 0xa4, 0xdf, 0x72, 0x9b, 0xe9, 0x8e, 0x01, 0xc0, },
-  {0xa4, 0x14, 0x82, 0x5e, 0x2e, 0x50, 0x7b, 0x90, 0xd9, 0xaa, 0xf5, 0x2d, 0xe8, 0x1f, 0xa7, 0x49, 0x93, 0xbe, 0x80, 0xa2, 0xc4, 0xfe, 0x70, 0xd3, 0x92, 0xc2, 0x5c, 0x8c, 0xcd, 0x43, 0xf7, 0xc2, 0xe1, 0x48, 0xd9, 0x76, 0x95, 0xe0, 0xac, 0xf9, 0x27, 0x9b, 0x45, 0xdc, 0x7f, 0x8e, 0x39, 0xe6, 0xb8, 0xf5, 0x82, 0x10, 0xd8, 0x8a, 0x9a, 0x1d, 0x4c, 0xc2, 0x25, 0x3e, 0x15, 0x5f, 0xad, 0xf2, },
-  {0x09, 0xe6, 0x70, 0xb9, 0xf3, 0x0b, 0xc6, 0x37, 0x13, 0xcd, 0x40, 0x8d, 0x5a, 0xc9, 0x0c, 0xde, 0x27, 0xf1, 0x52, 0xda, 0x89, 0x47, 0x24, 0xea, 0x02, 0x3e, 0xa7, 0x2d, 0x06, 0x9a, 0x34, 0xa3, 0x0e, 0x7f, 0x38, 0xba, 0x09, 0x31, 0x7f, 0x4e, 0xbd, 0x87, 0xf1, 0x30, 0x05, 0xff, 0x50, 0x29, 0x93, 0x44, 0x71, 0x2d, 0xee, 0x42, 0x78, 0xf8, 0x0e, 0x68, 0xf1, 0xb6, 0xd0, 0x48, 0xe2, 0x84, },
-  {0xbd, 0xd0, 0x48, 0x1c, 0xdd, 0x69, 0x9b, 0x58, 0xb5, 0x6f, 0x09, 0xbd, 0x6a, 0x38, 0x84, 0x70, 0x3f, 0xd0, 0x11, 0x37, 0x08, 0xac, 0x59, 0x7d, 0xb6, 0x69, 0xfb, 0x76, 0xbb, 0x61, 0xd3, 0x25, 0x56, 0xf2, 0xa8, 0x5e, 0xec, 0x1f, 0xc9, 0x61, 0xe5, 0x0c, 0x72, 0xa8, 0x67, 0xc9, 0x13, 0x60, 0xa9, 0x03, 0xe4, 0xbf, 0xae, 0x61, 0xca, 0xa8, 0xdb, 0x92, 0x5a, 0xa3, 0x7b, 0x1f, 0x6a, 0x37, },
-  {0x3b, 0x9a, 0x28, 0x8d, 0xab, 0x3e, 0xe8, 0x23, 0xf0, 0x7d, 0x4d, 0xfe, 0xa4, 0xd7, 0xea, 0xb9, 0x9e, 0x62, 0xb1, 0x76, 0xe8, 0xcc, 0x9c, 0x16, 0xe0, 0x4f, 0x1f, 0xd7, 0xeb, 0x4a, 0x6d, 0xb3, 0x91, 0x1c, 0xc4, 0x70, 0x4a, 0x8d, 0x9f, 0x13, 0x39, 0xb5, 0x59, 0xd5, 0x3d, 0xba, 0x9e, 0xdf, 0x77, 0xd3, 0x4d, 0x9c, 0x21, 0x06, 0x54, 0x28, 0x39, 0x83, 0x03, 0x31, 0xfd, 0xc5, 0xd8, 0x09, },
-  {0xdf, 0x74, 0xfe, 0x55, 0xcc, 0x84, 0x01, 0xa8, 0x8a, 0xe0, 0x1d, 0x93, 0x29, 0x03, 0x54, 0x15, 0x8b, 0x21, 0xfa, 0x91, 0x67, 0x2b, 0x3d, 0x8a, 0xc6, 0x34, 0xa1, 0x8f, 0x14, 0x85, 0x09, 0xff, 0xe4, 0x3f, 0x88, 0x02, 0xd6, 0xfc, 0xb1, 0x76, 0xd0, 0x8c, 0x1c, 0xea, 0x92, 0x25, 0x82, 0xf6, 0x1c, 0x35, 0x86, 0x6a, 0xfd, 0x90, 0xbc, 0x6f, 0xd3, 0xb2, 0xec, 0x4f, 0x12, 0x8a, 0xaa, 0x54, },
-  {0x5b, 0x18, 0xb6, 0x0e, 0x31, 0x76, 0xbe, 0x60, 0x44, 0x32, 0xc5, 0x62, 0xb2, 0x46, 0x7e, 0xf6, 0x32, 0xc6, 0x49, 0x17, 0xbc, 0x53, 0xd6, 0xf9, 0x71, 0x0b, 0xb3, 0x58, 0x40, 0xca, 0x9e, 0x77, 0x2c, 0x65, 0xcc, 0x9b, 0x35, 0x26, 0x68, 0x44, 0xf3, 0x2d, 0xa1, 0x4b, 0x10, 0x6f, 0x54, 0x41, 0xc1, 0xb1, 0x59, 0x11, 0xcf, 0x40, 0x80, 0xf5, 0x1b, 0x44, 0xc3, 0x73, 0x99, 0x5e, 0x3d, 0x23, },
-  {0x33, 0x92, 0xd9, 0x67, 0xed, 0x4a, 0xd8, 0xfa, 0x13, 0xa0, 0xd5, 0x76, 0xee, 0x9a, 0xcf, 0x68, 0xab, 0x5b, 0xdc, 0xa2, 0xed, 0x81, 0x04, 0xaa, 0x5f, 0xe5, 0x7c, 0xf2, 0x24, 0xdc, 0x37, 0xbe, 0x51, 0xda, 0x12, 0xaf, 0x5a, 0xe4, 0xc1, 0x0e, 0x55, 0xdb, 0x79, 0xc3, 0xfa, 0xae, 0xcf, 0x0c, 0x95, 0xdc, 0x29, 0xeb, 0xa4, 0x30, 0xe3, 0x10, 0x62, 0x8c, 0xa1, 0x2a, 0xe4, 0xba, 0xf2, 0xdc, },
-  {0xa6, 0x46, 0x85, 0xc2, 0xa1, 0x17, 0x28, 0x95, 0x6e, 0xb7, 0x09, 0x57, 0x19, 0x3c, 0xbc, 0x0f, 0xe4, 0x78, 0x06, 0x3b, 0x27, 0x6d, 0x9a, 0x1e, 0x45, 0x2d, 0xbc, 0x95, 0x6c, 0xad, 0x5e, 0x1a, 0xa7, 0x80, 0xf8, 0x4c, 0x79, 0x19, 0x84, 0x95, 0xaa, 0x03, 0x64, 0x3a, 0x87, 0xe1, 0x31, 0x5f, 0xf0, 0x74, 0x8a, 0xba, 0x4b, 0x77, 0x9b, 0xaf, 0x53, 0xe9, 0xcb, 0x06, 0x6a, 0x19, 0x82, 0x32, },
-  {0x63, 0xf9, 0x05, 0x3c, 0x7b, 0x5c, 0xae, 0xce, 0x53, 0x39, 0xf7, 0x85, 0xdf, 0x2d, 0x8d, 0x4e, 0x24, 0x98, 0x85, 0xb6, 0xcc, 0x4d, 0xf3, 0xc3, 0x8d, 0xd1, 0x19, 0x4d, 0x00, 0xf9, 0x8b, 0xec, 0x06, 0x95, 0x27, 0xbc, 0xdd, 0xa1, 0xf6, 0x3c, 0xca, 0xe7, 0xbb, 0x27, 0x9b, 0x08, 0x6b, 0xa3, 0x19, 0x44, 0x01, 0x65, 0x1f, 0xc7, 0x09, 0xd7, 0x36, 0x1e, 0x7e, 0x40, 0xd3, 0x4c, 0xb2, 0x11, },
-  {0x53, 0xb2, 0xd1, 0x22, 0xdf, 0xf3, 0x83, 0x0e, 0xe5, 0x8f, 0x25, 0xab, 0xc8, 0x6f, 0xa3, 0xf4, 0xd3, 0x43, 0xff, 0x63, 0xd9, 0x0f, 0xaf, 0x36, 0xea, 0x68, 0xa3, 0xe1, 0xc4, 0x2f, 0x49, 0x73, 0xce, 0x43, 0x6a, 0x38, 0x0c, 0x5f, 0x2b, 0x6e, 0x4b, 0x7f, 0x15, 0x5a, 0xed, 0x49, 0xb9, 0x80, 0xd8, 0xca, 0xaa, 0xf5, 0xde, 0x57, 0x93, 0x6b, 0xba, 0xf1, 0xaa, 0x5b, 0xfc, 0x8b, 0x9f, 0x73, },
-  {0x8a, 0x2d, 0x6e, 0x9b, 0x50, 0xba, 0x32, 0x43, 0x76, 0xc2, 0x66, 0x49, 0x03, 0xeb, 0x5a, 0x0c, 0x6c, 0xae, 0x18, 0x2f, 0x91, 0x75, 0x5c, 0x83, 0x08, 0x54, 0x77, 0x3a, 0x82, 0xd4, 0x9f, 0x1f, 0xe3, 0xac, 0xf2, 0xca, 0x91, 0xb3, 0xd4, 0xeb, 0x1e, 0x8e, 0xb2, 0xd5, 0x74, 0xc8, 0x1e, 0xfc, 0x39, 0x53, 0x99, 0x31, 0x82, 0x3d, 0xfe, 0x29, 0x49, 0x74, 0x96, 0x30, 0xbd, 0x24, 0xe3, 0x3a},
-};
+// The frame reduced to 1 bit per pixel, as a monochrome display would get it.
+static uint8_t mono_frame[JaDither::monoRowBytes(WIDTH) * HEIGHT];
 
 // --- Helper Functions ---
 
-// Fills a triangle with a dithered pattern based on its brightness
-// void fillDitheredTriangle(JaDraw<WIDTH, HEIGHT>& canvas, const Vec2i& v1, const Vec2i& v2, const Vec2i& v3, float brightness) {
-//     // Sort vertices by Y coordinate (v1.y <= v2.y <= v3.y)
-//     Vec2i p[3] = {v1, v2, v3};
-//     if (p[0].y > p[1].y) std::swap(p[0], p[1]);
-//     if (p[1].y > p[2].y) std::swap(p[1], p[2]);
-//     if (p[0].y > p[1].y) std::swap(p[0], p[1]);
-    
-//     // Early exit if the triangle is completely outside the screen
-//     if (p[2].y < 0 || p[0].y >= canvas.height) return;
-//     if (std::max({p[0].x, p[1].x, p[2].x}) < 0 || std::min({p[0].x, p[1].x, p[2].x}) >= canvas.width) return;
-    
-//     // Convert brightness (0.0f-1.0f) to a dither level (0-64)
-//     // We multiply by 64 instead of 63 to correctly map 1.0 to the brightest level.
-//     float brightness_level = brightness * 64.0f;
-
-//     // Scanline rasterization
-//     int total_height = p[2].y - p[0].y;
-//     for (int y = p[0].y; y <= p[2].y; ++y) {
-//         if (y < 0 || y >= canvas.height) continue;
-
-//         bool second_half = y > p[1].y || p[1].y == p[0].y;
-//         int segment_height = second_half ? (p[2].y - p[1].y) : (p[1].y - p[0].y);
-        
-//         if (segment_height == 0) continue;
-
-//         float alpha = (float)(y - p[0].y) / total_height;
-//         float beta  = (float)(y - (second_half ? p[1].y : p[0].y)) / segment_height;
-
-//         int ax = p[0].x + (p[2].x - p[0].x) * alpha;
-//         int bx = second_half ? (p[1].x + (p[2].x - p[1].x) * beta) : (p[0].x + (p[1].x - p[0].x) * beta);
-
-//         if (ax > bx) std::swap(ax, bx);
-        
-//         ax = std::max(0, ax);
-//         bx = std::min(canvas.width, bx);
-
-//         for (int x = ax; x < bx; ++x) {
-//             // --- MODIFIED DITHERING LOGIC ---
-//             // Get the threshold from the Bayer matrix for this pixel coordinate.
-//             // (x & 7) is a fast way to do (x % 8).
-//             uint8_t threshold = BAYER_MATRIX_8x8[y & 7][x & 7];
-            
-//             // If the triangle's brightness level is greater than the matrix's
-//             // threshold for this pixel, then draw the pixel.
-//             if (brightness_level > threshold) {
-//                 canvas.drawPixel(x, y, Colors::White);
-//             }
-//         }
-//     }
-// }
-
-// --- REPLACEMENT for the fillDitheredTriangle function ---
-// void fillDitheredTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
-//      const Vec2i& v1, const Vec2i& v2, const Vec2i& v3, float brightness)
-// {
-//     // Sort vertices by Y coordinate (v1.y <= v2.y <= v3.y)
-//     Vec2i p[3] = {v1, v2, v3};
-//     if (p[0].y > p[1].y) std::swap(p[0], p[1]);
-//     if (p[1].y > p[2].y) std::swap(p[1], p[2]);
-//     if (p[0].y > p[1].y) std::swap(p[0], p[1]);
-
-//     // Early exit if the triangle is completely outside the screen
-//     if (p[2].y < 0 || p[0].y >= canvas.height) return;
-//     if (std::max({p[0].x, p[1].x, p[2].x}) < 0 || std::min({p[0].x, p[1].x, p[2].x}) >= canvas.width) return;
-
-//     // Convert brightness (0.0f-1.0f) to a dither level (0-255)
-//     float brightness_level = brightness * 255.0f;
-
-//     // --- Animated Offset for Noise Texture ---
-//     // This makes the noise "sizzle" instead of being static on the screen.
-//     // We use different divisors for X and Y to avoid diagonal patterns.
-//     // The "& 63" is a fast way of doing "% 64".
-//     uint8_t offsetX = (millis / 3) & 63;
-//     uint8_t offsetY = (millis / 11) & 63;
-
-//     // Scanline rasterization
-//     int total_height = p[2].y - p[0].y;
-//     for (int y = p[0].y; y <= p[2].y; ++y) {
-//         if (y < 0 || y >= canvas.height) continue;
-
-//         bool second_half = y > p[1].y || p[1].y == p[0].y;
-//         int segment_height = second_half ? (p[2].y - p[1].y) : (p[1].y - p[0].y);
-        
-//         if (segment_height == 0) continue;
-
-//         float alpha = (float)(y - p[0].y) / total_height;
-//         float beta  = (float)(y - (second_half ? p[1].y : p[0].y)) / segment_height;
-
-//         int ax = p[0].x + (p[2].x - p[0].x) * alpha;
-//         int bx = second_half ? (p[1].x + (p[2].x - p[1].x) * beta) : (p[0].x + (p[1].x - p[0].x) * beta);
-
-//         if (ax > bx) std::swap(ax, bx);
-        
-//         ax = std::max(0, ax);
-//         bx = std::min(canvas.width, bx);
-
-//         for (int x = ax; x < bx; ++x) {
-//             // --- BLUE NOISE DITHERING LOGIC ---
-//             // Look up the threshold in the blue noise texture, applying the
-//             // animated offset. This makes the texture tile across the screen.
-//             uint8_t threshold = BLUE_NOISE_64x64[(y + offsetY) & 63][(x + offsetX) & 63];
-            
-//             // If the triangle's brightness is greater than the noise threshold
-//             // for this pixel, then draw the pixel.
-//             if (brightness_level > threshold) {
-//                 canvas.drawPixel(x, y, Colors::White);
-//             }
-//         }
-//     }
-// }
-
-
-void fillDitheredTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
-     const Vec2i& v1, const Vec2i& v2, const Vec2i& v3, float brightness)
+// Fills a triangle with a gray as bright as `brightness` (0.0f-1.0f). The frame is dithered at the end.
+void fillGrayTriangle(JaDraw<WIDTH, HEIGHT>& canvas, const Vec2i& v1, const Vec2i& v2, const Vec2i& v3, float brightness)
 {
-    // --- Initial Setup ---
-
-    // Sort vertices by Y coordinate (p0.y <= p1.y <= p2.y) using pointers to avoid copies.
-    const Vec2i* p[3] = {&v1, &v2, &v3};
-    if (p[0]->y > p[1]->y) std::swap(p[0], p[1]);
-    if (p[1]->y > p[2]->y) std::swap(p[1], p[2]);
-    if (p[0]->y > p[1]->y) std::swap(p[0], p[1]);
-
-    const Vec2i& p0 = *p[0];
-    const Vec2i& p1 = *p[1];
-    const Vec2i& p2 = *p[2];
-
-    // Early exit if the triangle is completely outside the screen
-    if (p2.y < 0 || p0.y >= canvas.height) return;
-    if (std::max({p0.x, p1.x, p2.x}) < 0 || std::min({p0.x, p1.x, p2.x}) >= canvas.width) return;
-
-    // --- Fixed-Point Setup ---
-
-    // This is the ONLY floating-point operation, performed once per triangle.
-    // It converts the 0.0-1.0 brightness into a 0-255 integer threshold.
-    int32_t brightness_level = static_cast<int32_t>(brightness * 255.0f);
-
-    // Get animated offset for "sizzling" noise. Your original values were very fast,
-    // so I have kept them.
-    uint8_t offsetX = (millis / 3) & 63;
-    uint8_t offsetY = (millis / 11) & 63;
-
-    // We'll use 16.16 fixed-point precision. (16 bits for integer, 16 for fraction)
-    const int FIXED_POINT_SHIFT = 16;
-
-    // --- Rasterize Top Half of Triangle ---
-    int32_t height01 = p1.y - p0.y;
-    if (height01 > 0) {
-        int32_t height02 = p2.y - p0.y;
-        // Calculate slopes (dx/dy) using fixed-point math
-        int32_t slope1 = ((p1.x - p0.x) << FIXED_POINT_SHIFT) / height01;
-        int32_t slope2 = ((p2.x - p0.x) << FIXED_POINT_SHIFT) / height02;
-
-        int32_t x1 = p0.x << FIXED_POINT_SHIFT;
-        int32_t x2 = p0.x << FIXED_POINT_SHIFT;
-
-        for (int y = p0.y; y < p1.y; ++y) {
-            // Only draw scanlines that are on-screen
-            if (y >= 0 && y < canvas.height) {
-                int startX = x1 >> FIXED_POINT_SHIFT;
-                int endX   = x2 >> FIXED_POINT_SHIFT;
-                if (startX > endX) std::swap(startX, endX);
-                
-                // Clip and draw the horizontal line
-                for (int x = std::max(0, startX); x < std::min(canvas.width, endX); ++x) {
-                    uint8_t threshold = BLUE_NOISE_64x64[(y + offsetY) & 63][(x + offsetX) & 63];
-                    if (brightness_level > threshold) {
-                        canvas.drawPixel(x, y, Colors::White);
-                    }
-                }
-            }
-            // Increment x positions by their slopes for the next line
-            x1 += slope1;
-            x2 += slope2;
-        }
-    }
-
-    // --- Rasterize Bottom Half of Triangle ---
-    int32_t height12 = p2.y - p1.y;
-    if (height12 > 0) {
-        int32_t height02 = p2.y - p0.y;
-        // Calculate slopes. The long edge's slope (p0-p2) is the same.
-        int32_t slope1 = ((p2.x - p1.x) << FIXED_POINT_SHIFT) / height12;
-        int32_t slope2 = ((p2.x - p0.x) << FIXED_POINT_SHIFT) / height02;
-
-        // Start x positions at the middle vertex and the corresponding point on the long edge
-        int32_t x1 = p1.x << FIXED_POINT_SHIFT;
-        int32_t x2 = (p0.x << FIXED_POINT_SHIFT) + slope2 * height01;
-
-        for (int y = p1.y; y <= p2.y; ++y) {
-            if (y >= 0 && y < canvas.height) {
-                int startX = x1 >> FIXED_POINT_SHIFT;
-                int endX   = x2 >> FIXED_POINT_SHIFT;
-                if (startX > endX) std::swap(startX, endX);
-
-                for (int x = std::max(0, startX); x < std::min(canvas.width, endX); ++x) {
-                    uint8_t threshold = BLUE_NOISE_64x64[(y + offsetY) & 63][(x + offsetX) & 63];
-                    if (brightness_level > threshold) {
-                        canvas.drawPixel(x, y, Colors::White);
-                    }
-                }
-            }
-            x1 += slope1;
-            x2 += slope2;
-        }
-    }
+    const uint8_t level = JaDither::clampLevel(static_cast<int32_t>(brightness * 255.0f));
+    const uint32_t color = JADRAW_RGBA(level, level, level, 255);
+
+    const JaRasterVertex<> a = {(float)v1.x, (float)v1.y};
+    const JaRasterVertex<> b = {(float)v2.x, (float)v2.y};
+    const JaRasterVertex<> c = {(float)v3.x, (float)v3.y};
+    canvas.rasterizeTriangle(a, b, c, [&](const JaRasterSpan<>& span) {
+        std::fill(span.pixels + span.x_begin, span.pixels + span.x_end, color);
+    });
 }
 
 
@@ -497,57 +84,36 @@ void MyApplet::loop(JaDraw<WIDTH, HEIGHT>& canvas, float dt, const InputData& in
     float cosY = cosf(angleY);
 
     // Light source direction (normalized)
-    Vec3 light_direction = {0.0f, 0.5f, -1.0f};
-    // Normalize light direction vector
-    float light_mag = sqrtf(light_direction.x * light_direction.x + light_direction.y * light_direction.y + light_direction.z * light_direction.z);
-    light_direction.x /= light_mag; light_direction.y /= light_mag; light_direction.z /= light_mag;
+    Vec3f light_direction = vec3_normalize((Vec3f){0.0f, 0.5f, -1.0f});
+
+    // Same rotation as the vertices get: Y first, then X.
+    auto rotate = [&](Vec3f v) {
+        float rotY_x = v.x * cosY - v.z * sinY;
+        float rotY_z = v.x * sinY + v.z * cosY;
+        return (Vec3f){rotY_x, v.y * cosX - rotY_z * sinX, v.y * sinX + rotY_z * cosX};
+    };
 
     // --- 2. Transform, Cull, and Project ---
-    Vec3 transformed_vertices[8];
-    std::vector<RenderTriangle> trianglesToRender;
-
-    // Process all 12 triangles of the cube
-    for (int i = 0; i < 76; ++i) {
-        Vec3 v[3], transformed_v[3];
-        
-        // Get the 3 vertices for this triangle from the original model
-        for (int j = 0; j < 3; ++j) {
-            v[j] = CUBE_VERTICES[CUBE_TRIANGLES[i][j]];
-
-            // Apply Y-axis rotation
-            float rotY_x = v[j].x * cosY - v[j].z * sinY;
-            float rotY_z = v[j].x * sinY + v[j].z * cosY;
-            
-            // Apply X-axis rotation to the result of Y-rotation
-            transformed_v[j].x = rotY_x;
-            transformed_v[j].y = v[j].y * cosX - rotY_z * sinX;
-            transformed_v[j].z = v[j].y * sinX + rotY_z * cosX;
-        }
+    trianglesToRender.clear();
 
+    for (int i = 0; i < mesh_num_triangles(&MYAPPLET_MODEL_MESH); ++i) {
         // --- Back-face Culling & Shading ---
-        // Get two edges of the triangle
-        Vec3 edge1 = {transformed_v[1].x - transformed_v[0].x, transformed_v[1].y - transformed_v[0].y, transformed_v[1].z - transformed_v[0].z};
-        Vec3 edge2 = {transformed_v[2].x - transformed_v[0].x, transformed_v[2].y - transformed_v[0].y, transformed_v[2].z - transformed_v[0].z};
-
-        // Calculate the normal vector using the cross product
-        Vec3 normal;
-        normal.x = edge1.y * edge2.z - edge1.z * edge2.y;
-        normal.y = edge1.z * edge2.x - edge1.x * edge2.z;
-        normal.z = edge1.x * edge2.y - edge1.y * edge2.x;
+        // Rotating the precomputed face normal is cheaper than rebuilding it from the rotated vertices.
+        Vec3f normal = rotate(mesh_face_normal(&MYAPPLET_MODEL_MESH, i));
 
         // Check if the face is visible (if its normal is pointing towards the camera at Z=-infinity)
         if (normal.z < 0) {
             // --- Lighting Calculation (Flat Shading) ---
-            // Normalize the normal vector
-            float mag = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
-            normal.x /= mag; normal.y /= mag; normal.z /= mag;
+            float dp = vec3_dot(normal, light_direction);
 
-            // Calculate dot product between the normal and the light direction
-            float dp = normal.x * light_direction.x + normal.y * light_direction.y + normal.z * light_direction.z;
-            
             // Clamp brightness from 0 to 1. Add some ambient light.
             float brightness = std::max(0.0f, dp) * 0.8f + 0.1f;
 
+            Vec3f transformed_v[3];
+            for (int j = 0; j < 3; ++j) {
+                transformed_v[j] = rotate(mesh_vertex(&MYAPPLET_MODEL_MESH, mesh_index(&MYAPPLET_MODEL_MESH, i * 3 + j)));
+            }
+
             // --- Perspective Projection ---
             RenderTriangle tri;
             tri.brightness = brightness;
@@ -565,23 +131,27 @@ void MyApplet::loop(JaDraw<WIDTH, HEIGHT>& canvas, float dt, const InputData& in
             }
             tri.avgZ /= 3.0f;
 
-            trianglesToRender.push_back(tri);
+            trianglesToRender.push(tri, JaRenderQueue<RenderTriangle>::depthKey(tri.avgZ, RENDER_MIN_Z, RENDER_MAX_Z));
         }
     }
 
     // --- 3. Sort Triangles (Painter's Algorithm) ---
     // Sort from back to front (farthest to nearest)
-    std::sort(trianglesToRender.begin(), trianglesToRender.end(), [](const RenderTriangle& a, const RenderTriangle& b) {
-        return a.avgZ > b.avgZ;
-    });
+    trianglesToRender.sort(true);
 
     // --- 4. Rasterize Triangles ---
     // A real application would clear the screen/framebuffer here.
     // e.g., clearScreen();
 
-    for (const auto& tri : trianglesToRender) {
-        fillDitheredTriangle(canvas, millis, tri.p[0], tri.p[1], tri.p[2], tri.brightness);
+    for (size_t i = 0; i < trianglesToRender.size(); ++i) {
+        const RenderTriangle& tri = trianglesToRender[i];
+        fillGrayTriangle(canvas, tri.p[0], tri.p[1], tri.p[2], tri.brightness);
     }
+
+    // --- 5. Dither to Black and White ---
+    // The noise moves every frame for a "sizzling" look.
+    JaDither::ditherToMono(canvas, mono_frame, JaDitherMethod::BLUE_NOISE, (int)(millis / 3), (int)(millis / 11));
+    JaDither::expandMono(mono_frame, canvas);
 }
 
 const char* MyApplet::getName() const {
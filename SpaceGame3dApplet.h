@@ -3,6 +3,13 @@
 #include "JaDraw.h"
 #include "vmath_all.hpp"
 #include "math_3d.h"
+#include "mesh_3d.h"
+#include "math_3d_fixed.h"
+#include "JaTexture.h"
+#include "JaParticleSystem.h"
+#include "JaDither.h"
+#include "ship_mesh.h" // SHIP_MESH, quantized by tools/jamesh_convert
+#include "asteroid_mesh.h" // ASTEROID_MODEL_MESH, with levels of detail
 
 #define MAX_ASTEROIDS 20
 #define MAX_BULLETS 15
@@ -30,6 +37,35 @@
 #define ASTEROID_MIN_SIZE 0.2f
 #define ASTEROID_MAX_SIZE 0.5f
 
+#define MAX_MODEL_VERTICES 64
+// Triangles of a model and all its levels of detail together.
+#define MAX_MODEL_TRIANGLES 64
+// Room in a ProjectedMeshCache. Models that need more are drawn without caching.
+#define MAX_CACHED_TRIANGLES 32
+// Triangles and dots a draw_mesh_instanced() batch holds back to draw together at the end;
+// batches with more draw them in several goes.
+#define MAX_QUEUED_TRIANGLES 128
+#define MAX_QUEUED_DOTS 32
+// How far the inputs of a ProjectedMeshCache may drift (in world units, radians or matrix
+// entries) and still reuse it; a small fraction of a sub-pixel step for models the ship's size.
+#define PROJECTED_CACHE_TOLERANCE 1e-4f
+// Triangles reaching further than this many screen widths/heights off-center get clipped
+// before rasterizing, keeping the fixed-point edge math in range.
+#define GUARD_BAND 8.0f
+#define CAMERA_NEAR 0.1f
+#define CAMERA_FAR 100.0f
+// Draw models with a depth buffer (16 KB) so overlapping models hide each other properly.
+#define USE_DEPTH_BUFFER 1
+// Run the vertex path (model matrices, vertex transforms, projection, clipping, culling and
+// lighting) in Q16.16 fixed point instead of float, for boards without an FPU. See math_3d_fixed.h.
+#define USE_FIXED_POINT 0
+// Instances draw the coarsest level of detail that is off by at most this many pixels; the
+// dithering hides a pixel or two. Ones smaller than LOD_POINT_RADIUS pixels are drawn as a dot.
+#define LOD_PIXEL_ERROR 2.0f
+#define LOD_POINT_RADIUS 1.5f
+// Levels of detail considered by draw_mesh_instanced(); any beyond these are skipped.
+#define MAX_BATCH_LODS 4
+
 //struct Vec2i { int x, y; };
 //struct Vec3f { float x, y, z; };
 //struct Mat4f { float m[4][4]; };
@@ -79,6 +115,11 @@ struct GameState {
     int score;
     int nextTimeGoalMs;
     float asteroidBaseSpeed;
+
+    // Asteroids destroyed this frame, as they were when hit, so the drawing side can burst them
+    // into debris. Emptied at the start of every frame.
+    Asteroid destroyedAsteroids[MAX_ASTEROIDS];
+    int numDestroyedAsteroids;
 };
 
 struct GameInputData {
@@ -100,25 +141,9 @@ const int CUBE_INDICES[] = {
     3, 6, 2, 3, 7, 6, // Top face
     4, 1, 5, 4, 0, 1  // Bottom face
 };
+const int CUBE_NUM_VERTICES = 8;
 const int CUBE_NUM_INDICES = 36;
 
-const Vec3f ASTEROID_VERTICES[] = {
-    {-0.5360100f, 0.5601110f, -0.1807760f},     {-0.05187100f, -0.1256810f, -0.5897210f},
-    {-0.5453930f, -0.1025600f, 0.003804000f},     {0.4016950f, 0.4737450f, -0.2939520f},
-    {-0.5151500f, 0.1303340f, 0.4875140f},     {0.06148500f, -0.5309490f, 0.2525580f},
-    {-0.0009630000f, 0.5017880f, 0.3516430f},     {0.4872200f, 0.02320100f, 0.3961280f},
-    {0.4230950f, -0.1500950f, -0.3389490f},
-};
-
-const int ASTEROID_INDICES[] = {
-    1, 0, 3, 0, 4, 6, 7, 4, 5, 1, 8, 5, 
-    3, 0, 6, 4, 2, 5, 6, 7, 3, 7, 6, 4, 
-    1, 3, 8, 4, 0, 2, 5, 2, 1, 2, 0, 1, 
-    8, 3, 7, 5, 8, 7
-};
-
-const int ASTEROID_NUM_INDICES = 42;
-
 const Vec3f QUAD_VERTICES[] = {
     {-0.5f, 0.0f, -0.5f}, { 0.5f, 0.0f, -0.5f},
     {-0.5f, 0.0f,  5.5f}, { 0.5f, 0.0f,  5.5f},
@@ -126,29 +151,33 @@ const Vec3f QUAD_VERTICES[] = {
 const int QUAD_INDICES[] = {
     2, 1, 3, 2, 0, 1
 };
+const int QUAD_NUM_VERTICES = 4;
 const int QUAD_NUM_INDICES = 6;
 
-
-const Vec3f SHIP_VERTICES[] = {
-    {0.000000f, 0.09429200f, -0.8442920f},     {0.000000f, -0.05570800f, 0.4057080f},
-    {-0.06993900f, 0.2442920f, 0.4057080f},     {0.06993900f, 0.2442920f, 0.4057080f},
-    {-0.8699390f, 0.09429200f, 0.1557080f},     {0.8699390f, 0.09429200f, 0.1557080f},
-    {-0.2704030f, 0.1381030f, -0.07282900f},     {0.2704030f, 0.1381030f, -0.07282900f},
-    {-0.8453970f, 0.05703800f, 0.1043630f},     {0.8453970f, 0.05703800f, 0.1043630f},
-    {-0.8453970f, 0.05703800f, 0.1043630f},     {-0.8048760f, 0.06294900f, -0.5191000f},
-    {-0.7264710f, 0.04886800f, 0.07942300f},     {0.7264710f, 0.04886800f, 0.07942300f},
-    {0.8048760f, 0.06294900f, -0.5191000f},
-};
-
-const int SHIP_INDICES[] = {
-    2, 1, 3, 4, 1, 2, 5, 3, 1, 4, 6, 1, 
-    0, 7, 1, 1, 7, 5, 1, 6, 0, 11, 12, 10, 
-    13, 14, 9
+// Meshes are built once at startup so face normals and bounds aren't recomputed every frame.
+static Vec3f CUBE_FACE_NORMALS[CUBE_NUM_INDICES / 3];
+static Vec3f QUAD_FACE_NORMALS[QUAD_NUM_INDICES / 3];
+static float ASTEROID_UVS[ASTEROID_MODEL_NUM_INDICES * 2];
+static const Mesh CUBE_MESH = mesh_make(CUBE_VERTICES, CUBE_NUM_VERTICES, CUBE_INDICES, CUBE_NUM_INDICES, CUBE_FACE_NORMALS);
+// Asteroids are smooth-shaded so they look rounder than their few faces; the ship stays faceted.
+// Their levels of detail have no UVs, so far-off asteroids are drawn untextured.
+static const Mesh ASTEROID_MESH = mesh_with_box_uvs(ASTEROID_MODEL_MESH, ASTEROID_UVS, 1.5f);
+static const Mesh QUAD_MESH = mesh_make(QUAD_VERTICES, QUAD_NUM_VERTICES, QUAD_INDICES, QUAD_NUM_INDICES, QUAD_FACE_NORMALS);
+
+
+// Craters for the asteroids. Only the green channel is used, as a brightness multiplier.
+const uint32_t ROCK_PALETTE[] = {0xFFFFFFFF, 0xB0B0B0FF, 0x606060FF};
+const uint8_t ROCK_PIXELS[] = {
+    0, 0, 0, 1, 1, 0, 0, 0,
+    0, 0, 1, 2, 2, 1, 0, 0,
+    0, 0, 1, 2, 2, 1, 0, 0,
+    0, 0, 0, 1, 1, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 1, 2,
+    1, 1, 0, 0, 0, 0, 0, 1,
+    2, 1, 0, 0, 1, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0,
 };
-
-const int SHIP_NUM_INDICES = 27;
-
-
+static const JaTexture ROCK_TEXTURE(JaSprite(8, 8, ROCK_PALETTE, ROCK_PIXELS));
 
 static GameInputData gameInputData;
 
@@ -169,9 +198,13 @@ static void update_asteroids(GameState* state, float dt);
 static void update_laser(GameState* state, float dt);
 static void handle_spawning(GameState* state, float dt);
 static void handle_collisions(GameState* state);
+static void init_particles();
+static void update_particles(const GameState* state, float dt);
 static void draw_game_3d(const GameState* state, JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis);
 static void world_to_screen(float wx, float wy, uint32_t* sx, uint32_t* sy);
 static void draw_filled_rect(JaDraw<WIDTH, HEIGHT>& canvas, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool white);
+static void draw_points_3d(JaDraw<WIDTH, HEIGHT>& canvas, const Mat4f* vp_matrix,
+                           std::span<const PointInstance> points, JaPointShape shape = JaPointShape::SQUARE);
 
 
 static float rand_float(float min, float max) {
@@ -180,11 +213,6 @@ static float rand_float(float min, float max) {
 
 SpaceGame3dApplet::SpaceGame3dApplet() { }
 
-static void drawPixel(JaDraw<WIDTH, HEIGHT>& canvas, uint32_t x, uint32_t y, bool white)
-{
-    canvas.drawPixel(x, y, white ? Colors::White : Colors::Black);
-}
-
 static void clear_canvas(JaDraw<WIDTH, HEIGHT>& canvas)
 {
     canvas.clear(0);
@@ -208,6 +236,7 @@ static void init_game(GameState* state) {
     state->score = 0;
     state->nextTimeGoalMs = 1000;
     state->asteroidBaseSpeed = 0.0f;
+    state->numDestroyedAsteroids = 0;
     
     // Seed random number generator. In a real embedded system without a time source,
     // you might use an unconnected ADC pin or some other source of entropy.
@@ -215,7 +244,9 @@ static void init_game(GameState* state) {
     srand(12345);
 }
 
-void SpaceGame3dApplet::setup() { }
+void SpaceGame3dApplet::setup() {
+    init_particles();
+}
 
 void SpaceGame3dApplet::loop(JaDraw<WIDTH, HEIGHT>& canvas, float dt, const InputData& inputs) {
     static unsigned long millis = 0;
@@ -234,6 +265,7 @@ void SpaceGame3dApplet::loop(JaDraw<WIDTH, HEIGHT>& canvas, float dt, const Inpu
         init_game(&state);
         initialized = true;
     }
+    state.numDestroyedAsteroids = 0;
 
     if (!state.gameOver) {
         // --- Update Game Logic ---
@@ -268,6 +300,7 @@ void SpaceGame3dApplet::loop(JaDraw<WIDTH, HEIGHT>& canvas, float dt, const Inpu
 
 
     // --- Render the Game State to the Canvas ---
+    update_particles(&state, dt);
     draw_game_3d(&state, canvas, millis);
 }
 
@@ -401,6 +434,12 @@ static void handle_spawning(GameState* state, float dt) {
     }
 }
 
+// Takes an asteroid out of play, remembering it for this frame's debris.
+static void destroy_asteroid(GameState* state, Asteroid* asteroid) {
+    asteroid->active = false;
+    state->destroyedAsteroids[state->numDestroyedAsteroids++] = *asteroid;
+}
+
 static void handle_collisions(GameState* state) {
     // --- Bullets vs Asteroids ---
     for (int b = 0; b < MAX_BULLETS; ++b) {
@@ -421,8 +460,8 @@ static void handle_collisions(GameState* state) {
                 state->asteroids[a].flashTimerMs = 150;
                 state->bullets[b].active = false; // Bullet is used up
                 if (state->asteroids[a].hp <= 0) {
-                    state->asteroids[a].active = false;
                     state->score += 120;
+                    destroy_asteroid(state, &state->asteroids[a]);
                 }
                 break; // A bullet can only hit one asteroid
             }
@@ -441,7 +480,7 @@ static void handle_collisions(GameState* state) {
                 // Laser does damage over time, scaled by dt
                 state->asteroids[a].hp -= LASER_BASE_DAMAGE * state->laser.power * (1.0f / 60.0f); // Assuming 60fps for damage scaling
                  if (state->asteroids[a].hp <= 0) {
-                    state->asteroids[a].active = false;
+                    destroy_asteroid(state, &state->asteroids[a]);
                 }
             }
         }
@@ -459,285 +498,809 @@ static void handle_collisions(GameState* state) {
             fabsf(state->player.pos.y - state->asteroids[a].pos.y) < (p_half_h + a_half_s))
         {
             state->player.hp -= state->asteroids[a].size * 100.0f; // Damage based on size
-            state->asteroids[a].active = false; // Asteroid is destroyed
+            destroy_asteroid(state, &state->asteroids[a]); // Asteroid is destroyed
         }
     }
 }
 
 ////////////////////////// drawing ///////////////////////////////////////////////////////////////////
 
-const uint32_t BLUE_NOISE[32][32] = {
-  {0xe5, 0x91, 0xf4, 0x9e, 0xc0, 0xf9, 0x3d, 0xdc, 0xa6, 0x2e, 0x1f, 0xc2, 0xf2, 0x15, 0xcd, 0x27, 0x6e, 0x59, 0x97, 0x7a, 0x20, 0x70, 0x07, 0x7f, 0xa8, 0x3e, 0x99, 0xff, 0x5c, 0xbf, 0x09, 0x6c },
-  {0x2d, 0xba, 0x48, 0x08, 0xcd, 0x7c, 0x1c, 0xb3, 0x6d, 0xfe, 0x9c, 0x4b, 0x79, 0x68, 0x91, 0x3e, 0xf1, 0xb1, 0x47, 0xfc, 0xc5, 0xe3, 0x5d, 0x49, 0xda, 0x10, 0xcb, 0x26, 0x36, 0x90, 0xed, 0x41 },
-  {0xa2, 0xd4, 0x23, 0x89, 0x68, 0x31, 0x51, 0x8f, 0x0e, 0x5a, 0x86, 0xe3, 0xb5, 0x30, 0xd9, 0x07, 0x82, 0xbe, 0x2e, 0x0d, 0xa1, 0x3a, 0xb2, 0x94, 0xf0, 0x55, 0x68, 0xe2, 0xaf, 0x73, 0xdb, 0x11 },
-  {0x39, 0x77, 0x5d, 0xef, 0xa8, 0xe5, 0xbb, 0xd6, 0xee, 0x39, 0xc9, 0x01, 0x41, 0xa3, 0xf8, 0x62, 0x9c, 0x14, 0xdb, 0x67, 0x52, 0x83, 0x25, 0xc3, 0x19, 0x89, 0xa3, 0x03, 0x4b, 0x1c, 0xa0, 0x57 },
-  
-  {0x00, 0xb1, 0xdd, 0x14, 0x40, 0x73, 0x27, 0x7f, 0x18, 0xaa, 0x71, 0x25, 0xd5, 0x58, 0x1c, 0xc3, 0x50, 0xe6, 0x76, 0xaa, 0xcf, 0x01, 0xf8, 0x72, 0x35, 0xd3, 0x7b, 0xbe, 0xf7, 0x87, 0x2d, 0xba },
-  {0x99, 0xc8, 0x4f, 0x90, 0xc2, 0x04, 0xa1, 0x60, 0x46, 0xbf, 0xe8, 0x97, 0x7c, 0xb0, 0x8b, 0x70, 0x34, 0x23, 0x8f, 0x40, 0xea, 0x98, 0xb7, 0x60, 0x45, 0xe9, 0x2b, 0x5d, 0x3e, 0xcd, 0x66, 0xd6 },
-  {0x43, 0x1e, 0xf2, 0x2d, 0x5a, 0xfc, 0xd2, 0x94, 0xf4, 0x2e, 0x66, 0x13, 0x4c, 0xed, 0x09, 0xce, 0xfe, 0xb4, 0xc8, 0x5b, 0x1c, 0x30, 0xdf, 0x11, 0xab, 0x91, 0x0b, 0xb1, 0xe7, 0x97, 0x0d, 0x50 },
-  {0x60, 0x80, 0xa5, 0x6d, 0xb5, 0x84, 0x3a, 0x0d, 0xca, 0x53, 0x86, 0xb8, 0xd8, 0x2a, 0x3e, 0xa4, 0x4a, 0x81, 0x0c, 0xf4, 0x6e, 0x89, 0x4c, 0x7d, 0xca, 0xfa, 0x53, 0x70, 0x17, 0x7d, 0xa8, 0x23 },
-  
-  {0xd5, 0x36, 0x07, 0xe7, 0x1b, 0x4a, 0xe1, 0x23, 0x75, 0xa7, 0x05, 0xfa, 0x9d, 0x60, 0x78, 0xde, 0x17, 0x63, 0x99, 0x39, 0xbd, 0xa4, 0xd5, 0x21, 0x66, 0x9e, 0x25, 0xda, 0xc6, 0x32, 0xee, 0xdd },
-  {0x4d, 0x97, 0xc3, 0x78, 0xce, 0x9e, 0x67, 0xb0, 0x8c, 0xe5, 0x43, 0x35, 0xc2, 0x1e, 0x92, 0xbb, 0xee, 0x2e, 0xac, 0xe2, 0x08, 0x57, 0xed, 0x40, 0x04, 0xbf, 0x38, 0x8d, 0x49, 0xb4, 0x6c, 0x58 },
-  {0x18, 0xb3, 0xf7, 0x57, 0x32, 0x11, 0xbe, 0xf1, 0x59, 0x19, 0xd1, 0x6e, 0x80, 0xf2, 0x54, 0x04, 0x6c, 0xd1, 0x50, 0x77, 0xc8, 0x29, 0x95, 0xb5, 0x73, 0xe1, 0x81, 0xf0, 0x61, 0x01, 0x92, 0x1a },
-  {0xde, 0x6a, 0x42, 0x25, 0x92, 0xdb, 0x7e, 0x3d, 0x2a, 0x97, 0xb4, 0x4d, 0x0d, 0xab, 0xc9, 0x44, 0x84, 0x20, 0x8e, 0xf8, 0x17, 0x6a, 0x85, 0xfd, 0x14, 0x59, 0xac, 0x10, 0xa0, 0xd6, 0xfe, 0x3c },
-  
-  {0xa7, 0x0d, 0x81, 0xe8, 0xab, 0x63, 0x4e, 0x01, 0xc4, 0xff, 0x5e, 0xdf, 0x27, 0xe7, 0x32, 0x9b, 0xdb, 0xb7, 0x3c, 0x9f, 0x48, 0xda, 0x36, 0xa5, 0x4b, 0xd2, 0x2c, 0x43, 0xc1, 0x21, 0x73, 0x85 },
-  {0x38, 0x8b, 0xd1, 0xbb, 0x0a, 0xf6, 0x9d, 0xd3, 0x70, 0x84, 0x10, 0xa2, 0x8b, 0x74, 0x64, 0xfc, 0x13, 0x5c, 0xe5, 0x00, 0xad, 0x5e, 0xc4, 0x1e, 0xe8, 0x8a, 0x69, 0xf6, 0x7c, 0x52, 0x30, 0xca },
-  {0xc2, 0x20, 0x5a, 0x4a, 0x72, 0x38, 0x21, 0xe5, 0xad, 0x31, 0x46, 0xce, 0xbd, 0x3e, 0x09, 0xa8, 0x7b, 0x2d, 0xc1, 0x72, 0x83, 0xf2, 0x0d, 0x7a, 0x99, 0xcb, 0x08, 0xb4, 0x91, 0xda, 0xae, 0x14 },
-  {0xfe, 0x9c, 0xed, 0x16, 0x90, 0xcb, 0x82, 0x57, 0x14, 0x94, 0x69, 0xf6, 0x1f, 0x58, 0xd6, 0xc5, 0x8e, 0x50, 0xf6, 0x21, 0xd0, 0x2e, 0xb7, 0x53, 0x3e, 0x27, 0x5b, 0xe3, 0x19, 0x3f, 0x66, 0xf8 },
-  
-  {0x67, 0xad, 0x7b, 0xdf, 0x2d, 0xa4, 0xbe, 0x42, 0xef, 0xb8, 0xde, 0x04, 0x7c, 0x98, 0xf1, 0x47, 0x1b, 0xb3, 0x68, 0x9d, 0x43, 0x92, 0x6c, 0xed, 0xa1, 0xbe, 0x72, 0x34, 0xa7, 0xec, 0x03, 0x88 },
-  {0x48, 0x01, 0x3f, 0xb5, 0x6a, 0xfb, 0x06, 0x64, 0x79, 0x25, 0x51, 0xa7, 0x36, 0xb5, 0x2a, 0x6e, 0xeb, 0x39, 0xd9, 0x12, 0x59, 0xe4, 0x08, 0xd4, 0x18, 0xfa, 0x86, 0xd0, 0x50, 0x78, 0x9f, 0xcb },
-  {0x8c, 0xc5, 0x26, 0xd3, 0x4e, 0x12, 0xe3, 0x8d, 0xd8, 0x3b, 0xc5, 0x87, 0x61, 0xe4, 0x0f, 0x83, 0x95, 0x05, 0xa5, 0xc6, 0x87, 0xb0, 0x36, 0x7e, 0x62, 0x48, 0x05, 0x95, 0x21, 0xbf, 0x2d, 0x5f },
-  {0x57, 0xf8, 0x99, 0x85, 0x5d, 0x9e, 0x33, 0xad, 0x1a, 0x99, 0xfd, 0x14, 0xd4, 0x49, 0xa2, 0xca, 0x5e, 0xe1, 0x76, 0x2a, 0xff, 0x4b, 0xc2, 0x23, 0xaa, 0xdd, 0xb5, 0xe8, 0x6b, 0xfd, 0x41, 0xad },
-  
-  {0xa3, 0x35, 0x6d, 0x1c, 0xed, 0xc6, 0x75, 0x49, 0xcd, 0x5a, 0x6d, 0x2f, 0xbc, 0x76, 0xf9, 0x25, 0x51, 0xb9, 0x41, 0x65, 0x1c, 0x9b, 0x71, 0xf4, 0x8d, 0x3d, 0x2f, 0x5a, 0x13, 0x83, 0xd8, 0x1a },
-  {0xe0, 0xbc, 0x06, 0xdb, 0x3d, 0xb8, 0x23, 0xf5, 0x82, 0x00, 0xb2, 0xe6, 0x8f, 0x08, 0x3c, 0xae, 0x18, 0xf3, 0x80, 0xcc, 0xe7, 0x01, 0x56, 0xce, 0x0e, 0x9d, 0x7a, 0xc8, 0xa8, 0x4b, 0x97, 0xb9 },
-  {0x12, 0x4c, 0xab, 0x7a, 0x8c, 0x55, 0x0b, 0x66, 0xde, 0xa0, 0x43, 0x21, 0x55, 0x9d, 0x66, 0xd9, 0x8b, 0x34, 0x0f, 0xab, 0x91, 0xbb, 0x2d, 0xeb, 0x69, 0x4f, 0xd7, 0xf3, 0x09, 0x2a, 0xe6, 0x65 },
-  {0x83, 0xe9, 0xc5, 0x2d, 0xf8, 0xa5, 0xd5, 0x92, 0x2c, 0xc0, 0x74, 0xf3, 0xcc, 0x80, 0xeb, 0xc2, 0x71, 0x99, 0xd5, 0x48, 0x5d, 0x38, 0x86, 0xa7, 0x15, 0xb8, 0x22, 0x8c, 0x6f, 0xc1, 0x38, 0x56 },
-  
-  {0x9a, 0x59, 0x21, 0x67, 0x47, 0x15, 0xb3, 0x3a, 0xef, 0x51, 0x0d, 0xa9, 0x34, 0x12, 0x46, 0x29, 0x03, 0x55, 0xe4, 0x21, 0x79, 0xfa, 0xda, 0x46, 0x76, 0xe3, 0x3a, 0x5e, 0xa1, 0xd4, 0x7c, 0xb1 },
-  {0x73, 0x09, 0x90, 0xce, 0xe3, 0x86, 0x71, 0x5d, 0x1c, 0xcf, 0x8b, 0x63, 0xb9, 0xdf, 0x5d, 0xa7, 0xfd, 0xb6, 0x6a, 0xc0, 0xa0, 0x07, 0x64, 0x26, 0xc5, 0x95, 0x03, 0xfe, 0x44, 0x19, 0xf0, 0x92 },
-  {0xc1, 0xb1, 0xfc, 0xa1, 0x35, 0x02, 0xc8, 0xe7, 0x9c, 0x7b, 0x40, 0xf7, 0x97, 0x1e, 0x89, 0xce, 0x7b, 0x3e, 0x2f, 0xf0, 0x14, 0xcf, 0xb4, 0x89, 0xed, 0x50, 0xad, 0x80, 0xbb, 0x0c, 0x6a, 0x2f },
-  {0x2a, 0x3e, 0x51, 0x18, 0x78, 0xb9, 0x49, 0x27, 0xab, 0x06, 0xd9, 0x2b, 0x71, 0x51, 0xed, 0x0d, 0x9e, 0x18, 0x91, 0x82, 0x53, 0x41, 0x98, 0x1b, 0x33, 0x6e, 0xcd, 0x2a, 0xde, 0x55, 0xa7, 0xea },
-  
-  {0x11, 0xdd, 0x82, 0x62, 0xd7, 0xf3, 0x90, 0x6b, 0xff, 0xbe, 0x4d, 0x15, 0xc5, 0xad, 0x33, 0x65, 0xdd, 0x4e, 0xca, 0xaf, 0xe9, 0x72, 0xdf, 0x5b, 0xf9, 0x0f, 0x9d, 0x61, 0x8f, 0xc7, 0x78, 0x1c },
-  {0xf4, 0x96, 0xc3, 0xaa, 0x21, 0x56, 0x3d, 0x10, 0x84, 0x5b, 0xe2, 0xa0, 0x83, 0xd3, 0x43, 0xb7, 0x74, 0xf4, 0x22, 0x63, 0x0b, 0x2b, 0xc2, 0xa7, 0x7e, 0xd5, 0x40, 0x1f, 0xf6, 0x34, 0x4d, 0xb0 },
-  {0xb5, 0x44, 0x06, 0x31, 0xe9, 0x9e, 0xb2, 0xd4, 0x2f, 0x94, 0x38, 0x67, 0x07, 0xfa, 0x24, 0x8b, 0x02, 0xbd, 0x37, 0xa3, 0xd4, 0x8d, 0x3b, 0x00, 0xbb, 0x4b, 0xe7, 0xb5, 0x05, 0x83, 0xef, 0x0e },
-  {0x8a, 0x2d, 0x6e, 0x9b, 0x50, 0xba, 0x32, 0x43, 0x76, 0xc2, 0x66, 0x49, 0x03, 0xeb, 0x5a, 0x0c, 0x6c, 0xae, 0x18, 0x2f, 0x91, 0x75, 0x5c, 0x83, 0x08, 0x54, 0x77, 0x3a, 0x82, 0xd4, 0x9f, 0x1f },
-};
+// Dither thresholds for the triangle fills, shared with the other applets.
+static const JaDitherMatrix<32>& DITHER_NOISE = JaDither::BLUE_NOISE_32X32;
 
+// Scratch rows for the dithered fills: the thresholds under a span and, for shaded spans, the
+// brightness level of each of its pixels.
+static uint8_t dither_thresholds[WIDTH];
+static uint8_t dither_levels[WIDTH];
 
-void fillDitheredTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
-     const Vec2i* v1, const Vec2i* v2, const Vec2i* v3, float brightness)
-{
-    // --- Initial Setup ---
+#if USE_DEPTH_BUFFER
+static JaDepthBuffer<WIDTH, HEIGHT> depth_buffer;
+#endif
+
+/**
+ * @brief The number types of the vertex path, so that it is written once for float and for
+ * Q16.16 fixed point. VertexMath<float> wraps math_3d.h and VertexMath<fix16> math_3d_fixed.h.
+ *
+ * The game state and the view-projection stay float; draw_mesh_instanced() converts what a
+ * batch shares once, and the instances come in the vertex path's own Instance type.
+ */
+template <typename Scalar>
+struct VertexMath;
+
+template <>
+struct VertexMath<float> {
+    typedef Vec2f Vec2;
+    typedef Vec3f Vec3;
+    typedef Vec4f Vec4;
+    typedef Mat4f Matrix;
+    typedef Affine3f Affine;
+    typedef InstanceTransform Instance;
+    typedef float Wide; // Big enough for products of screen positions
+    static constexpr float MAX = HUGE_VALF;
+
+    static constexpr float from_float(float f) { return f; }
+    static float from_quantized(int16_t q) { return q * (1.0f / 65536.0f); }
+    static float to_float(float f) { return f; }
+    static int to_int(float f) { return (int)f; }
+    static float mul(float a, float b) { return a * b; }
+    static float reciprocal(float f) { return 1.0f / f; }
+    static float abs(float f) { return fabsf(f); }
+
+    static Vec3f vec3(Vec3f v) { return v; }
+    static Vec4f vec4(Vec4f v) { return v; }
+    static Vec3f to_vec3f(Vec3f v) { return v; }
+    static Mat4f matrix(const Mat4f* m) { return *m; }
+    static Affine3f affine(const Affine3f* a) { return *a; }
+    static InstanceTransform instance(const InstanceTransform& i) { return i; }
+
+    static float dot(Vec3f a, Vec3f b) { return vec3_dot(a, b); }
+    static Vec3f scale(Vec3f v, float s) { return (Vec3f){v.x * s, v.y * s, v.z * s}; }
+    static Vec3f inverse_rotate(const Affine3f* a, Vec3f v) { return affine_inverse_rotate(a, v); }
+    static bool outside_frustum(const Vec4f* planes, Vec3f center, float radius) {
+        return sphere_outside_frustum(planes, center, radius);
+    }
+    static float projected_radius(const Mat4f* vp, Vec3f center, float radius, float pixels_per_unit) {
+        return sphere_projected_radius(vp, center, radius, pixels_per_unit);
+    }
+
+    // Model and model-view-projection matrices and bounding-sphere centers of up to
+    // MATH_3D_MAX_BATCH instances, built several at a time with the _batch functions.
+    struct Batch {
+        Affine3fBatch model, vertex;
+        Mat4fBatch mvp;
+        float center_x[MATH_3D_MAX_BATCH], center_y[MATH_3D_MAX_BATCH], center_z[MATH_3D_MAX_BATCH];
+    };
+    // `dequantize` (or NULL) is applied to the vertices before the model matrix.
+    static void build_batch(const InstanceTransform* instances, int count, const Mat4f* vp,
+                            const Affine3f* dequantize, Vec3f bounds_center, Batch* out) {
+        // The instances' placements, gathered into arrays for the batch functions.
+        static float positions_x[MATH_3D_MAX_BATCH], positions_y[MATH_3D_MAX_BATCH], positions_z[MATH_3D_MAX_BATCH];
+        static float rotations_x[MATH_3D_MAX_BATCH], rotations_y[MATH_3D_MAX_BATCH], rotations_z[MATH_3D_MAX_BATCH];
+        static float scales[MATH_3D_MAX_BATCH];
+        for (int i = 0; i < count; i++) {
+            positions_x[i] = instances[i].position.x;
+            positions_y[i] = instances[i].position.y;
+            positions_z[i] = instances[i].position.z;
+            rotations_x[i] = instances[i].rotation_x;
+            rotations_y[i] = instances[i].rotation_y;
+            rotations_z[i] = instances[i].rotation_z;
+            scales[i] = instances[i].scale;
+        }
+        affine_trs_euler_batch(positions_x, positions_y, positions_z, rotations_x, rotations_y, rotations_z, scales,
+                               count, &out->model);
+        if (dequantize) {
+            affine_multiply_batch(&out->model, dequantize, count, &out->vertex);
+        }
+        matrix_multiply_affine_batch(vp, dequantize ? &out->vertex : &out->model, count, &out->mvp);
+        affine_transform_point_batch(&out->model, bounds_center, count, out->center_x, out->center_y, out->center_z);
+    }
+    static Affine3f model(const Batch* b, int i) { return affine_from_batch(&b->model, i); }
+    static Mat4f mvp(const Batch* b, int i) { return matrix_from_batch(&b->mvp, i); }
+    static Vec3f center(const Batch* b, int i) { return (Vec3f){b->center_x[i], b->center_y[i], b->center_z[i]}; }
+
+    // Clip-space positions, unrounded screen positions, near / w and CLIP_* outcodes of a mesh's vertices.
+    static void project_vertices(const Mat4f* mvp, const float* xs, const float* ys, const float* zs, int count,
+                                 float* clip_x, float* clip_y, float* clip_z, float* clip_w,
+                                 float* screen_x, float* screen_y, float* depth, int* outcodes) {
+        static bool visible[MAX_MODEL_VERTICES];
+        project_points_subpixel(mvp, xs, ys, zs, count, WIDTH, HEIGHT, screen_x, screen_y, visible);
+        transform_points(mvp, xs, ys, zs, count, clip_x, clip_y, clip_z, clip_w);
+        for (int v = 0; v < count; v++) {
+            outcodes[v] = clip_outcode(clip_x[v], clip_y[v], clip_z[v], clip_w[v], GUARD_BAND);
+            depth[v] = CAMERA_NEAR / clip_w[v];
+        }
+    }
+    static int clip_triangle(const Vec4f* tri, int outcode_union, Vec4f* out) {
+        return ::clip_triangle(tri, outcode_union, GUARD_BAND, out);
+    }
+    static Vec2f clip_to_screen(const Vec4f* v, float* depth) {
+        *depth = CAMERA_NEAR / v->w;
+        return clip_to_screen_subpixel(v, WIDTH, HEIGHT);
+    }
+};
 
-    // Sort vertices by Y coordinate (p0.y <= p1.y <= p2.y) using pointers to avoid copies.
-    const Vec2i* p[3] = {v1, v2, v3};
-    if (p[0]->y > p[1]->y) std::swap(p[0], p[1]);
-    if (p[1]->y > p[2]->y) std::swap(p[1], p[2]);
-    if (p[0]->y > p[1]->y) std::swap(p[0], p[1]);
+template <>
+struct VertexMath<fix16> {
+    typedef Vec2x Vec2;
+    typedef Vec3x Vec3;
+    typedef Vec4x Vec4;
+    typedef Mat4x Matrix;
+    typedef Affine3x Affine;
+    typedef InstanceTransformX Instance;
+    typedef int64_t Wide;
+    static constexpr fix16 MAX = FIX16_MAX;
+
+    static constexpr fix16 from_float(float f) { return fix16_from_float(f); }
+    static fix16 from_quantized(int16_t q) { return q; } // mesh_dequantize_affine() scales by 1/65536
+    static float to_float(fix16 f) { return fix16_to_float(f); }
+    static int to_int(fix16 f) { return f >> FIX16_SHIFT; }
+    static fix16 mul(fix16 a, fix16 b) { return fix16_mul(a, b); }
+    static fix16 reciprocal(fix16 f) { return fix16_reciprocal(f); }
+    static fix16 abs(fix16 f) { return f < 0 ? -f : f; }
+
+    static Vec3x vec3(Vec3f v) { return vec3_to_fixed(v); }
+    static Vec4x vec4(Vec4f v) { return vec4_to_fixed(v); }
+    static Vec3f to_vec3f(Vec3x v) { return vec3_from_fixed(v); }
+    static Mat4x matrix(const Mat4f* m) { return matrix_to_fixed(m); }
+    static Affine3x affine(const Affine3f* a) { return affine_to_fixed(a); }
+    static InstanceTransformX instance(const InstanceTransform& i) {
+        return (InstanceTransformX){vec3_to_fixed(i.position), fix16_from_float(i.rotation_x),
+                                    fix16_from_float(i.rotation_y), fix16_from_float(i.rotation_z),
+                                    fix16_from_float(i.scale)};
+    }
 
-    const Vec2i& p0 = *p[0];
-    const Vec2i& p1 = *p[1];
-    const Vec2i& p2 = *p[2];
+    static fix16 dot(Vec3x a, Vec3x b) { return vec3_x_dot(a, b); }
+    static Vec3x scale(Vec3x v, fix16 s) { return (Vec3x){fix16_mul(v.x, s), fix16_mul(v.y, s), fix16_mul(v.z, s)}; }
+    static Vec3x inverse_rotate(const Affine3x* a, Vec3x v) { return affine_x_inverse_rotate(a, v); }
+    static bool outside_frustum(const Vec4x* planes, Vec3x center, fix16 radius) {
+        return sphere_x_outside_frustum(planes, center, radius);
+    }
+    static fix16 projected_radius(const Mat4x* vp, Vec3x center, fix16 radius, fix16 pixels_per_unit) {
+        return sphere_x_projected_radius(vp, center, radius, pixels_per_unit);
+    }
 
-    // Early exit if the triangle is completely outside the screen
-    if (p2.y < 0 || p0.y >= canvas.height) return;
-    if (std::max({p0.x, p1.x, p2.x}) < 0 || std::min({p0.x, p1.x, p2.x}) >= canvas.width) return;
+    struct Batch {
+        Affine3x model[MATH_3D_MAX_BATCH];
+        Mat4x mvp[MATH_3D_MAX_BATCH];
+        Vec3x center[MATH_3D_MAX_BATCH];
+    };
+    static void build_batch(const InstanceTransformX* instances, int count, const Mat4x* vp,
+                            const Affine3x* dequantize, Vec3x bounds_center, Batch* out) {
+        for (int i = 0; i < count; i++) {
+            const InstanceTransformX& instance = instances[i];
+            out->model[i] = affine_x_trs_euler(instance.position, instance.rotation_x, instance.rotation_y,
+                                               instance.rotation_z, instance.scale);
+            const Affine3x vertex = dequantize ? affine_x_multiply(&out->model[i], dequantize) : out->model[i];
+            out->mvp[i] = matrix_x_multiply_affine(vp, &vertex);
+            out->center[i] = affine_x_transform_point(&out->model[i], bounds_center);
+        }
+    }
+    static Affine3x model(const Batch* b, int i) { return b->model[i]; }
+    static Mat4x mvp(const Batch* b, int i) { return b->mvp[i]; }
+    static Vec3x center(const Batch* b, int i) { return b->center[i]; }
+
+    static void project_vertices(const Mat4x* mvp, const fix16* xs, const fix16* ys, const fix16* zs, int count,
+                                 fix16* clip_x, fix16* clip_y, fix16* clip_z, fix16* clip_w,
+                                 fix16* screen_x, fix16* screen_y, fix16* depth, int* outcodes) {
+        static bool visible[MAX_MODEL_VERTICES];
+        static fix16 inv_w[MAX_MODEL_VERTICES];
+        project_points_subpixel_x(mvp, xs, ys, zs, count, WIDTH, HEIGHT, screen_x, screen_y, visible, inv_w);
+        transform_points_x(mvp, xs, ys, zs, count, clip_x, clip_y, clip_z, clip_w);
+        for (int v = 0; v < count; v++) {
+            outcodes[v] = clip_outcode_x(clip_x[v], clip_y[v], clip_z[v], clip_w[v], (int)GUARD_BAND);
+            depth[v] = fix16_mul(from_float(CAMERA_NEAR), inv_w[v]);
+        }
+    }
+    static int clip_triangle(const Vec4x* tri, int outcode_union, Vec4x* out) {
+        return clip_triangle_x(tri, outcode_union, (int)GUARD_BAND, out);
+    }
+    static Vec2x clip_to_screen(const Vec4x* v, fix16* depth) {
+        fix16 inv_w;
+        const Vec2x screen = clip_to_screen_subpixel_x(v, WIDTH, HEIGHT, &inv_w);
+        *depth = fix16_mul(from_float(CAMERA_NEAR), inv_w);
+        return screen;
+    }
+};
 
-    // --- Fixed-Point Setup ---
+// Number type of the vertex path.
+#if USE_FIXED_POINT
+typedef fix16 VertexScalar;
+#else
+typedef float VertexScalar;
+#endif
 
-    // This is the ONLY floating-point operation, performed once per triangle.
-    // It converts the 0.0-1.0 brightness into a 0-255 integer threshold.
-    int32_t brightness_level = static_cast<int32_t>(brightness * 255.0f);
+// Positions, brightness and depth are float or fix16, see VertexMath.
+// `depth` holds the three vertices' depths (near / w) for the depth test, or is NULL to draw over everything.
+template <typename Scalar>
+void fillDitheredTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
+     const typename VertexMath<Scalar>::Vec2* v1, const typename VertexMath<Scalar>::Vec2* v2,
+     const typename VertexMath<Scalar>::Vec2* v3, Scalar brightness, [[maybe_unused]] const Scalar* depth = NULL)
+{
+    // The only per-triangle conversion: the 0-1 brightness into a 0-255 integer threshold.
+    uint8_t brightness_level = JaDither::clampLevel(VertexMath<Scalar>::to_int(brightness * 255));
 
     // use the noise itself as a source of random position to offset it by
     //uint32_t offsetX = (millis / 3) & 63;
     //uint32_t offsetY = (millis / 11) & 63;
-    uint32_t offsetX = BLUE_NOISE[(millis / 15) & 31][(millis / 15) & 31];
-    uint32_t offsetY = BLUE_NOISE[((millis / 15) + 1) & 31][((millis / 15) + 1) & 31];
-
-    // We'll use 16.16 fixed-point precision. (16 bits for integer, 16 for fraction)
-    const int FIXED_POINT_SHIFT = 16;
-
-    // --- Rasterize Top Half of Triangle ---
-    int32_t height01 = p1.y - p0.y;
-    if (height01 > 0) {
-        int32_t height02 = p2.y - p0.y;
-        // Calculate slopes (dx/dy) using fixed-point math
-        int32_t slope1 = ((p1.x - p0.x) << FIXED_POINT_SHIFT) / height01;
-        int32_t slope2 = ((p2.x - p0.x) << FIXED_POINT_SHIFT) / height02;
-
-        int32_t x1 = p0.x << FIXED_POINT_SHIFT;
-        int32_t x2 = p0.x << FIXED_POINT_SHIFT;
-
-        for (int y = p0.y; y < p1.y; ++y) {
-            // Only draw scanlines that are on-screen
-            if (y >= 0 && y < canvas.height) {
-                int startX = x1 >> FIXED_POINT_SHIFT;
-                int endX   = x2 >> FIXED_POINT_SHIFT;
-                if (startX > endX) std::swap(startX, endX);
-                
-                // Clip and draw the horizontal line
-                for (int x = std::max(0, startX); x < std::min(canvas.width, endX); ++x) {
-                    uint32_t threshold = BLUE_NOISE[(y + offsetY) & 31][(x + offsetX) & 31];
-                    if (brightness_level > threshold) {
-                        canvas.drawPixel(x, y, Colors::White);
-                    } else {
-                        canvas.drawPixel(x, y, Colors::Black);
-                    }
-                }
-            }
-            // Increment x positions by their slopes for the next line
-            x1 += slope1;
-            x2 += slope2;
-        }
-    }
-
-    // --- Rasterize Bottom Half of Triangle ---
-    int32_t height12 = p2.y - p1.y;
-    if (height12 > 0) {
-        int32_t height02 = p2.y - p0.y;
-        // Calculate slopes. The long edge's slope (p0-p2) is the same.
-        int32_t slope1 = ((p2.x - p1.x) << FIXED_POINT_SHIFT) / height12;
-        int32_t slope2 = ((p2.x - p0.x) << FIXED_POINT_SHIFT) / height02;
-
-        // Start x positions at the middle vertex and the corresponding point on the long edge
-        int32_t x1 = p1.x << FIXED_POINT_SHIFT;
-        int32_t x2 = (p0.x << FIXED_POINT_SHIFT) + slope2 * height01;
-
-        for (int y = p1.y; y <= p2.y; ++y) {
-            if (y >= 0 && y < canvas.height) {
-                int startX = x1 >> FIXED_POINT_SHIFT;
-                int endX   = x2 >> FIXED_POINT_SHIFT;
-                if (startX > endX) std::swap(startX, endX);
-
-                for (int x = std::max(0, startX); x < std::min(canvas.width, endX); ++x) {
-                    uint32_t threshold = BLUE_NOISE[(y + offsetY) & 31][(x + offsetX) & 31];
-                    if (brightness_level > threshold) {
-                        canvas.drawPixel(x, y, Colors::White);
-                    } else {
-                        canvas.drawPixel(x, y, Colors::Black);
-                    }
-                }
-            }
-            x1 += slope1;
-            x2 += slope2;
+    int offsetX = DITHER_NOISE.at((int)(millis / 15), (int)(millis / 15));
+    int offsetY = DITHER_NOISE.at((int)(millis / 15) + 1, (int)(millis / 15) + 1);
+
+    auto shader = [&](const JaRasterSpan<>& span) {
+        const int count = span.x_end - span.x_begin;
+        DITHER_NOISE.tileRow(span.x_begin + offsetX, span.y + offsetY, count, dither_thresholds);
+        JaDither::thresholdSpan(span.pixels + span.x_begin, count, brightness_level, dither_thresholds,
+                                Colors::White, Colors::Black);
+    };
+
+#if USE_DEPTH_BUFFER
+    if (depth) {
+        const JaRasterVertex<0, Scalar> a = {v1->x, v1->y, depth[0]};
+        const JaRasterVertex<0, Scalar> b = {v2->x, v2->y, depth[1]};
+        const JaRasterVertex<0, Scalar> c = {v3->x, v3->y, depth[2]};
+        canvas.rasterizeTriangle(a, b, c, depth_buffer, shader);
+        return;
+    }
+#endif
+    const JaRasterVertex<0, Scalar> a = {v1->x, v1->y};
+    const JaRasterVertex<0, Scalar> b = {v2->x, v2->y};
+    const JaRasterVertex<0, Scalar> c = {v3->x, v3->y};
+    canvas.rasterizeTriangle(a, b, c, shader);
+}
+
+// Same as fillDitheredTriangle, but with a brightness per vertex blended across the triangle (Gouraud shading).
+template <typename Scalar>
+void fillShadedTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
+     const typename VertexMath<Scalar>::Vec2* v1, const typename VertexMath<Scalar>::Vec2* v2,
+     const typename VertexMath<Scalar>::Vec2* v3, const Scalar* brightness, const Scalar* depth = NULL)
+{
+    int offsetX = DITHER_NOISE.at((int)(millis / 15), (int)(millis / 15));
+    int offsetY = DITHER_NOISE.at((int)(millis / 15) + 1, (int)(millis / 15) + 1);
+
+    auto shader = [&](const JaRasterSpan<1>& span) {
+        const int count = span.x_end - span.x_begin;
+        // The 0-255 brightness level in 16.16 fixed point, so each pixel only costs an add.
+        int32_t level = static_cast<int32_t>(span.attributes[0] * (255.0f * 65536.0f));
+        const int32_t level_step = static_cast<int32_t>(span.step[0] * (255.0f * 65536.0f));
+        for (int i = 0; i < count; ++i, level += level_step) {
+            dither_levels[i] = JaDither::clampLevel(level >> 16);
         }
+        DITHER_NOISE.tileRow(span.x_begin + offsetX, span.y + offsetY, count, dither_thresholds);
+        JaDither::thresholdSpan(span.pixels + span.x_begin, count, dither_levels, 0, dither_thresholds,
+                                Colors::White, Colors::Black);
+    };
+
+    const Scalar no_depth[3] = {};
+    const Scalar* d = depth ? depth : no_depth;
+    const JaRasterVertex<1, Scalar> a = {v1->x, v1->y, d[0], {brightness[0]}};
+    const JaRasterVertex<1, Scalar> b = {v2->x, v2->y, d[1], {brightness[1]}};
+    const JaRasterVertex<1, Scalar> c = {v3->x, v3->y, d[2], {brightness[2]}};
+#if USE_DEPTH_BUFFER
+    if (depth) {
+        canvas.rasterizeTriangle(a, b, c, depth_buffer, shader);
+        return;
     }
+#endif
+    canvas.rasterizeTriangle(a, b, c, shader);
 }
-static void draw_3d_model(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis, const Mat4f* vp_matrix,
-                          const Vec3f* vertices, const int* indices, int num_indices,
-                          Vec3f position, float rotation_x_rad, float rotation_y_rad, float rotation_z_rad, float scale,
-                          const Vec3f* world_light_dir)
+// Same as fillShadedTriangle, with the brightness multiplied by `texture`'s green channel.
+// `uv` holds the three corners' (u, v) in texture widths/heights. The texture is mapped
+// perspective-correctly, so `depth` (near / w) is always needed, depth buffer or not.
+template <typename Scalar>
+void fillTexturedTriangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
+     const typename VertexMath<Scalar>::Vec2* v1, const typename VertexMath<Scalar>::Vec2* v2,
+     const typename VertexMath<Scalar>::Vec2* v3, const Scalar* brightness, const Scalar* depth,
+     const JaTexture& texture, const Scalar* uv)
+{
+    if (texture.isEmpty()) return;
+
+    int offsetX = DITHER_NOISE.at((int)(millis / 15), (int)(millis / 15));
+    int offsetY = DITHER_NOISE.at((int)(millis / 15) + 1, (int)(millis / 15) + 1);
+
+    auto shader = [&](const JaRasterSpan<3>& span) {
+        const int count = span.x_end - span.x_begin;
+        int32_t level = static_cast<int32_t>(span.attributes[0] * (255.0f * 65536.0f));
+        const int32_t level_step = static_cast<int32_t>(span.step[0] * (255.0f * 65536.0f));
+        texture.forEachTexel(span, 1, [&](int x, uint32_t color) {
+            dither_levels[x - span.x_begin] = JaDither::clampLevel(((level >> 16) * (int32_t)JADRAW_GREEN(color)) >> 8);
+            level += level_step;
+        });
+        DITHER_NOISE.tileRow(span.x_begin + offsetX, span.y + offsetY, count, dither_thresholds);
+        JaDither::thresholdSpan(span.pixels + span.x_begin, count, dither_levels, 0, dither_thresholds,
+                                Colors::White, Colors::Black);
+    };
+
+    const int tw = texture.getWidth();
+    const int th = texture.getHeight();
+    const JaRasterVertex<3, Scalar> a = {v1->x, v1->y, depth[0], {brightness[0], uv[0] * tw, uv[1] * th}};
+    const JaRasterVertex<3, Scalar> b = {v2->x, v2->y, depth[1], {brightness[1], uv[2] * tw, uv[3] * th}};
+    const JaRasterVertex<3, Scalar> c = {v3->x, v3->y, depth[2], {brightness[2], uv[4] * tw, uv[5] * th}};
+#if USE_DEPTH_BUFFER
+    canvas.rasterizeTrianglePerspective(a, b, c, depth_buffer, shader);
+#else
+    canvas.rasterizeTrianglePerspective(a, b, c, shader);
+#endif
+}
+
+/**
+ * @brief The mesh being drawn, converted to the vertex path's number type: positions as separate
+ * x, y and z arrays for the batch transform functions, and normals and UVs ready for lighting.
+ * Filled by load_mesh().
+ *
+ * The face normals of the mesh and then of each of its levels of detail follow each other, level
+ * `l` starting at first_triangle[l]. The levels share the mesh's vertices and vertex normals.
+ */
+template <typename Scalar>
+struct LoadedMesh {
+    const Mesh* levels[MAX_BATCH_LODS + 1]; // The mesh, then its LODs
+    int num_levels;
+    Scalar x[MAX_MODEL_VERTICES], y[MAX_MODEL_VERTICES], z[MAX_MODEL_VERTICES];
+    typename VertexMath<Scalar>::Vec3 vertex_normals[MAX_MODEL_VERTICES];
+    typename VertexMath<Scalar>::Vec3 face_normals[MAX_MODEL_TRIANGLES];
+    int first_triangle[MAX_BATCH_LODS + 1];
+    Scalar uvs[MAX_MODEL_TRIANGLES * 6]; // The full mesh's, if it has any
+};
+
+// Quantized meshes are loaded as stored, with the dequantization left to the model matrix
+// (see mesh_dequantize_affine()).
+template <typename Scalar>
+static bool load_mesh(const Mesh* mesh, LoadedMesh<Scalar>* out)
+{
+    typedef VertexMath<Scalar> Math;
+    out->num_levels = 1 + (mesh->num_lods < MAX_BATCH_LODS ? mesh->num_lods : MAX_BATCH_LODS);
+    int num_triangles = 0;
+    for (int l = 0; l < out->num_levels; l++) {
+        out->levels[l] = l == 0 ? mesh : &mesh->lods[l - 1];
+        out->first_triangle[l] = num_triangles;
+        num_triangles += out->levels[l]->num_indices / 3;
+    }
+    if (mesh->num_vertices > MAX_MODEL_VERTICES || num_triangles > MAX_MODEL_TRIANGLES) {
+        return false; // Raise MAX_MODEL_VERTICES or MAX_MODEL_TRIANGLES for bigger models
+    }
+
+    if (mesh_is_quantized(mesh)) {
+        const int16_t* q = mesh->quantized_vertices;
+        for (int v = 0; v < mesh->num_vertices; v++, q += 3) {
+            out->x[v] = Math::from_quantized(q[0]);
+            out->y[v] = Math::from_quantized(q[1]);
+            out->z[v] = Math::from_quantized(q[2]);
+        }
+    } else {
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            out->x[v] = Math::from_float(mesh->vertices[v].x);
+            out->y[v] = Math::from_float(mesh->vertices[v].y);
+            out->z[v] = Math::from_float(mesh->vertices[v].z);
+        }
+    }
+    if (mesh_has_vertex_normals(mesh)) {
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            out->vertex_normals[v] = Math::vec3(mesh_vertex_normal(mesh, v));
+        }
+    }
+    for (int l = 0; l < out->num_levels; l++) {
+        const Mesh* level = out->levels[l];
+        for (int t = 0; t < level->num_indices / 3; t++) {
+            out->face_normals[out->first_triangle[l] + t] = Math::vec3(mesh_face_normal(level, t));
+        }
+    }
+    if (mesh->uvs) {
+        for (int i = 0; i < mesh->num_indices * 2; i++) {
+            out->uvs[i] = Math::from_float(mesh->uvs[i]);
+        }
+    }
+    return true;
+}
+
+// A triangle after setup: projected, clipped, culled and lit, ready for the rasterizer.
+template <typename Scalar>
+struct ProjectedTriangle {
+    typename VertexMath<Scalar>::Vec2 screen[3]; // Unrounded, see project_points_subpixel()
+    Scalar depth[3];      // near / w
+    Scalar brightness[3]; // Per corner, or the same for all three when flat-shaded
+    Scalar uv[6];         // Per corner, for textured triangles
+    bool textured;
+    bool shaded;          // Blend the corner brightnesses (Gouraud)
+};
+
+/**
+ * @brief The triangles of one model as last drawn, so they can be rasterized again without
+ * redoing the setup while nothing that affects them has changed. See draw_3d_model().
+ *
+ * Keyed on everything setup depends on: the mesh, its placement, the view-projection, the light
+ * and the texture. Each one is about 2.5 KB, so give them only to models that often stand still.
+ */
+template <typename Scalar>
+struct ProjectedMeshCache {
+    bool valid;
+    const Mesh* mesh;
+    InstanceTransform instance;
+    Mat4f vp_matrix;
+    Vec3f light_dir; // World space
+    const JaTexture* texture;
+    int num_triangles;
+    ProjectedTriangle<Scalar> triangles[MAX_CACHED_TRIANGLES];
+};
+
+// Whether `count` floats all differ by at most PROJECTED_CACHE_TOLERANCE.
+static bool floats_nearly_equal(const float* a, const float* b, int count)
 {
-    // 1. Create Model and MVP Matrices (same as before)
-    Mat4f scale_mat = matrix_scale((Vec3f){scale, scale, scale});
-    Mat4f rot_mat = matrix_multiply(
-        matrix_multiply( // order matters
-            matrix_rotate_y(rotation_y_rad),
-            matrix_rotate_x(rotation_x_rad)),
-        matrix_rotate_z(rotation_z_rad)
-    );
-    Mat4f trans_mat = matrix_translate(position);
-    Mat4f model_matrix = matrix_multiply(trans_mat, matrix_multiply(rot_mat, scale_mat));
-    Mat4f mvp_matrix = matrix_multiply(*vp_matrix, model_matrix);
-
-    const float AMBIENT_LIGHT = 0.0f;
-    const float DIFFUSE_STRENGTH = 1.5f;
-
-    // 2. Process and draw each triangle
+    for (int i = 0; i < count; i++) {
+        if (fabsf(a[i] - b[i]) > PROJECTED_CACHE_TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Scalar>
+static bool projected_cache_matches(const ProjectedMeshCache<Scalar>* cache, const Mesh* mesh,
+                                    const InstanceTransform* instance, const Mat4f* vp_matrix, const Vec3f* light_dir,
+                                    const JaTexture* texture)
+{
+    // Compared with a tolerance, so a model still easing to a stop (like the ship) hits the cache
+    // once it no longer moves visibly. Drift is measured from the recorded values, so it can't
+    // build up past the tolerance unnoticed.
+    const InstanceTransform* c = &cache->instance;
+    const float cached[10] = {c->position.x, c->position.y, c->position.z, c->rotation_x, c->rotation_y, c->rotation_z,
+                              c->scale, cache->light_dir.x, cache->light_dir.y, cache->light_dir.z};
+    const float current[10] = {instance->position.x, instance->position.y, instance->position.z, instance->rotation_x,
+                               instance->rotation_y, instance->rotation_z, instance->scale,
+                               light_dir->x, light_dir->y, light_dir->z};
+    return cache->valid && cache->mesh == mesh && cache->texture == texture &&
+           floats_nearly_equal(cached, current, 10) &&
+           floats_nearly_equal(&cache->vp_matrix.m[0][0], &vp_matrix->m[0][0], 16);
+}
+
+template <typename Scalar>
+static void draw_projected_triangle(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis,
+                                    const ProjectedTriangle<Scalar>* t, const JaTexture* texture)
+{
+    if (t->textured) {
+        fillTexturedTriangle(canvas, millis, &t->screen[0], &t->screen[1], &t->screen[2], t->brightness, t->depth,
+                             *texture, t->uv);
+    } else if (t->shaded) {
+        fillShadedTriangle(canvas, millis, &t->screen[0], &t->screen[1], &t->screen[2], t->brightness, t->depth);
+    } else {
+        fillDitheredTriangle(canvas, millis, &t->screen[0], &t->screen[1], &t->screen[2], t->brightness[0], t->depth);
+    }
+}
+
+// Triangles set up by draw_mesh_transformed(), rasterized in one go by draw_queued_triangles().
+template <typename Scalar>
+static ProjectedTriangle<Scalar> queued_triangles[MAX_QUEUED_TRIANGLES];
+template <typename Scalar>
+static int num_queued_triangles = 0;
+
+template <typename Scalar>
+static void draw_queued_triangles(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis, const JaTexture* texture)
+{
+    for (int i = 0; i < num_queued_triangles<Scalar>; i++) {
+        draw_projected_triangle(canvas, millis, &queued_triangles<Scalar>[i], texture);
+    }
+    num_queued_triangles<Scalar> = 0;
+}
+
+/**
+ * @brief Sets up the triangles of one level of a mesh loaded with load_mesh() and queues them for
+ * draw_queued_triangles(). Only draws them right away if the queue is full.
+ *
+ * @param level 0 for the mesh itself, l for its LOD l - 1.
+ * @param mvp_matrix The combined Model-View-Projection matrix.
+ * @param light_dir Normalized light direction in the mesh's model space.
+ * @param texture Texture for meshes with UVs, or NULL to draw them untextured.
+ * @param record If not NULL, the triangles are also added to it. It is invalidated if they
+ *               don't fit.
+ */
+template <typename Scalar>
+static void draw_mesh_transformed(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis, const LoadedMesh<Scalar>* loaded,
+                                  int level, const typename VertexMath<Scalar>::Matrix* mvp_matrix,
+                                  typename VertexMath<Scalar>::Vec3 light_dir, const JaTexture* texture = NULL,
+                                  ProjectedMeshCache<Scalar>* record = NULL)
+{
+    typedef VertexMath<Scalar> Math;
+    typedef typename Math::Vec2 Vec2;
+    typedef typename Math::Vec4 Vec4;
+    typedef typename Math::Wide Wide;
+
+    constexpr Scalar AMBIENT_LIGHT = Math::from_float(0.0f);
+    constexpr Scalar DIFFUSE_STRENGTH = Math::from_float(1.5f);
+    constexpr Scalar FULL_BRIGHTNESS = Math::from_float(1.0f);
+    auto shade = [&](typename Math::Vec3 normal) {
+        Scalar diffuse_intensity = Math::dot(normal, light_dir);
+        Scalar brightness = AMBIENT_LIGHT;
+        if (diffuse_intensity > 0) {
+            brightness += Math::mul(diffuse_intensity, DIFFUSE_STRENGTH);
+        }
+        return brightness > FULL_BRIGHTNESS ? FULL_BRIGHTNESS : brightness;
+    };
+    auto emit = [&](const ProjectedTriangle<Scalar>& t) {
+        if (num_queued_triangles<Scalar> == MAX_QUEUED_TRIANGLES) {
+            draw_queued_triangles<Scalar>(canvas, millis, texture);
+        }
+        queued_triangles<Scalar>[num_queued_triangles<Scalar>++] = t;
+        if (record && record->valid) {
+            if (record->num_triangles < MAX_CACHED_TRIANGLES) {
+                record->triangles[record->num_triangles++] = t;
+            } else {
+                record->valid = false;
+            }
+        }
+    };
+
+    const Mesh* mesh = loaded->levels[level];
+    const typename Math::Vec3* face_normals = &loaded->face_normals[loaded->first_triangle[level]];
+    const int num_vertices = mesh->num_vertices;
+    const int num_indices = mesh->num_indices;
+
+    // Transform every vertex once. Triangles share most of their corners, so doing this
+    // per vertex instead of per triangle corner saves most of the matrix work.
+    static Scalar clip_x[MAX_MODEL_VERTICES], clip_y[MAX_MODEL_VERTICES], clip_z[MAX_MODEL_VERTICES], clip_w[MAX_MODEL_VERTICES];
+    static int outcodes[MAX_MODEL_VERTICES];
+    static Scalar screen_x[MAX_MODEL_VERTICES], screen_y[MAX_MODEL_VERTICES];
+    static Scalar depth[MAX_MODEL_VERTICES]; // near / w: 1 at the near plane, towards 0 far away
+    Math::project_vertices(mvp_matrix, loaded->x, loaded->y, loaded->z, num_vertices, clip_x, clip_y, clip_z, clip_w,
+                           screen_x, screen_y, depth, outcodes);
+
+    // Smooth-shaded meshes are lit once per vertex.
+    static Scalar vertex_brightness[MAX_MODEL_VERTICES];
+    const bool smooth = mesh_has_vertex_normals(mesh);
+    const bool textured = texture != NULL && !texture->isEmpty() && level == 0 && mesh->uvs != NULL;
+    if (smooth) {
+        for (int v = 0; v < num_vertices; v++) {
+            vertex_brightness[v] = shade(loaded->vertex_normals[v]);
+        }
+    }
+
+    // Assemble and draw each triangle from the transformed vertices
     for (int i = 0; i < num_indices; i += 3) {
-        const Vec3f* v_model[3];
-        v_model[0] = &vertices[indices[i]];
-        v_model[1] = &vertices[indices[i+1]];
-        v_model[2] = &vertices[indices[i+2]];
-
-        // --- Projection ---
-        // Project all three vertices first.
-        Vec2i v_screen[3];
-        bool p1_visible = project_vertex(v_model[0], &mvp_matrix, &v_screen[0], WIDTH, HEIGHT);
-        bool p2_visible = project_vertex(v_model[1], &mvp_matrix, &v_screen[1], WIDTH, HEIGHT);
-        bool p3_visible = project_vertex(v_model[2], &mvp_matrix, &v_screen[2], WIDTH, HEIGHT);
-
-        // If all three vertices are behind the camera, skip the whole triangle.
-        // This is a simple but effective form of clipping.
-        if (!p1_visible && !p2_visible && !p3_visible) {
+        const int i0 = mesh_index(mesh, i);
+        const int i1 = mesh_index(mesh, i+1);
+        const int i2 = mesh_index(mesh, i+2);
+
+        // Skip triangles that lie entirely outside one side of the view volume,
+        // before doing any setup work for them.
+        const int outcode_union = outcodes[i0] | outcodes[i1] | outcodes[i2];
+        if (outcodes[i0] & outcodes[i1] & outcodes[i2] & CLIP_OUTSIDE_VIEW) {
             continue;
         }
-        // A more robust check would be if ANY vertex is valid, but this is often good enough.
-        // if (!p1_visible && !p2_visible && !p3_visible) continue;
-        // Or even better, if all are invalid
-        // if (!(p1_visible || p2_visible || p3_visible)) continue;
 
+        // Screen-space polygon to draw. Usually just the triangle itself, but clipping against
+        // the near plane or the guard band can turn it into a polygon of up to CLIP_MAX_VERTICES.
+        Vec2 v_screen[CLIP_MAX_VERTICES];
+        Scalar v_depth[CLIP_MAX_VERTICES];
+        int num_screen = 3;
+        if (!(outcode_union & (CLIP_NEAR | CLIP_GUARD))) {
+            v_screen[0] = Vec2{screen_x[i0], screen_y[i0]};
+            v_screen[1] = Vec2{screen_x[i1], screen_y[i1]};
+            v_screen[2] = Vec2{screen_x[i2], screen_y[i2]};
+            v_depth[0] = depth[i0];
+            v_depth[1] = depth[i1];
+            v_depth[2] = depth[i2];
+        } else {
+            Vec4 tri[3];
+            const int corners[3] = {i0, i1, i2};
+            for (int v = 0; v < 3; v++) {
+                const int c = corners[v];
+                tri[v] = Vec4{clip_x[c], clip_y[c], clip_z[c], clip_w[c]};
+            }
+            Vec4 clipped[CLIP_MAX_VERTICES];
+            num_screen = Math::clip_triangle(tri, outcode_union, clipped);
+            if (num_screen < 3) {
+                continue;
+            }
+            for (int v = 0; v < num_screen; v++) {
+                v_screen[v] = Math::clip_to_screen(&clipped[v], &v_depth[v]);
+            }
+        }
 
         // --- Back-face Culling ---
         // Use screen-space winding order. This is fast and effective.
-        int cross_product_z = (v_screen[1].x - v_screen[0].x) * (v_screen[2].y - v_screen[0].y) -
-                              (v_screen[1].y - v_screen[0].y) * (v_screen[2].x - v_screen[0].x);
+        // For clipped polygons this is twice their signed area, which has the same sign.
+        Wide cross_product_z = 0;
+        for (int v = 1; v + 1 < num_screen; v++) {
+            cross_product_z += (Wide)(v_screen[v].x - v_screen[0].x) * (v_screen[v+1].y - v_screen[0].y) -
+                               (Wide)(v_screen[v].y - v_screen[0].y) * (v_screen[v+1].x - v_screen[0].x);
+        }
 
         if (cross_product_z < 0) { // If triangle is facing the camera
-            // --- Lighting Calculation (in World Space) ---
-            // We do this *after* culling, because it's wasted computation on a triangle we won't draw.
-            Vec3f v_world[3];
-            v_world[0] = transform_vertex(v_model[0], &model_matrix);
-            v_world[1] = transform_vertex(v_model[1], &model_matrix);
-            v_world[2] = transform_vertex(v_model[2], &model_matrix);
-
-            Vec3f edge1 = vec3_subtract(v_world[1], v_world[0]);
-            Vec3f edge2 = vec3_subtract(v_world[2], v_world[0]);
-            Vec3f face_normal = vec3_normalize(vec3_cross(edge1, edge2));
-
-            float diffuse_intensity = vec3_dot(face_normal, *world_light_dir);
-
-            // Final brightness calculation
-            float brightness = AMBIENT_LIGHT;
-            if (diffuse_intensity > 0) {
-                brightness += diffuse_intensity * DIFFUSE_STRENGTH;
+            // --- Drawing ---
+            ProjectedTriangle<Scalar> t;
+            t.textured = false;
+            t.shaded = false;
+            if ((textured || smooth) && num_screen == 3 && !(outcode_union & (CLIP_NEAR | CLIP_GUARD))) {
+                for (int v = 0; v < 3; v++) {
+                    t.screen[v] = v_screen[v];
+                    t.depth[v] = v_depth[v];
+                }
+                if (smooth) {
+                    t.brightness[0] = vertex_brightness[i0];
+                    t.brightness[1] = vertex_brightness[i1];
+                    t.brightness[2] = vertex_brightness[i2];
+                    t.shaded = true;
+                } else {
+                    t.brightness[0] = t.brightness[1] = t.brightness[2] = shade(face_normals[i / 3]);
+                }
+                if (textured) {
+                    for (int k = 0; k < 6; k++) {
+                        t.uv[k] = loaded->uvs[i * 2 + k];
+                    }
+                    t.textured = true;
+                }
+                emit(t);
+                continue;
             }
-            if (brightness > 1.0f) brightness = 1.0f;
 
-            // --- Drawing ---
+            // --- Lighting Calculation (in Model Space) ---
+            // Flat, also for clipped smooth-shaded or textured triangles, which are rare enough to not
+            // be worth carrying vertex attributes through the clipper.
+            t.brightness[0] = t.brightness[1] = t.brightness[2] = shade(face_normals[i / 3]);
+
             // The rasterizer will handle clipping the triangle to the screen bounds.
-            fillDitheredTriangle(canvas, millis, &v_screen[0], &v_screen[1], &v_screen[2], brightness);
+            // Clipped polygons are convex, so they are drawn as a fan.
+            for (int v = 1; v + 1 < num_screen; v++) {
+                const int fan[3] = {0, v, v + 1};
+                for (int c = 0; c < 3; c++) {
+                    t.screen[c] = v_screen[fan[c]];
+                    t.depth[c] = v_depth[fan[c]];
+                }
+                emit(t);
+            }
         }
     }
 }
 /**
- * @brief Draws a point in 3D space with a specified size that respects perspective.
+ * @brief Draws many copies of one mesh, e.g. all the asteroids.
  *
- * @param canvas The canvas to draw on.
- * @param vp_matrix The combined View-Projection matrix.
- * @param world_position The position of the point in world space.
- * @param size The desired radius of the point in world space units.
+ * The mesh is loaded and the view volume worked out once for the whole batch, and the model
+ * matrices are built together, several at a time. Each instance then only costs a bounding-sphere
+ * test, plus setting up its triangles if it turns out to be visible. Far-off instances use the
+ * mesh's levels of detail (which share its vertices, so they need no reloading), or just a dot.
+ * The dots and then the triangles of all the instances are drawn at the end.
+ *
+ * Everything per instance is done in `Scalar`; only what the batch shares is converted from float.
+ *
+ * @param world_light_dir Normalized light direction in world space.
+ * @param record Passed on to draw_mesh_transformed(), for a single instance.
  */
-static void draw_3d_point(JaDraw<WIDTH, HEIGHT>& canvas, const Mat4f* vp_matrix,
-                          Vec3f world_position, float size)
+template <typename Scalar>
+static void draw_mesh_instanced(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis, const Mat4f* vp_matrix,
+                                const Mesh* mesh, std::span<const typename VertexMath<Scalar>::Instance> instances,
+                                const Vec3f* world_light_dir, const JaTexture* texture = NULL,
+                                ProjectedMeshCache<Scalar>* record = NULL)
 {
-    // A point needs a center and an edge to define its size in the world.
-    // We create a second point offset by `size` along the Y-axis.
-    Vec3f center_world = world_position;
-    Vec3f edge_world   = {world_position.x, world_position.y + size, world_position.z};
-
-    // 1. Project the center of the point to find its screen position.
-    Vec2i screen_pos;
-    if (!project_vertex(&center_world, vp_matrix, &screen_pos, WIDTH, HEIGHT)) {
-        // If the center isn't on screen (or is behind the camera), we can't draw it.
+    typedef VertexMath<Scalar> Math;
+    static LoadedMesh<Scalar> loaded;
+    if (instances.empty() || !load_mesh(mesh, &loaded)) {
         return;
     }
-
-    // 2. Project the "edge" point to determine the size in pixels.
-    Vec2i screen_edge;
-    if (!project_vertex(&edge_world, vp_matrix, &screen_edge, WIDTH, HEIGHT)) {
-        // If the edge point is not projectable (e.g. behind camera), we can't
-        // reliably calculate a size, so we can either draw a minimal 1x1 point
-        // or just skip it. Skipping is safer to avoid visual artifacts.
-        // For a small point, it's often fine to just draw a single pixel.
-        //canvas.setPixel(screen_pos.x, screen_pos.y);
-        return;
+    Vec4f frustum_planes_f[6];
+    frustum_planes(vp_matrix, frustum_planes_f);
+    typename Math::Vec4 frustum[6];
+    for (int i = 0; i < 6; i++) {
+        frustum[i] = Math::vec4(frustum_planes_f[i]);
+    }
+    const typename Math::Matrix vp = Math::matrix(vp_matrix);
+    const Scalar pixels_per_unit = Math::from_float(projection_pixels_per_unit(vp_matrix, HEIGHT));
+    const typename Math::Vec3 bounds_center = Math::vec3(mesh->bounds_center);
+    const Scalar bounds_radius = Math::from_float(mesh->bounds_radius);
+    const typename Math::Vec3 world_light = Math::vec3(*world_light_dir);
+    constexpr Scalar POINT_RADIUS = Math::from_float(LOD_POINT_RADIUS);
+    // Quantized meshes fold their dequantization into each instance's vertex transform.
+    const Affine3f dequantize_f = mesh_dequantize_affine(mesh);
+    const typename Math::Affine dequantize = Math::affine(&dequantize_f);
+    const typename Math::Affine* vertex_transform = mesh_is_quantized(mesh) ? &dequantize : NULL;
+    // mesh_select_lod() turned around: level l + 1 (LOD l) is close enough while the projected
+    // radius is at most lod_limits[l].
+    Scalar lod_limits[MAX_BATCH_LODS];
+    for (int l = 0; l + 1 < loaded.num_levels; l++) {
+        const float limit = mesh->lods[l].lod_error > 0.0f
+                          ? LOD_PIXEL_ERROR * mesh->bounds_radius / mesh->lods[l].lod_error : HUGE_VALF;
+        lod_limits[l] = limit < Math::to_float(Math::MAX) ? Math::from_float(limit) : Math::MAX;
     }
 
-    // 3. Calculate the radius in pixels using the distance between the projected points.
-    // We use the distance formula, but since our offset was only on one axis (Y),
-    // we can simplify it. Using the full distance formula would also work and be
-    // more robust if the offset was in a more complex direction.
-    float dx = screen_pos.x - screen_edge.x;
-    float dy = screen_pos.y - screen_edge.y;
-    float screen_radius = sqrtf(dx * dx + dy * dy);
+    static typename Math::Batch batch;
+    static PointInstance dots[MAX_QUEUED_DOTS];
+    int num_dots = 0;
+    auto queue_dot = [&](const PointInstance& dot) {
+        if (num_dots == MAX_QUEUED_DOTS) {
+            draw_points_3d(canvas, vp_matrix, std::span<const PointInstance>(dots, num_dots));
+            num_dots = 0;
+        }
+        dots[num_dots++] = dot;
+        if (record) {
+            record->valid = false; // Only triangles are cached
+        }
+    };
+
+    for (size_t first = 0; first < instances.size(); first += MATH_3D_MAX_BATCH) {
+        const int count = (int)std::min(instances.size() - first, (size_t)MATH_3D_MAX_BATCH);
+        Math::build_batch(instances.data() + first, count, &vp, vertex_transform, bounds_center, &batch);
+
+        for (int i = 0; i < count; i++) {
+            const typename Math::Instance& instance = instances[first + i];
+            const Scalar world_radius = Math::mul(bounds_radius, Math::abs(instance.scale));
+            const typename Math::Vec3 world_center = Math::center(&batch, i);
+            if (Math::outside_frustum(frustum, world_center, world_radius)) {
+                continue;
+            }
+
+            const Scalar projected_radius = Math::projected_radius(&vp, world_center, world_radius, pixels_per_unit);
+            if (projected_radius < POINT_RADIUS) {
+                // Dots are drawn in float, like the other points.
+                queue_dot((PointInstance){Math::to_vec3f(world_center), Math::to_float(world_radius) * 0.5f});
+                continue;
+            }
+            int level = 0;
+            while (level + 1 < loaded.num_levels && projected_radius <= lod_limits[level]) {
+                level++;
+            }
 
-    // 4. Calculate the final width/height of the rectangle (diameter).
-    // We ensure it's at least 1 pixel wide so it doesn't disappear when very far away.
-    int w = (int)(screen_radius * 2.0f);
-    if (w < 1) {
-        w = 1;
+            const typename Math::Matrix mvp_matrix = Math::mvp(&batch, i);
+            // Light the precomputed model-space normals by rotating the light into model space
+            // instead of rotating every normal into world space. That also scales it by the
+            // instance's scale, which is divided out again.
+            const typename Math::Affine model_matrix = Math::model(&batch, i);
+            const typename Math::Vec3 light_dir = Math::scale(Math::inverse_rotate(&model_matrix, world_light),
+                                                              Math::reciprocal(instance.scale));
+            draw_mesh_transformed(canvas, millis, &loaded, level, &mvp_matrix, light_dir, texture, record);
+        }
     }
 
-    // 5. Draw the filled rectangle centered on the projected point's position.
-    // The `true` likely corresponds to the color/fill state.
-    draw_filled_rect(canvas, screen_pos.x - (w / 2), screen_pos.y - (w / 2), w, w, true);
+    // Dots first, so that the batch's own triangles cover them.
+    draw_points_3d(canvas, vp_matrix, std::span<const PointInstance>(dots, num_dots));
+    draw_queued_triangles<Scalar>(canvas, millis, texture);
+}
+
+/**
+ * @brief Draws one model. With a `cache`, a model that hasn't moved since the last call (and
+ * whose view, light and texture haven't changed either) skips straight to rasterizing its triangles.
+ */
+template <typename Scalar = VertexScalar>
+static void draw_3d_model(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis, const Mat4f* vp_matrix,
+                          const Mesh* mesh,
+                          Vec3f position, float rotation_x_rad, float rotation_y_rad, float rotation_z_rad, float scale,
+                          const Vec3f* world_light_dir, ProjectedMeshCache<Scalar>* cache = NULL,
+                          const JaTexture* texture = NULL)
+{
+    const InstanceTransform instance = {position, rotation_x_rad, rotation_y_rad, rotation_z_rad, scale};
+    if (cache) {
+        if (projected_cache_matches(cache, mesh, &instance, vp_matrix, world_light_dir, texture)) {
+            for (int i = 0; i < cache->num_triangles; i++) {
+                draw_projected_triangle(canvas, millis, &cache->triangles[i], cache->texture);
+            }
+            return;
+        }
+        cache->valid = true;
+        cache->mesh = mesh;
+        cache->instance = instance;
+        cache->vp_matrix = *vp_matrix;
+        cache->light_dir = *world_light_dir;
+        cache->texture = texture;
+        cache->num_triangles = 0;
+    }
+    const typename VertexMath<Scalar>::Instance placed = VertexMath<Scalar>::instance(instance);
+    draw_mesh_instanced<Scalar>(canvas, millis, vp_matrix, mesh,
+                                std::span<const typename VertexMath<Scalar>::Instance>(&placed, 1), world_light_dir,
+                                texture, cache);
+}
+/**
+ * @brief Draws dots in 3D space whose sizes respect perspective, e.g. bullets and the laser.
+ *
+ * @param canvas The canvas to draw on.
+ * @param vp_matrix The combined View-Projection matrix.
+ * @param points Positions and radii (world units) of the dots.
+ * @param shape Square, round, or round with a soft edge.
+ */
+static void draw_points_3d(JaDraw<WIDTH, HEIGHT>& canvas, const Mat4f* vp_matrix,
+                           std::span<const PointInstance> points, JaPointShape shape)
+{
+    const float pixels_per_unit = projection_pixels_per_unit(vp_matrix, HEIGHT);
+    for (const PointInstance& point : points) {
+        // One projection gives both the center and, from its w, the size in pixels.
+        float x, y, radius;
+        if (project_point_sprite(vp_matrix, point.position, point.radius, pixels_per_unit, WIDTH, HEIGHT, &x, &y, &radius)) {
+            canvas.drawPointSprite(x, y, radius, Colors::White, shape);
+        }
+    }
 }
 
 // Helper to convert world coordinates [-1, 1] to screen pixels [0, Res-1]
@@ -749,15 +1312,11 @@ static void world_to_screen(float wx, float wy, uint32_t* sx, uint32_t* sy) {
 
 // Helper to draw a simple filled rectangle
 static void draw_filled_rect(JaDraw<WIDTH, HEIGHT>& canvas, uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool white) {
-    // Clamp width and height to avoid overflow and infinite loops
+    // Clamp width and height to avoid overflow
     if (x >= WIDTH || y >= HEIGHT) return;
-    uint32_t max_w = (x + w > WIDTH) ? (WIDTH - x) : w;
-    uint32_t max_h = (y + h > HEIGHT) ? (HEIGHT - y) : h;
-    for (uint32_t i = x; i < (uint32_t)(x + max_w); ++i) {
-        for (uint32_t j = y; j < (uint32_t)(y + max_h); ++j) {
-            drawPixel(canvas, i, j, white);
-        }
-    }
+    w = (x + w > WIDTH) ? (WIDTH - x) : w;
+    h = (y + h > HEIGHT) ? (HEIGHT - y) : h;
+    canvas.fillRect((int)x, (int)y, (int)w, (int)h, white ? Colors::White : Colors::Black);
 }
 
 unsigned int prng_seed = 59345;
@@ -775,78 +1334,83 @@ float prng_float(void) {
     return (float)simple_prng() / 0xFFFFFFFF;
 }
 
-static void draw_starfield(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis) {
-    const int NUM_STARS = 64; // Increased for a better effect
-    const float ZOOM_SPEED = 0.05f; // Adjusted for a more pleasant speed
-    const float MAX_DEPTH = 100.0f;
-    const float CENTER_X = WIDTH / 2.0f;
-    const float CENTER_Y = HEIGHT / 2.0f;
+// --- Particles ---
+// Purely visual, like the rest of the drawing: the game state only says which asteroids were
+// destroyed and knows nothing about the particles. They use prng_float() so they don't change
+// the game's rand() sequence.
+#define NUM_STARS 64
+#define STAR_DEPTH 100.0f
+#define STAR_SPEED 50.0f // Units per second
+#define MAX_EFFECT_PARTICLES 512
+
+static JaParticleSystem stars(NUM_STARS);
+static JaParticleSystem effect_particles(MAX_EFFECT_PARTICLES); // Laser sparks and asteroid debris
+
+// The stars have a projection of their own, looking down +z: screen = center + (x, y) / z * center.
+static const Mat4f STAR_PROJECTION = {{
+    {1.0f, 0.0f, 0.0f, 0.0f},
+    {0.0f, -1.0f, 0.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f, 0.0f},
+}};
+
+static float prng_range(float min, float max) {
+    return min + prng_float() * (max - min);
+}
 
-    for (int star_id = 0; star_id < NUM_STARS; star_id++) {
-        // --- Star Property Generation (THE FIX) ---
-        
-        // 1. Set a DETERMINISTIC seed based *only* on the star's unique ID.
-        // This is the key to the fix. Every star now has its own set of
-        // predictable "random" properties that will be the same on every frame.
-        prng_seed = (star_id + 1) * 19937;
+// Seeds the starfield and sets the effects up, once.
+static void init_particles() {
+    // They fly towards the camera forever, going back to the far end once they pass it.
+    stars.clear();
+    for (int i = 0; i < NUM_STARS; i++) {
+        Vec3f position = {prng_range(-STAR_DEPTH, STAR_DEPTH), prng_range(-STAR_DEPTH, STAR_DEPTH),
+                          prng_range(1.0f, 1.0f + STAR_DEPTH)};
+        stars.emit(position, (Vec3f){0.0f, 0.0f, -STAR_SPEED}, HUGE_VALF);
+    }
+    stars.setWrap((Vec3f){0.0f, 0.0f, 1.0f}, (Vec3f){0.0f, 0.0f, 1.0f + STAR_DEPTH});
+    effect_particles.clear();
+    effect_particles.setFadeTime(0.25f);
+}
 
+// Bursts a destroyed asteroid into debris that keeps some of its motion.
+static void spawn_debris(const Asteroid* asteroid) {
+    const Vec3f position = {asteroid->pos.x, 0.0f, asteroid->pos.y};
+    const int num_pieces = (int)(asteroid->size * 60.0f);
+    const float speed = asteroid->size * 2.0f;
+    for (int i = 0; i < num_pieces; i++) {
+        Vec3f velocity = {asteroid->vel.x + prng_range(-speed, speed), prng_range(-speed, speed),
+                          asteroid->vel.y + prng_range(-speed, speed)};
+        effect_particles.emit(position, velocity, prng_range(0.3f, 0.8f));
+    }
+}
 
-        // 2. Generate the star's persistent properties from this seed.
-        // These values are now constant for a given star_id.
-        float star_x_3d = (prng_float() * 2.0f - 1.0f) * MAX_DEPTH;
-        float star_y_3d = (prng_float() * 2.0f - 1.0f) * MAX_DEPTH;
-        float initial_z_offset = prng_float() * MAX_DEPTH; // Each star starts at a random depth
+static void update_particles(const GameState* state, float dt) {
+    stars.update(dt);
 
-        // --- Animation ---
-        
-        // 3. Animate the Z position based on time. The initial offset and
-        // the passage of time (`millis`) create the movement.
-        // The modulo operator (%) wraps the star back to the farthest depth
-        // once it passes the camera, creating an infinite tunnel effect.
-        float current_z = fmodf(initial_z_offset - (float)millis * ZOOM_SPEED, MAX_DEPTH);
-        
-        // Ensure Z is always positive after the modulo operation
-        if (current_z < 0) {
-            current_z += MAX_DEPTH;
-        }
-
-        // --- 3D to 2D Projection (Perspective) ---
-        
-        // Avoid division by zero and make stars appear at a distance
-        if (current_z > 1.0f) { 
-            // Perspective projection: screen_coord = (3d_coord * focal_length) / z_depth
-            // A "focal length" is implied by how we scale the result.
-            // Here we scale by the screen center to spread the stars out.
-            float projected_x = star_x_3d / current_z;
-            float projected_y = star_y_3d / current_z;
-
-            // Map from normalized coordinates to screen coordinates
-            int screen_x = (int)(projected_x * CENTER_X + CENTER_X);
-            int screen_y = (int)(projected_y * CENTER_Y + CENTER_Y);
+    for (int i = 0; i < state->numDestroyedAsteroids; i++) {
+        spawn_debris(&state->destroyedAsteroids[i]);
+    }
 
-            // --- Drawing ---
-            
-            // Check if the star is within the screen boundaries
-            if (screen_x >= 0 && screen_x < WIDTH &&
-                screen_y >= 0 && screen_y < HEIGHT) {
-                
-                // Closer stars (smaller Z) should be brighter.
-                int brightness = (int)(255.0f * (1.0f - (current_z / MAX_DEPTH)));
-                
-                // Clamp brightness to a valid 0-255 range
-                brightness = (brightness < 0) ? 0 : (brightness > 255) ? 255 : brightness;
-                
-                // Draw the star
-                drawPixel(canvas, screen_x, screen_y, brightness);
-            }
+    // Sparks fly off the laser beam, more for a more powerful shot.
+    if (state->laser.active && !state->gameOver) {
+        const int num_sparks = 1 + (int)(state->laser.power * 6.0f);
+        for (int i = 0; i < num_sparks; i++) {
+            Vec3f position = {state->laser.x_pos, 0.0f, prng_range(-0.6f, 2.2f)};
+            Vec3f velocity = {prng_range(-1.5f, 1.5f), prng_range(-1.0f, 0.3f), prng_range(-0.5f, 0.5f)};
+            effect_particles.emit(position, velocity, prng_range(0.1f, 0.35f));
         }
     }
+    effect_particles.update(dt);
+}
+
+static void draw_starfield(JaDraw<WIDTH, HEIGHT>& canvas) {
+    stars.draw(canvas, &STAR_PROJECTION);
 }
 
 
 // --- Corrected draw_game_over function ---
-void draw_game_over(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis) {
-    draw_starfield(canvas, millis);
+void draw_game_over(JaDraw<WIDTH, HEIGHT>& canvas) {
+    draw_starfield(canvas);
     canvas.drawText("GAME OVER", 14, 25, 2, Colors::White, false);
     canvas.drawText("GAME OVER", 15, 25, 2, Colors::White, false);
 }
@@ -864,10 +1428,13 @@ void draw_game_over(JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis) {
  */
 static void draw_game_3d(const GameState* state, JaDraw<WIDTH, HEIGHT>& canvas, unsigned long millis) {
     clear_canvas(canvas);
-    draw_starfield(canvas, millis);
+#if USE_DEPTH_BUFFER
+    depth_buffer.clear();
+#endif
+    draw_starfield(canvas);
 
     if (state->gameOver) {
-        draw_game_over(canvas, millis);
+        draw_game_over(canvas);
         static char scoreReport[16];
         snprintf(scoreReport, sizeof(scoreReport), "%05d", state->score);
         canvas.drawText(scoreReport, 2, 2, 1, Colors::White, false);
@@ -882,7 +1449,7 @@ static void draw_game_3d(const GameState* state, JaDraw<WIDTH, HEIGHT>& canvas,
     
     float fov_rad = 70.0f * (3.14159f / 180.0f);
     float aspect_ratio = (float)WIDTH / (float)HEIGHT;
-    Mat4f proj_matrix = matrix_perspective(fov_rad, aspect_ratio, 0.1f, 100.0f);
+    Mat4f proj_matrix = matrix_perspective(fov_rad, aspect_ratio, CAMERA_NEAR, CAMERA_FAR);
 
     Mat4f vp_matrix = matrix_multiply(proj_matrix, view_matrix);
     //Vec3f sun_direction = vec3_normalize((Vec3f){0.5f, 0.8f, -0.3f});
@@ -896,30 +1463,41 @@ static void draw_game_3d(const GameState* state, JaDraw<WIDTH, HEIGHT>& canvas,
              if (charge_ratio > 1.0f) { charge_ratio = 1.0f; }
              float pulseSize = 0.06f * charge_ratio + 0.02f * cos(millis * 0.05f);
              Vec3f pulsePos = {player_pos_3d.x, player_pos_3d.y, player_pos_3d.z + 0.2f};
-             draw_3d_point(canvas, &vp_matrix, pulsePos, pulseSize);
+             const PointInstance pulse = {pulsePos, pulseSize};
+             draw_points_3d(canvas, &vp_matrix, std::span<const PointInstance>(&pulse, 1), JaPointShape::ROUND);
         }   
         // The player ship can remain unrotated for a clean look.
         float player_rotation_y = 3.1f; 
         float player_scale = 0.25f;
         float tilt = state->player.vel * -35.0f;
-        draw_3d_model(canvas, millis, &vp_matrix, SHIP_VERTICES, SHIP_INDICES, SHIP_NUM_INDICES,
-                      player_pos_3d, 0, player_rotation_y, tilt, player_scale, &sun_direction);
+        // The camera never moves and the ship is often still, so its setup is usually reused.
+        static ProjectedMeshCache<VertexScalar> ship_cache;
+        draw_3d_model(canvas, millis, &vp_matrix, &SHIP_MESH,
+                      player_pos_3d, 0, player_rotation_y, tilt, player_scale, &sun_direction, &ship_cache);
     }
 
     // --- Draw Bullets ---
+    PointInstance bullet_points[MAX_BULLETS];
+    int num_bullet_points = 0;
     for (int i = 0; i < MAX_BULLETS; ++i) {
         if (state->bullets[i].active) {
             // ADAPTATION: Convert 2D bullet position to 3D world position.
             Vec3f bullet_pos_3d = {state->bullets[i].pos.x, 0.0f, state->bullets[i].pos.y};
             
             // Bullets are simple; no rotation needed.
-            // draw_3d_model(canvas, millis, &vp_matrix, CUBE_VERTICES, CUBE_INDICES, CUBE_NUM_INDICES,
-            //               bullet_pos_3d, 0, 0.0f, 0, 0.04f, &sun_direction);
-            draw_3d_point(canvas, &vp_matrix, bullet_pos_3d, 0.03f);
+            // draw_3d_model(canvas, millis, &vp_matrix, &CUBE_MESH, bullet_pos_3d, 0, 0.0f, 0, 0.04f, &sun_direction);
+            bullet_points[num_bullet_points++] = (PointInstance){bullet_pos_3d, 0.03f};
         }
     }
+    draw_points_3d(canvas, &vp_matrix, std::span<const PointInstance>(bullet_points, num_bullet_points));
 
     // --- Draw Asteroids ---
+    // Flashing asteroids are lit from the camera, so they go in a batch of their own.
+    typedef VertexMath<VertexScalar>::Instance Instance;
+    static Instance asteroid_instances[MAX_ASTEROIDS];
+    static Instance flashing_instances[MAX_ASTEROIDS];
+    int num_asteroid_instances = 0;
+    int num_flashing_instances = 0;
     for (int i = 0; i < MAX_ASTEROIDS; ++i) {
         if (state->asteroids[i].active) {
             // ADAPTATION: Convert 2D asteroid position to 3D world position.
@@ -933,24 +1511,36 @@ static void draw_game_3d(const GameState* state, JaDraw<WIDTH, HEIGHT>& canvas,
             
             // Use the asteroid's 2D size directly for 3D scaling.
             float scale = state->asteroids[i].size * 1.0f; // Adjust scale factor as needed
-            Vec3f flash_dir = vec3_normalize((Vec3f){0.0f, 0.0f, -1.0f});
-            Vec3f* light_dir = state->asteroids[i].flashTimerMs > 0 ? &flash_dir : &sun_direction;
-            draw_3d_model(canvas, millis, &vp_matrix, ASTEROID_VERTICES, ASTEROID_INDICES, ASTEROID_NUM_INDICES,
-                          asteroid_pos_3d, rotation_y, rotation_y, 0, scale, light_dir);
+            const InstanceTransform placement = {asteroid_pos_3d, rotation_y, rotation_y, 0, scale};
+            const Instance instance = VertexMath<VertexScalar>::instance(placement);
+            if (state->asteroids[i].flashTimerMs > 0) {
+                flashing_instances[num_flashing_instances++] = instance;
+            } else {
+                asteroid_instances[num_asteroid_instances++] = instance;
+            }
         }
     }
+    Vec3f flash_dir = vec3_normalize((Vec3f){0.0f, 0.0f, -1.0f});
+    draw_mesh_instanced<VertexScalar>(canvas, millis, &vp_matrix, &ASTEROID_MESH,
+                                      std::span<const Instance>(asteroid_instances, num_asteroid_instances),
+                                      &sun_direction, &ROCK_TEXTURE);
+    draw_mesh_instanced<VertexScalar>(canvas, millis, &vp_matrix, &ASTEROID_MESH,
+                                      std::span<const Instance>(flashing_instances, num_flashing_instances), &flash_dir);
     
     // --- Draw Laser ---
     if (state->laser.active) {
         // goes from 1.0 to 0.0 as the laser nears dissapearing time
         float laserLifetimeProportion = state->laser.duration / LASER_DURATION;
+        PointInstance laser_points[15];
         for (int i = 0; i < 15; i++)
         {
             Vec3f laser_pos_3d = { state->laser.x_pos, 0.0f, i * 0.2f - (0.6f + 0.2f * cos(millis * 0.07f)) };
             float laserBaseSize = state->laser.power * 0.11f;
-            draw_3d_point(canvas, &vp_matrix, laser_pos_3d, laserBaseSize * laserLifetimeProportion);
+            laser_points[i] = (PointInstance){laser_pos_3d, laserBaseSize * laserLifetimeProportion};
         }
+        draw_points_3d(canvas, &vp_matrix, std::span<const PointInstance>(laser_points, 15), JaPointShape::ROUND);
     }
+    effect_particles.draw(canvas, &vp_matrix);
     
     // --- Draw UI (HP Bar) ---
     uint32_t hp_bar_width = (uint32_t)((state->player.hp / PLAYER_INITIAL_HP) * 29);
@@ -0,0 +1,59 @@
+#ifndef ASTEROID_MESH_H
+#define ASTEROID_MESH_H
+
+#include "mesh_3d.h"
+
+// Generated by tools/jamesh_convert from asteroid.obj. Do not edit by hand.
+
+const int ASTEROID_MODEL_NUM_VERTICES = 9;
+const int ASTEROID_MODEL_NUM_INDICES = 42;
+
+const int16_t ASTEROID_MODEL_POSITIONS[ASTEROID_MODEL_NUM_VERTICES * 3] = {
+    -32172, 32767, -7889, -1446, -8425, -32767, -32767, -7036, 3340, 27339, 27579, -14774, 
+    -30848, 6953, 32767, 5748, -32767, 18473, 1785, 29264, 24501, 32767, 518, 27208, 
+    28697, -9891, -17511
+};
+
+const uint8_t ASTEROID_MODEL_INDICES[ASTEROID_MODEL_NUM_INDICES] = {
+    1, 0, 3, 0, 4, 6, 7, 4, 5, 1, 8, 5, 
+    3, 0, 6, 4, 2, 5, 6, 7, 3, 7, 6, 4, 
+    1, 3, 8, 4, 0, 2, 5, 2, 1, 2, 0, 1, 
+    8, 3, 7, 5, 8, 7
+};
+
+const uint16_t ASTEROID_MODEL_FACE_NORMALS[ASTEROID_MODEL_NUM_INDICES / 3] = {
+    11256, 24505, 33891, 46352, 35570, 20300, 44978, 35475, 63444, 2434, 16675, 3390, 
+    63886, 49738
+};
+
+const uint16_t ASTEROID_MODEL_VERTEX_NORMALS[ASTEROID_MODEL_NUM_VERTICES] = {
+    13779, 7190, 11074, 51158, 21630, 32027, 35781, 48765, 55870
+};
+
+const uint8_t ASTEROID_MODEL_LOD1_INDICES[12] = {
+    1, 4, 3, 3, 4, 7, 7, 4, 1, 1, 3, 7
+};
+
+const uint16_t ASTEROID_MODEL_LOD1_FACE_NORMALS[4] = {
+    13008, 35782, 30236, 56384
+};
+
+// Levels of detail, coarsest last. See mesh_select_lod().
+static const Mesh ASTEROID_MODEL_LODS[1] = {
+    mesh_with_lod_error(mesh_make_quantized(
+        ASTEROID_MODEL_POSITIONS, ASTEROID_MODEL_NUM_VERTICES,
+        (Vec3f){1.57569048e-05f, 1.66487607e-05f, 1.64378034e-05f},
+        (Vec3f){-0.0290865004f, 0.0145809948f, -0.0511035174f},
+        ASTEROID_MODEL_LOD1_INDICES, NULL, 12,
+        ASTEROID_MODEL_LOD1_FACE_NORMALS, ASTEROID_MODEL_VERTEX_NORMALS), 0.582712293f)
+};
+
+static const Mesh ASTEROID_MODEL_MESH = mesh_with_lods(mesh_make_quantized(
+    ASTEROID_MODEL_POSITIONS, ASTEROID_MODEL_NUM_VERTICES,
+    (Vec3f){1.57569048e-05f, 1.66487607e-05f, 1.64378034e-05f},
+    (Vec3f){-0.0290865004f, 0.0145809948f, -0.0511035174f},
+    ASTEROID_MODEL_INDICES, NULL, ASTEROID_MODEL_NUM_INDICES,
+    ASTEROID_MODEL_FACE_NORMALS, ASTEROID_MODEL_VERTEX_NORMALS),
+    ASTEROID_MODEL_LODS, 1);
+
+#endif // ASTEROID_MESH_H
@@ -3,17 +3,100 @@
 
 #include <math.h>
 
+// Functions that don't need the C math library can be evaluated at compile time in C++.
+#ifdef __cplusplus
+#define MATH_3D_CONSTEXPR constexpr
+#else
+#define MATH_3D_CONSTEXPR
+#endif
+
+// --- SIMD backend for the batch functions at the end of this file ---
+// MATH_3D_SIMD_LANES is the number of floats processed per instruction; 0 means plain C.
+// m3d_lt() gives an all-ones lane where a < b, for masking with m3d_and().
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATH_3D_SIMD_LANES 8
+typedef __m256 m3d_float;
+static inline m3d_float m3d_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void m3d_store(float* p, m3d_float v) { _mm256_storeu_ps(p, v); }
+static inline void m3d_store_int(int* p, m3d_float v) { _mm256_storeu_si256((__m256i*)p, _mm256_cvttps_epi32(v)); }
+static inline m3d_float m3d_set1(float f) { return _mm256_set1_ps(f); }
+static inline m3d_float m3d_add(m3d_float a, m3d_float b) { return _mm256_add_ps(a, b); }
+static inline m3d_float m3d_sub(m3d_float a, m3d_float b) { return _mm256_sub_ps(a, b); }
+static inline m3d_float m3d_mul(m3d_float a, m3d_float b) { return _mm256_mul_ps(a, b); }
+static inline m3d_float m3d_div(m3d_float a, m3d_float b) { return _mm256_div_ps(a, b); }
+static inline m3d_float m3d_lt(m3d_float a, m3d_float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline m3d_float m3d_and(m3d_float a, m3d_float b) { return _mm256_and_ps(a, b); }
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATH_3D_SIMD_LANES 4
+typedef __m128 m3d_float;
+static inline m3d_float m3d_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void m3d_store(float* p, m3d_float v) { _mm_storeu_ps(p, v); }
+static inline void m3d_store_int(int* p, m3d_float v) { _mm_storeu_si128((__m128i*)p, _mm_cvttps_epi32(v)); }
+static inline m3d_float m3d_set1(float f) { return _mm_set1_ps(f); }
+static inline m3d_float m3d_add(m3d_float a, m3d_float b) { return _mm_add_ps(a, b); }
+static inline m3d_float m3d_sub(m3d_float a, m3d_float b) { return _mm_sub_ps(a, b); }
+static inline m3d_float m3d_mul(m3d_float a, m3d_float b) { return _mm_mul_ps(a, b); }
+static inline m3d_float m3d_div(m3d_float a, m3d_float b) { return _mm_div_ps(a, b); }
+static inline m3d_float m3d_lt(m3d_float a, m3d_float b) { return _mm_cmplt_ps(a, b); }
+static inline m3d_float m3d_and(m3d_float a, m3d_float b) { return _mm_and_ps(a, b); }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MATH_3D_SIMD_LANES 4
+typedef float32x4_t m3d_float;
+static inline m3d_float m3d_load(const float* p) { return vld1q_f32(p); }
+static inline void m3d_store(float* p, m3d_float v) { vst1q_f32(p, v); }
+static inline void m3d_store_int(int* p, m3d_float v) { vst1q_s32(p, vcvtq_s32_f32(v)); }
+static inline m3d_float m3d_set1(float f) { return vdupq_n_f32(f); }
+static inline m3d_float m3d_add(m3d_float a, m3d_float b) { return vaddq_f32(a, b); }
+static inline m3d_float m3d_sub(m3d_float a, m3d_float b) { return vsubq_f32(a, b); }
+static inline m3d_float m3d_mul(m3d_float a, m3d_float b) { return vmulq_f32(a, b); }
+static inline m3d_float m3d_div(m3d_float a, m3d_float b) { return vdivq_f32(a, b); }
+static inline m3d_float m3d_lt(m3d_float a, m3d_float b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+static inline m3d_float m3d_and(m3d_float a, m3d_float b) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+#else
+#define MATH_3D_SIMD_LANES 0
+#endif
+
 // --- Structures ---
 struct Vec2i { int x, y; };
 
+// Unrounded screen position, for the rasterizer's sub-pixel precision.
+typedef struct {
+    float x, y;
+} Vec2f;
+
 typedef struct {
     float x, y, z;
 } Vec3f;
 
+typedef struct {
+    float x, y, z, w;
+} Vec4f;
+
 typedef struct {
     float m[4][4];
 } Mat4f;
 
+// A 4x4 matrix whose bottom row is implicitly (0, 0, 0, 1): rotation, scale and translation.
+typedef struct {
+    float m[3][4];
+} Affine3f;
+
+// Unit quaternion for rotations, w being the real part.
+typedef struct {
+    float x, y, z, w;
+} Quatf;
+
+// A dot in the world that keeps its size in perspective, see project_point_sprite().
+typedef struct {
+    Vec3f position;
+    float radius; // World units
+} PointInstance;
+
 
 // --- Vector Helper Functions ---
 
@@ -139,6 +222,135 @@ static inline Mat4f matrix_multiply(Mat4f a, Mat4f b) {
     return result;
 }
 
+/**
+ * @brief Rotates a direction by the inverse of the rotation part of `m`.
+ *
+ * For a matrix made of rotations, uniform scale and translation this takes a world-space
+ * direction into model space (up to the scale), e.g. to light a model in its own space.
+ */
+static inline Vec3f matrix_inverse_rotate(const Mat4f* m, Vec3f v) {
+    return (Vec3f){
+        m->m[0][0] * v.x + m->m[1][0] * v.y + m->m[2][0] * v.z,
+        m->m[0][1] * v.x + m->m[1][1] * v.y + m->m[2][1] * v.z,
+        m->m[0][2] * v.x + m->m[1][2] * v.y + m->m[2][2] * v.z
+    };
+}
+
+
+// --- Affine Transform Functions ---
+// Model transforms never need the projective bottom row, so composing them as Affine3f saves
+// a quarter of the work, and building one from position, rotation and scale is done in closed
+// form instead of by multiplying matrices together.
+
+static inline MATH_3D_CONSTEXPR Affine3f affine_identity() {
+    Affine3f result = {{
+        {1.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f, 0.0f}
+    }};
+    return result;
+}
+
+/**
+ * @brief Builds translate * rotate_y * rotate_x * rotate_z * scale, the order the applets
+ * place their models in.
+ */
+static inline Affine3f affine_trs_euler(Vec3f position, float rotation_x_rad, float rotation_y_rad,
+                                        float rotation_z_rad, float scale) {
+    const float cx = cosf(rotation_x_rad), sx = sinf(rotation_x_rad);
+    const float cy = cosf(rotation_y_rad), sy = sinf(rotation_y_rad);
+    const float cz = cosf(rotation_z_rad), sz = sinf(rotation_z_rad);
+    Affine3f result = {{
+        {(cy * cz + sy * sx * sz) * scale, (sy * sx * cz - cy * sz) * scale, sy * cx * scale, position.x},
+        {cx * sz * scale,                  cx * cz * scale,                  -sx * scale,     position.y},
+        {(cy * sx * sz - sy * cz) * scale, (sy * sz + cy * sx * cz) * scale, cy * cx * scale, position.z}
+    }};
+    return result;
+}
+
+/**
+ * @brief Builds translate * rotate * scale from a unit quaternion. Needs no trigonometry, so it
+ * also works in constant expressions, e.g. for props that never move.
+ */
+static inline MATH_3D_CONSTEXPR Affine3f affine_trs_quat(Vec3f position, Quatf q, float scale) {
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    Affine3f result = {{
+        {(1.0f - 2.0f * (yy + zz)) * scale, 2.0f * (xy - wz) * scale,          2.0f * (xz + wy) * scale,          position.x},
+        {2.0f * (xy + wz) * scale,          (1.0f - 2.0f * (xx + zz)) * scale, 2.0f * (yz - wx) * scale,          position.y},
+        {2.0f * (xz - wy) * scale,          2.0f * (yz + wx) * scale,          (1.0f - 2.0f * (xx + yy)) * scale, position.z}
+    }};
+    return result;
+}
+
+/**
+ * @brief Rotation of `angle_rad` around the unit vector `axis`.
+ */
+static inline Quatf quat_from_axis_angle(Vec3f axis, float angle_rad) {
+    const float s = sinf(angle_rad * 0.5f);
+    return (Quatf){axis.x * s, axis.y * s, axis.z * s, cosf(angle_rad * 0.5f)};
+}
+
+/**
+ * @brief Multiplies two affine transforms (a * b), i.e. b is applied first.
+ */
+static inline MATH_3D_CONSTEXPR Affine3f affine_multiply(const Affine3f* a, const Affine3f* b) {
+    Affine3f result = {{{0}}};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] + a->m[i][2] * b->m[2][j];
+        }
+        result.m[i][3] += a->m[i][3];
+    }
+    return result;
+}
+
+/**
+ * @brief Multiplies a full 4x4 matrix by an affine one (a * b), e.g. view-projection * model.
+ */
+static inline MATH_3D_CONSTEXPR Mat4f matrix_multiply_affine(const Mat4f* a, const Affine3f* b) {
+    Mat4f result = {{{0}}};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] + a->m[i][2] * b->m[2][j];
+        }
+        result.m[i][3] += a->m[i][3];
+    }
+    return result;
+}
+
+static inline MATH_3D_CONSTEXPR Mat4f affine_to_matrix(const Affine3f* a) {
+    Mat4f result = {{
+        {a->m[0][0], a->m[0][1], a->m[0][2], a->m[0][3]},
+        {a->m[1][0], a->m[1][1], a->m[1][2], a->m[1][3]},
+        {a->m[2][0], a->m[2][1], a->m[2][2], a->m[2][3]},
+        {0.0f, 0.0f, 0.0f, 1.0f}
+    }};
+    return result;
+}
+
+static inline MATH_3D_CONSTEXPR Vec3f affine_transform_point(const Affine3f* a, Vec3f p) {
+    Vec3f result = {
+        a->m[0][0] * p.x + a->m[0][1] * p.y + a->m[0][2] * p.z + a->m[0][3],
+        a->m[1][0] * p.x + a->m[1][1] * p.y + a->m[1][2] * p.z + a->m[1][3],
+        a->m[2][0] * p.x + a->m[2][1] * p.y + a->m[2][2] * p.z + a->m[2][3]
+    };
+    return result;
+}
+
+/**
+ * @brief Same as matrix_inverse_rotate() for an affine transform.
+ */
+static inline MATH_3D_CONSTEXPR Vec3f affine_inverse_rotate(const Affine3f* a, Vec3f v) {
+    Vec3f result = {
+        a->m[0][0] * v.x + a->m[1][0] * v.y + a->m[2][0] * v.z,
+        a->m[0][1] * v.x + a->m[1][1] * v.y + a->m[2][1] * v.z,
+        a->m[0][2] * v.x + a->m[1][2] * v.y + a->m[2][2] * v.z
+    };
+    return result;
+}
+
 
 // --- Projection and View Functions ---
 
@@ -231,4 +443,515 @@ static inline Vec3f transform_vertex(const Vec3f* v, const Mat4f* m) {
     };
 }
 
+
+// --- Clipping ---
+
+// Outcode bits: which clip-space planes a vertex lies outside of.
+#define CLIP_LEFT   0x01 // x < -w
+#define CLIP_RIGHT  0x02 // x > w
+#define CLIP_BOTTOM 0x04 // y < -w
+#define CLIP_TOP    0x08 // y > w
+#define CLIP_NEAR   0x10 // z < -w, i.e. closer than the near plane (or behind the camera)
+#define CLIP_GUARD  0x20 // outside the guard band, see clip_outcode()
+#define CLIP_OUTSIDE_VIEW (CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP | CLIP_NEAR)
+
+// Largest polygon clip_triangle() can produce: 3 vertices plus one per clipping plane.
+#define CLIP_MAX_VERTICES 8
+
+// Transforms a 3D point by a 4x4 matrix, keeping w (model space -> clip space).
+static inline Vec4f transform_vertex4(const Vec3f* v, const Mat4f* m) {
+    return (Vec4f) {
+        v->x * m->m[0][0] + v->y * m->m[0][1] + v->z * m->m[0][2] + m->m[0][3],
+        v->x * m->m[1][0] + v->y * m->m[1][1] + v->z * m->m[1][2] + m->m[1][3],
+        v->x * m->m[2][0] + v->y * m->m[2][1] + v->z * m->m[2][2] + m->m[2][3],
+        v->x * m->m[3][0] + v->y * m->m[3][1] + v->z * m->m[3][2] + m->m[3][3]
+    };
+}
+
+/**
+ * @brief Computes the CLIP_* outcode of a clip-space vertex.
+ *
+ * `guard_band` is how many viewports wide the safe drawing area is (e.g. 8 means NDC -8..8).
+ * Vertices outside it get CLIP_GUARD: their screen coordinates could overflow the rasterizer's
+ * fixed-point math, so triangles using them have to be clipped first.
+ */
+static inline int clip_outcode(float x, float y, float z, float w, float guard_band) {
+    int code = 0;
+    if (x < -w) code |= CLIP_LEFT;
+    if (x > w)  code |= CLIP_RIGHT;
+    if (y < -w) code |= CLIP_BOTTOM;
+    if (y > w)  code |= CLIP_TOP;
+    if (z < -w) code |= CLIP_NEAR;
+    const float g = guard_band * w;
+    if (x < -g || x > g || y < -g || y > g) code |= CLIP_GUARD;
+    return code;
+}
+
+/**
+ * @brief One Sutherland-Hodgman pass: keeps the part of a convex polygon where
+ * a*x + b*y + c*z + d*w >= 0.
+ * @return Number of vertices written to `out` (at most count + 1).
+ */
+static inline int clip_polygon_plane(const Vec4f* in, int count, Vec4f* out, float a, float b, float c, float d) {
+    int out_count = 0;
+    for (int i = 0; i < count; ++i) {
+        const Vec4f* cur = &in[i];
+        const Vec4f* next = &in[(i + 1) % count];
+        float d_cur = a * cur->x + b * cur->y + c * cur->z + d * cur->w;
+        float d_next = a * next->x + b * next->y + c * next->z + d * next->w;
+        if (d_cur >= 0.0f) {
+            out[out_count++] = *cur;
+        }
+        if ((d_cur >= 0.0f) != (d_next >= 0.0f)) {
+            // The edge crosses the plane: add the intersection point.
+            float t = d_cur / (d_cur - d_next);
+            out[out_count++] = (Vec4f){
+                cur->x + (next->x - cur->x) * t,
+                cur->y + (next->y - cur->y) * t,
+                cur->z + (next->z - cur->z) * t,
+                cur->w + (next->w - cur->w) * t
+            };
+        }
+    }
+    return out_count;
+}
+
+/**
+ * @brief Clips a clip-space triangle against the near plane and the guard band.
+ *
+ * Only the planes named in `outcode_union` (the OR of the three vertices' outcodes) are
+ * applied. Edges of the viewport itself are left to the rasterizer.
+ * @param out Receives the clipped convex polygon, room for CLIP_MAX_VERTICES.
+ * @return Number of vertices in `out`; less than 3 means nothing is left to draw.
+ */
+static inline int clip_triangle(const Vec4f* tri, int outcode_union, float guard_band, Vec4f* out) {
+    Vec4f buffer[CLIP_MAX_VERTICES];
+    Vec4f* src = out;
+    Vec4f* dst = buffer;
+    int count = 3;
+    src[0] = tri[0];
+    src[1] = tri[1];
+    src[2] = tri[2];
+
+    // Near plane first, so every vertex left afterwards has a positive w.
+    const float planes[5][4] = {
+        {0.0f, 0.0f, 1.0f, 1.0f},        // z >= -w
+        {1.0f, 0.0f, 0.0f, guard_band},  // x >= -g * w
+        {-1.0f, 0.0f, 0.0f, guard_band}, // x <= g * w
+        {0.0f, 1.0f, 0.0f, guard_band},  // y >= -g * w
+        {0.0f, -1.0f, 0.0f, guard_band}, // y <= g * w
+    };
+    for (int p = 0; p < 5 && count >= 3; ++p) {
+        if (p == 0 && !(outcode_union & CLIP_NEAR)) continue;
+        if (p > 0 && !(outcode_union & CLIP_GUARD)) break;
+        count = clip_polygon_plane(src, count, dst, planes[p][0], planes[p][1], planes[p][2], planes[p][3]);
+        Vec4f* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != out) {
+        for (int i = 0; i < count; ++i) out[i] = src[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Extracts the six view-volume planes (left, right, bottom, top, near, far) from a
+ * projection-type matrix, normalized so a.x + b.y + c.z + d gives the signed distance.
+ *
+ * With an MVP matrix the planes are in model space, so model-space bounds can be tested
+ * without transforming them.
+ */
+static inline void frustum_planes(const Mat4f* m, Vec4f out_planes[6]) {
+    for (int i = 0; i < 6; ++i) {
+        const int row = i / 2;            // x, y, z
+        const float sign = (i % 2) ? -1.0f : 1.0f; // -w <= x, then x <= w
+        Vec4f p = {
+            m->m[3][0] + sign * m->m[row][0],
+            m->m[3][1] + sign * m->m[row][1],
+            m->m[3][2] + sign * m->m[row][2],
+            m->m[3][3] + sign * m->m[row][3]
+        };
+        float len = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) {
+            p.x /= len; p.y /= len; p.z /= len; p.w /= len;
+        }
+        out_planes[i] = p;
+    }
+}
+
+/**
+ * @brief True if a sphere is entirely outside at least one of the planes from frustum_planes().
+ */
+static inline bool sphere_outside_frustum(const Vec4f planes[6], Vec3f center, float radius) {
+    for (int i = 0; i < 6; ++i) {
+        if (planes[i].x * center.x + planes[i].y * center.y + planes[i].z * center.z + planes[i].w < -radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Pixels per world unit at distance 1 in front of the camera, for sphere_projected_radius().
+ * Expects a view-projection matrix made from matrix_perspective() and a view without scaling.
+ */
+static inline float projection_pixels_per_unit(const Mat4f* vp, int screen_h) {
+    return sqrtf(vp->m[1][0] * vp->m[1][0] + vp->m[1][1] * vp->m[1][1] + vp->m[1][2] * vp->m[1][2]) * 0.5f * screen_h;
+}
+
+/**
+ * @brief Roughly how many pixels a sphere's radius covers on screen. Spheres that reach the
+ * camera give HUGE_VALF.
+ */
+static inline float sphere_projected_radius(const Mat4f* vp, Vec3f center, float radius, float pixels_per_unit) {
+    float w = vp->m[3][0] * center.x + vp->m[3][1] * center.y + vp->m[3][2] * center.z + vp->m[3][3];
+    if (w <= radius) {
+        return HUGE_VALF;
+    }
+    return radius * pixels_per_unit / w;
+}
+
+/**
+ * @brief Projects a point sprite's center and sizes it from the same w, instead of projecting a
+ * second point on its edge. The center is in pixels, unrounded (pixel (x, y) spans x to x + 1).
+ *
+ * @param pixels_per_unit From projection_pixels_per_unit().
+ * @return false if the point is behind the camera, like project_vertex().
+ */
+static inline bool project_point_sprite(const Mat4f* vp, Vec3f position, float radius, float pixels_per_unit,
+                                        int screen_w, int screen_h, float* out_x, float* out_y, float* out_radius)
+{
+    float clip_x = vp->m[0][0] * position.x + vp->m[0][1] * position.y + vp->m[0][2] * position.z + vp->m[0][3];
+    float clip_y = vp->m[1][0] * position.x + vp->m[1][1] * position.y + vp->m[1][2] * position.z + vp->m[1][3];
+    float clip_w = vp->m[3][0] * position.x + vp->m[3][1] * position.y + vp->m[3][2] * position.z + vp->m[3][3];
+    if (clip_w < 0.001f) {
+        return false;
+    }
+    float inv_w = 1.0f / clip_w;
+    *out_x = (clip_x * inv_w + 1.0f) * 0.5f * screen_w;
+    *out_y = (1.0f - clip_y * inv_w) * 0.5f * screen_h;
+    *out_radius = fabsf(radius) * pixels_per_unit * inv_w;
+    return true;
+}
+
+// Perspective division and viewport mapping for a clip-space vertex with w > 0,
+// using the same rounding as project_vertex().
+static inline Vec2i clip_to_screen(const Vec4f* v, int screen_w, int screen_h) {
+    float ndc_x = v->x / v->w;
+    float ndc_y = v->y / v->w;
+    return (Vec2i){ (int)((ndc_x + 1.0f) * 0.5f * screen_w), (int)((1.0f - ndc_y) * 0.5f * screen_h) };
+}
+
+// clip_to_screen() without the rounding.
+static inline Vec2f clip_to_screen_subpixel(const Vec4f* v, int screen_w, int screen_h) {
+    float ndc_x = v->x / v->w;
+    float ndc_y = v->y / v->w;
+    return (Vec2f){ (ndc_x + 1.0f) * 0.5f * screen_w, (1.0f - ndc_y) * 0.5f * screen_h };
+}
+
+// --- Batch Functions ---
+// These take structure-of-arrays input (all x's, then all y's, then all z's) so that several
+// vertices can go through the matrix at once. Results match the single-vertex versions above.
+
+#if MATH_3D_SIMD_LANES
+// One matrix row applied to a batch of points: x * r[0] + y * r[1] + z * r[2] + r[3].
+static inline m3d_float m3d_row(const float* r, m3d_float x, m3d_float y, m3d_float z) {
+    return m3d_add(m3d_add(m3d_add(m3d_mul(x, m3d_set1(r[0])), m3d_mul(y, m3d_set1(r[1]))),
+                           m3d_mul(z, m3d_set1(r[2]))),
+                   m3d_set1(r[3]));
+}
+#endif
+
+/**
+ * @brief Transforms `count` points by a 4x4 matrix into homogeneous coordinates.
+ *
+ * Any of the outputs may be NULL if they aren't needed. With out_w NULL this is a batch
+ * transform_vertex(); with all four it gives clip-space positions for an MVP matrix.
+ */
+static inline void transform_points(const Mat4f* m, const float* xs, const float* ys, const float* zs, int count,
+                                    float* out_x, float* out_y, float* out_z, float* out_w)
+{
+    int i = 0;
+#if MATH_3D_SIMD_LANES
+    for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+        m3d_float x = m3d_load(xs + i);
+        m3d_float y = m3d_load(ys + i);
+        m3d_float z = m3d_load(zs + i);
+        if (out_x) m3d_store(out_x + i, m3d_row(m->m[0], x, y, z));
+        if (out_y) m3d_store(out_y + i, m3d_row(m->m[1], x, y, z));
+        if (out_z) m3d_store(out_z + i, m3d_row(m->m[2], x, y, z));
+        if (out_w) m3d_store(out_w + i, m3d_row(m->m[3], x, y, z));
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = xs[i], y = ys[i], z = zs[i];
+        if (out_x) out_x[i] = x * m->m[0][0] + y * m->m[0][1] + z * m->m[0][2] + m->m[0][3];
+        if (out_y) out_y[i] = x * m->m[1][0] + y * m->m[1][1] + z * m->m[1][2] + m->m[1][3];
+        if (out_z) out_z[i] = x * m->m[2][0] + y * m->m[2][1] + z * m->m[2][2] + m->m[2][3];
+        if (out_w) out_w[i] = x * m->m[3][0] + y * m->m[3][1] + z * m->m[3][2] + m->m[3][3];
+    }
+}
+
+/**
+ * @brief Batch version of project_vertex(): transform, perspective divide and viewport mapping
+ * in one pass.
+ *
+ * out_visible[i] is false for points behind the camera; their screen position is set to (0, 0).
+ */
+static inline void project_points(const Mat4f* mvp, const float* xs, const float* ys, const float* zs, int count,
+                                  int screen_w, int screen_h, int* out_sx, int* out_sy, bool* out_visible)
+{
+    int i = 0;
+#if MATH_3D_SIMD_LANES
+    const m3d_float one = m3d_set1(1.0f);
+    const m3d_float half = m3d_set1(0.5f);
+    const m3d_float width = m3d_set1((float)screen_w);
+    const m3d_float height = m3d_set1((float)screen_h);
+    float w_lanes[MATH_3D_SIMD_LANES];
+    for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+        m3d_float x = m3d_load(xs + i);
+        m3d_float y = m3d_load(ys + i);
+        m3d_float z = m3d_load(zs + i);
+        m3d_float clip_x = m3d_row(mvp->m[0], x, y, z);
+        m3d_float clip_y = m3d_row(mvp->m[1], x, y, z);
+        m3d_float clip_w = m3d_row(mvp->m[3], x, y, z);
+        // Lanes behind the camera divide by garbage here and get fixed up below.
+        m3d_float ndc_x = m3d_div(clip_x, clip_w);
+        m3d_float ndc_y = m3d_div(clip_y, clip_w);
+        m3d_store_int(out_sx + i, m3d_mul(m3d_mul(m3d_add(ndc_x, one), half), width));
+        m3d_store_int(out_sy + i, m3d_mul(m3d_mul(m3d_sub(one, ndc_y), half), height));
+        m3d_store(w_lanes, clip_w);
+        for (int lane = 0; lane < MATH_3D_SIMD_LANES; ++lane) {
+            out_visible[i + lane] = !(w_lanes[lane] < 0.001f);
+            if (!out_visible[i + lane]) {
+                out_sx[i + lane] = 0;
+                out_sy[i + lane] = 0;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        Vec3f v = {xs[i], ys[i], zs[i]};
+        Vec2i screen = {0, 0};
+        out_visible[i] = project_vertex(&v, mvp, &screen, screen_w, screen_h);
+        out_sx[i] = screen.x;
+        out_sy[i] = screen.y;
+    }
+}
+
+/**
+ * @brief project_points() without the rounding, for positions handed to the rasterizer.
+ */
+static inline void project_points_subpixel(const Mat4f* mvp, const float* xs, const float* ys, const float* zs, int count,
+                                           int screen_w, int screen_h, float* out_sx, float* out_sy, bool* out_visible)
+{
+    int i = 0;
+#if MATH_3D_SIMD_LANES
+    const m3d_float one = m3d_set1(1.0f);
+    const m3d_float half = m3d_set1(0.5f);
+    const m3d_float width = m3d_set1((float)screen_w);
+    const m3d_float height = m3d_set1((float)screen_h);
+    float w_lanes[MATH_3D_SIMD_LANES];
+    for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+        m3d_float x = m3d_load(xs + i);
+        m3d_float y = m3d_load(ys + i);
+        m3d_float z = m3d_load(zs + i);
+        m3d_float clip_x = m3d_row(mvp->m[0], x, y, z);
+        m3d_float clip_y = m3d_row(mvp->m[1], x, y, z);
+        m3d_float clip_w = m3d_row(mvp->m[3], x, y, z);
+        m3d_float ndc_x = m3d_div(clip_x, clip_w);
+        m3d_float ndc_y = m3d_div(clip_y, clip_w);
+        m3d_store(out_sx + i, m3d_mul(m3d_mul(m3d_add(ndc_x, one), half), width));
+        m3d_store(out_sy + i, m3d_mul(m3d_mul(m3d_sub(one, ndc_y), half), height));
+        m3d_store(w_lanes, clip_w);
+        for (int lane = 0; lane < MATH_3D_SIMD_LANES; ++lane) {
+            out_visible[i + lane] = !(w_lanes[lane] < 0.001f);
+            if (!out_visible[i + lane]) {
+                out_sx[i + lane] = 0.0f;
+                out_sy[i + lane] = 0.0f;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = xs[i], y = ys[i], z = zs[i];
+        const float clip_w = x * mvp->m[3][0] + y * mvp->m[3][1] + z * mvp->m[3][2] + mvp->m[3][3];
+        out_visible[i] = !(clip_w < 0.001f);
+        if (!out_visible[i]) {
+            out_sx[i] = 0.0f;
+            out_sy[i] = 0.0f;
+            continue;
+        }
+        const Vec4f clip = {x * mvp->m[0][0] + y * mvp->m[0][1] + z * mvp->m[0][2] + mvp->m[0][3],
+                            x * mvp->m[1][0] + y * mvp->m[1][1] + z * mvp->m[1][2] + mvp->m[1][3], 0.0f, clip_w};
+        const Vec2f screen = clip_to_screen_subpixel(&clip, screen_w, screen_h);
+        out_sx[i] = screen.x;
+        out_sy[i] = screen.y;
+    }
+}
+
+// Batches of transforms, stored structure-of-arrays: m[row][column][i] is that entry of
+// transform i, so the functions below compose several transforms at once.
+#define MATH_3D_MAX_BATCH 16
+
+typedef struct {
+    float m[3][4][MATH_3D_MAX_BATCH];
+} Affine3fBatch;
+
+typedef struct {
+    float m[4][4][MATH_3D_MAX_BATCH];
+} Mat4fBatch;
+
+/**
+ * @brief Batch affine_trs_euler() for `count` (at most MATH_3D_MAX_BATCH) transforms. The sines
+ * and cosines are taken one transform at a time; the products that combine them are not.
+ */
+static inline void affine_trs_euler_batch(const float* xs, const float* ys, const float* zs, const float* rotations_x,
+                                          const float* rotations_y, const float* rotations_z, const float* scales,
+                                          int count, Affine3fBatch* out)
+{
+    // The sines and cosines wait in the rotation entries until their transform is built.
+    float* cx = out->m[0][0];
+    float* sx = out->m[0][1];
+    float* cy = out->m[0][2];
+    float* sy = out->m[1][0];
+    float* cz = out->m[1][1];
+    float* sz = out->m[1][2];
+    for (int i = 0; i < count; ++i) {
+        cx[i] = cosf(rotations_x[i]);
+        sx[i] = sinf(rotations_x[i]);
+        cy[i] = cosf(rotations_y[i]);
+        sy[i] = sinf(rotations_y[i]);
+        cz[i] = cosf(rotations_z[i]);
+        sz[i] = sinf(rotations_z[i]);
+        out->m[0][3][i] = xs[i];
+        out->m[1][3][i] = ys[i];
+        out->m[2][3][i] = zs[i];
+    }
+    int i = 0;
+#if MATH_3D_SIMD_LANES
+    const m3d_float zero = m3d_set1(0.0f);
+    for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+        const m3d_float cx_v = m3d_load(cx + i), sx_v = m3d_load(sx + i);
+        const m3d_float cy_v = m3d_load(cy + i), sy_v = m3d_load(sy + i);
+        const m3d_float cz_v = m3d_load(cz + i), sz_v = m3d_load(sz + i);
+        const m3d_float s = m3d_load(scales + i);
+        const m3d_float sy_sx = m3d_mul(sy_v, sx_v), cy_sx = m3d_mul(cy_v, sx_v);
+        m3d_store(out->m[0][0] + i, m3d_mul(m3d_add(m3d_mul(cy_v, cz_v), m3d_mul(sy_sx, sz_v)), s));
+        m3d_store(out->m[0][1] + i, m3d_mul(m3d_sub(m3d_mul(sy_sx, cz_v), m3d_mul(cy_v, sz_v)), s));
+        m3d_store(out->m[0][2] + i, m3d_mul(m3d_mul(sy_v, cx_v), s));
+        m3d_store(out->m[1][0] + i, m3d_mul(m3d_mul(cx_v, sz_v), s));
+        m3d_store(out->m[1][1] + i, m3d_mul(m3d_mul(cx_v, cz_v), s));
+        m3d_store(out->m[1][2] + i, m3d_mul(m3d_sub(zero, sx_v), s));
+        m3d_store(out->m[2][0] + i, m3d_mul(m3d_sub(m3d_mul(cy_sx, sz_v), m3d_mul(sy_v, cz_v)), s));
+        m3d_store(out->m[2][1] + i, m3d_mul(m3d_add(m3d_mul(sy_v, sz_v), m3d_mul(cy_sx, cz_v)), s));
+        m3d_store(out->m[2][2] + i, m3d_mul(m3d_mul(cy_v, cx_v), s));
+    }
+#endif
+    for (; i < count; ++i) {
+        const float cx_i = cx[i], sx_i = sx[i], cy_i = cy[i], sy_i = sy[i], cz_i = cz[i], sz_i = sz[i];
+        const float s = scales[i];
+        out->m[0][0][i] = (cy_i * cz_i + sy_i * sx_i * sz_i) * s;
+        out->m[0][1][i] = (sy_i * sx_i * cz_i - cy_i * sz_i) * s;
+        out->m[0][2][i] = sy_i * cx_i * s;
+        out->m[1][0][i] = cx_i * sz_i * s;
+        out->m[1][1][i] = cx_i * cz_i * s;
+        out->m[1][2][i] = -sx_i * s;
+        out->m[2][0][i] = (cy_i * sx_i * sz_i - sy_i * cz_i) * s;
+        out->m[2][1][i] = (sy_i * sz_i + cy_i * sx_i * cz_i) * s;
+        out->m[2][2][i] = cy_i * cx_i * s;
+    }
+}
+
+/**
+ * @brief Batch affine_multiply(): a[i] * b for each of the `count` transforms in `a`, e.g. every
+ * model matrix times the same mesh dequantization. `out` must not be `a`.
+ */
+static inline void affine_multiply_batch(const Affine3fBatch* a, const Affine3f* b, int count, Affine3fBatch* out)
+{
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            const float column[4] = {b->m[0][c], b->m[1][c], b->m[2][c], 0.0f};
+            int i = 0;
+#if MATH_3D_SIMD_LANES
+            for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+                m3d_float v = m3d_row(column, m3d_load(a->m[r][0] + i), m3d_load(a->m[r][1] + i), m3d_load(a->m[r][2] + i));
+                if (c == 3) v = m3d_add(v, m3d_load(a->m[r][3] + i));
+                m3d_store(out->m[r][c] + i, v);
+            }
+#endif
+            for (; i < count; ++i) {
+                float v = a->m[r][0][i] * column[0] + a->m[r][1][i] * column[1] + a->m[r][2][i] * column[2];
+                if (c == 3) v += a->m[r][3][i];
+                out->m[r][c][i] = v;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Batch matrix_multiply_affine(): a * b[i] for each of the `count` transforms in `b`,
+ * e.g. view-projection * every model matrix.
+ */
+static inline void matrix_multiply_affine_batch(const Mat4f* a, const Affine3fBatch* b, int count, Mat4fBatch* out)
+{
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            const float row[4] = {a->m[r][0], a->m[r][1], a->m[r][2], c == 3 ? a->m[r][3] : 0.0f};
+            int i = 0;
+#if MATH_3D_SIMD_LANES
+            for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+                m3d_store(out->m[r][c] + i,
+                          m3d_row(row, m3d_load(b->m[0][c] + i), m3d_load(b->m[1][c] + i), m3d_load(b->m[2][c] + i)));
+            }
+#endif
+            for (; i < count; ++i) {
+                out->m[r][c][i] = row[0] * b->m[0][c][i] + row[1] * b->m[1][c][i] + row[2] * b->m[2][c][i] + row[3];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Batch affine_transform_point(): the same point `p` moved by each of `count` transforms,
+ * e.g. a mesh's bounding-sphere center placed by every model matrix.
+ */
+static inline void affine_transform_point_batch(const Affine3fBatch* a, Vec3f p, int count,
+                                                float* out_x, float* out_y, float* out_z)
+{
+    float* out[3] = {out_x, out_y, out_z};
+    for (int r = 0; r < 3; ++r) {
+        int i = 0;
+#if MATH_3D_SIMD_LANES
+        const m3d_float px = m3d_set1(p.x), py = m3d_set1(p.y), pz = m3d_set1(p.z);
+        for (; i + MATH_3D_SIMD_LANES <= count; i += MATH_3D_SIMD_LANES) {
+            m3d_float v = m3d_add(m3d_add(m3d_mul(m3d_load(a->m[r][0] + i), px), m3d_mul(m3d_load(a->m[r][1] + i), py)),
+                                  m3d_mul(m3d_load(a->m[r][2] + i), pz));
+            m3d_store(out[r] + i, m3d_add(v, m3d_load(a->m[r][3] + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[r][i] = a->m[r][0][i] * p.x + a->m[r][1][i] * p.y + a->m[r][2][i] * p.z + a->m[r][3][i];
+        }
+    }
+}
+
+// Transform i of a batch on its own.
+static inline Affine3f affine_from_batch(const Affine3fBatch* b, int i) {
+    Affine3f result;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) result.m[r][c] = b->m[r][c][i];
+    }
+    return result;
+}
+
+static inline Mat4f matrix_from_batch(const Mat4fBatch* b, int i) {
+    Mat4f result;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) result.m[r][c] = b->m[r][c][i];
+    }
+    return result;
+}
+
 #endif // MATH_3D_H
@@ -0,0 +1,511 @@
+#ifndef MATH_3D_FIXED_H
+#define MATH_3D_FIXED_H
+
+#include <stdint.h>
+#include "math_3d.h"
+
+// Q16.16 fixed-point versions of the vertex-path functions in math_3d.h, for targets without
+// an FPU where every float operation is a library call. Only integer multiplies, shifts and
+// table lookups are used once values have been converted.
+//
+// Range is about +-32767 with a precision of 1/65536, plenty for the coordinates the applets
+// use. Products are accumulated in 64 bits and shifted back once per dot product.
+
+typedef int32_t fix16;
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE   (1 << FIX16_SHIFT)
+#define FIX16_MAX   INT32_MAX
+
+// --- Structures ---
+
+typedef struct {
+    fix16 x, y;
+} Vec2x;
+
+typedef struct {
+    fix16 x, y, z;
+} Vec3x;
+
+typedef struct {
+    fix16 x, y, z, w;
+} Vec4x;
+
+typedef struct {
+    fix16 m[4][4];
+} Mat4x;
+
+typedef struct {
+    fix16 m[3][4];
+} Affine3x;
+
+/**
+ * @brief Fixed-point InstanceTransform (see mesh_3d.h), for placements kept in fixed point.
+ */
+typedef struct {
+    Vec3x position;
+    fix16 rotation_x, rotation_y, rotation_z; // Radians
+    fix16 scale;
+} InstanceTransformX;
+
+
+// --- Scalar Functions ---
+
+static inline MATH_3D_CONSTEXPR fix16 fix16_from_int(int i) {
+    return (fix16)(i * FIX16_ONE);
+}
+
+static inline MATH_3D_CONSTEXPR fix16 fix16_from_float(float f) {
+    return (fix16)(f * FIX16_ONE + (f >= 0.0f ? 0.5f : -0.5f));
+}
+
+static inline MATH_3D_CONSTEXPR float fix16_to_float(fix16 x) {
+    return (float)x * (1.0f / FIX16_ONE);
+}
+
+static inline MATH_3D_CONSTEXPR fix16 fix16_mul(fix16 a, fix16 b) {
+    return (fix16)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+// Number of leading zero bits of a non-zero value.
+static inline int fix16_clz(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(x);
+#else
+    int n = 0;
+    while (!(x & 0x80000000u)) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief 1 / x without a division instruction, for the perspective divide.
+ *
+ * The input is normalized to [0.5, 1), a linear first guess is refined with three Newton-Raphson
+ * steps (each doubling the correct bits) and the result is shifted back. Saturates to +-FIX16_MAX
+ * for tiny inputs, including 0.
+ */
+static inline fix16 fix16_reciprocal(fix16 x) {
+    if (x == 0) return FIX16_MAX;
+    const bool negative = x < 0;
+    const uint32_t magnitude = negative ? (uint32_t)0 - (uint32_t)x : (uint32_t)x;
+
+    // d: the input scaled into [0.5, 1) as Q1.31. y: its reciprocal in (1, 2] as Q2.30.
+    const int n = fix16_clz(magnitude);
+    const uint64_t d = (uint64_t)(magnitude << n) >> 1;
+    uint64_t y = 3031741621u - ((2021161081u * d) >> 31); // 48/17 - 32/17 * d
+    for (int i = 0; i < 3; ++i) {
+        const uint64_t dy = (d * y) >> 31;                  // ~1.0 in Q2.30
+        y = (y * ((2u << 30) - dy)) >> 30;
+    }
+
+    // 1/x = y * 2^(n - 16), and the result has 16 fraction bits, so it is y * 2^n in Q2.30.
+    uint64_t result;
+    if (n < 30) {
+        result = (y + ((uint64_t)1 << (29 - n))) >> (30 - n);
+    } else {
+        result = y << (n - 30);
+    }
+    if (result > FIX16_MAX) result = FIX16_MAX;
+    return negative ? -(fix16)result : (fix16)result;
+}
+
+/**
+ * @brief num / den clamped to [0, 1], for interpolation factors. The denominator is brought to
+ * 17 significant bits and inverted with fix16_reciprocal(), so the result is good to about 4e-5.
+ */
+static inline fix16 fix16_ratio(int64_t num, int64_t den) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    if (num <= 0) return 0;
+    if (num >= den) return FIX16_ONE;
+    const int bits = (den >> 32) ? 64 - fix16_clz((uint32_t)(den >> 32)) : 32 - fix16_clz((uint32_t)den);
+    if (bits > 17) {
+        num >>= bits - 17;
+        den >>= bits - 17;
+    } else {
+        num <<= 17 - bits;
+        den <<= 17 - bits;
+    }
+    return (fix16)((num * fix16_reciprocal((fix16)den)) >> FIX16_SHIFT);
+}
+
+// sin() over the first quarter turn, at 65 evenly spaced angles, in Q16.16.
+static const fix16 FIX16_SIN_TABLE[65] = {
+    0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65536,
+};
+
+// sin() of a position 0..0x4000 within the first quarter turn, interpolating the table.
+static inline fix16 fix16_sin_quarter(uint32_t pos) {
+    const uint32_t index = pos >> 8;
+    if (index >= 64) return FIX16_SIN_TABLE[64];
+    const fix16 a = FIX16_SIN_TABLE[index];
+    const fix16 b = FIX16_SIN_TABLE[index + 1];
+    return a + (((b - a) * (fix16)(pos & 0xFF)) >> 8);
+}
+
+/**
+ * @brief sin() of an angle given as a fraction of a full turn, 0x10000 being one turn.
+ * Accurate to about 1e-4.
+ */
+static inline fix16 fix16_sin_turns(uint32_t turns) {
+    const uint32_t phase = turns & 0xFFFF;
+    const uint32_t pos = phase & 0x3FFF;
+    switch (phase >> 14) {
+        case 0:  return fix16_sin_quarter(pos);
+        case 1:  return fix16_sin_quarter(0x4000 - pos);
+        case 2:  return -fix16_sin_quarter(pos);
+        default: return -fix16_sin_quarter(0x4000 - pos);
+    }
+}
+
+// Radians to turns: multiply by 1 / (2 pi), kept as Q0.32 so big angles stay accurate.
+static inline uint32_t fix16_radians_to_turns(fix16 angle_rad) {
+    return (uint32_t)(((int64_t)angle_rad * 683565276) >> 32);
+}
+
+static inline fix16 fix16_sin(fix16 angle_rad) {
+    return fix16_sin_turns(fix16_radians_to_turns(angle_rad));
+}
+
+static inline fix16 fix16_cos(fix16 angle_rad) {
+    return fix16_sin_turns(fix16_radians_to_turns(angle_rad) + 0x4000);
+}
+
+
+// --- Vector Functions ---
+
+static inline fix16 vec3_x_dot(Vec3x a, Vec3x b) {
+    return (fix16)(((int64_t)a.x * b.x + (int64_t)a.y * b.y + (int64_t)a.z * b.z) >> FIX16_SHIFT);
+}
+
+
+// --- Conversions ---
+
+static inline MATH_3D_CONSTEXPR Vec3x vec3_to_fixed(Vec3f v) {
+    Vec3x result = {fix16_from_float(v.x), fix16_from_float(v.y), fix16_from_float(v.z)};
+    return result;
+}
+
+static inline MATH_3D_CONSTEXPR Vec3f vec3_from_fixed(Vec3x v) {
+    Vec3f result = {fix16_to_float(v.x), fix16_to_float(v.y), fix16_to_float(v.z)};
+    return result;
+}
+
+static inline MATH_3D_CONSTEXPR Vec4x vec4_to_fixed(Vec4f v) {
+    Vec4x result = {fix16_from_float(v.x), fix16_from_float(v.y), fix16_from_float(v.z), fix16_from_float(v.w)};
+    return result;
+}
+
+/**
+ * @brief Converts e.g. a view-projection matrix that is built once per frame in float.
+ */
+static inline MATH_3D_CONSTEXPR Mat4x matrix_to_fixed(const Mat4f* m) {
+    Mat4x result = {{{0}}};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result.m[i][j] = fix16_from_float(m->m[i][j]);
+        }
+    }
+    return result;
+}
+
+static inline MATH_3D_CONSTEXPR Affine3x affine_to_fixed(const Affine3f* a) {
+    Affine3x result = {{{0}}};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result.m[i][j] = fix16_from_float(a->m[i][j]);
+        }
+    }
+    return result;
+}
+
+
+// --- Transform Functions ---
+
+// Dot product of a matrix row with (x, y, z, 1), rounded once.
+static inline fix16 fix16_row(const fix16* r, fix16 x, fix16 y, fix16 z) {
+    const int64_t sum = (int64_t)r[0] * x + (int64_t)r[1] * y + (int64_t)r[2] * z + ((int64_t)r[3] << FIX16_SHIFT);
+    return (fix16)(sum >> FIX16_SHIFT);
+}
+
+/**
+ * @brief Fixed-point affine_trs_euler(): translate * rotate_y * rotate_x * rotate_z * scale,
+ * with the sines and cosines taken from the table.
+ */
+static inline Affine3x affine_x_trs_euler(Vec3x position, fix16 rotation_x_rad, fix16 rotation_y_rad,
+                                          fix16 rotation_z_rad, fix16 scale) {
+    const fix16 cx = fix16_cos(rotation_x_rad), sx = fix16_sin(rotation_x_rad);
+    const fix16 cy = fix16_cos(rotation_y_rad), sy = fix16_sin(rotation_y_rad);
+    const fix16 cz = fix16_cos(rotation_z_rad), sz = fix16_sin(rotation_z_rad);
+    const fix16 sy_sx = fix16_mul(sy, sx);
+    const fix16 cy_sx = fix16_mul(cy, sx);
+    Affine3x result = {{
+        {fix16_mul(fix16_mul(cy, cz) + fix16_mul(sy_sx, sz), scale),
+         fix16_mul(fix16_mul(sy_sx, cz) - fix16_mul(cy, sz), scale),
+         fix16_mul(fix16_mul(sy, cx), scale),
+         position.x},
+        {fix16_mul(fix16_mul(cx, sz), scale),
+         fix16_mul(fix16_mul(cx, cz), scale),
+         fix16_mul(-sx, scale),
+         position.y},
+        {fix16_mul(fix16_mul(cy_sx, sz) - fix16_mul(sy, cz), scale),
+         fix16_mul(fix16_mul(sy, sz) + fix16_mul(cy_sx, cz), scale),
+         fix16_mul(fix16_mul(cy, cx), scale),
+         position.z}
+    }};
+    return result;
+}
+
+/**
+ * @brief Fixed-point matrix_multiply_affine(): a * b, e.g. view-projection * model.
+ */
+static inline Mat4x matrix_x_multiply_affine(const Mat4x* a, const Affine3x* b) {
+    Mat4x result;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            int64_t sum = (int64_t)a->m[i][0] * b->m[0][j] + (int64_t)a->m[i][1] * b->m[1][j] +
+                          (int64_t)a->m[i][2] * b->m[2][j];
+            if (j == 3) sum += (int64_t)a->m[i][3] << FIX16_SHIFT;
+            result.m[i][j] = (fix16)(sum >> FIX16_SHIFT);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Fixed-point affine_multiply(): a * b, applying b first.
+ */
+static inline Affine3x affine_x_multiply(const Affine3x* a, const Affine3x* b) {
+    Affine3x result;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            int64_t sum = (int64_t)a->m[i][0] * b->m[0][j] + (int64_t)a->m[i][1] * b->m[1][j] +
+                          (int64_t)a->m[i][2] * b->m[2][j];
+            if (j == 3) sum += (int64_t)a->m[i][3] << FIX16_SHIFT;
+            result.m[i][j] = (fix16)(sum >> FIX16_SHIFT);
+        }
+    }
+    return result;
+}
+
+static inline Vec3x affine_x_transform_point(const Affine3x* a, Vec3x p) {
+    Vec3x result = {
+        fix16_row(a->m[0], p.x, p.y, p.z),
+        fix16_row(a->m[1], p.x, p.y, p.z),
+        fix16_row(a->m[2], p.x, p.y, p.z)
+    };
+    return result;
+}
+
+/**
+ * @brief Fixed-point affine_inverse_rotate(). The result is scaled by the transform's scale.
+ */
+static inline Vec3x affine_x_inverse_rotate(const Affine3x* a, Vec3x v) {
+    Vec3x result = {
+        (fix16)(((int64_t)a->m[0][0] * v.x + (int64_t)a->m[1][0] * v.y + (int64_t)a->m[2][0] * v.z) >> FIX16_SHIFT),
+        (fix16)(((int64_t)a->m[0][1] * v.x + (int64_t)a->m[1][1] * v.y + (int64_t)a->m[2][1] * v.z) >> FIX16_SHIFT),
+        (fix16)(((int64_t)a->m[0][2] * v.x + (int64_t)a->m[1][2] * v.y + (int64_t)a->m[2][2] * v.z) >> FIX16_SHIFT)
+    };
+    return result;
+}
+
+/**
+ * @brief Fixed-point sphere_outside_frustum(), with planes from vec4_to_fixed(frustum_planes()).
+ */
+static inline bool sphere_x_outside_frustum(const Vec4x planes[6], Vec3x center, fix16 radius) {
+    for (int i = 0; i < 6; ++i) {
+        const int64_t distance = (int64_t)planes[i].x * center.x + (int64_t)planes[i].y * center.y +
+                                 (int64_t)planes[i].z * center.z + ((int64_t)planes[i].w << FIX16_SHIFT);
+        if (distance < -((int64_t)radius << FIX16_SHIFT)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Fixed-point sphere_projected_radius(). Spheres reaching behind the camera give FIX16_MAX.
+ */
+static inline fix16 sphere_x_projected_radius(const Mat4x* vp, Vec3x center, fix16 radius, fix16 pixels_per_unit) {
+    const fix16 w = fix16_row(vp->m[3], center.x, center.y, center.z);
+    if (w <= radius) {
+        return FIX16_MAX;
+    }
+    return fix16_mul(fix16_mul(radius, pixels_per_unit), fix16_reciprocal(w));
+}
+
+/**
+ * @brief Fixed-point clip_outcode(). `guard_band` is a whole number of viewports.
+ */
+static inline int clip_outcode_x(fix16 x, fix16 y, fix16 z, fix16 w, int guard_band) {
+    int code = 0;
+    if (x < -w) code |= CLIP_LEFT;
+    if (x > w)  code |= CLIP_RIGHT;
+    if (y < -w) code |= CLIP_BOTTOM;
+    if (y > w)  code |= CLIP_TOP;
+    if (z < -w) code |= CLIP_NEAR;
+    const int64_t g = (int64_t)guard_band * w;
+    if (x < -g || x > g || y < -g || y > g) code |= CLIP_GUARD;
+    return code;
+}
+
+/**
+ * @brief Fixed-point clip_polygon_plane(), for planes with whole-number coefficients.
+ */
+static inline int clip_polygon_plane_x(const Vec4x* in, int count, Vec4x* out, int a, int b, int c, int d) {
+    int out_count = 0;
+    for (int i = 0; i < count; ++i) {
+        const Vec4x* cur = &in[i];
+        const Vec4x* next = &in[(i + 1) % count];
+        const int64_t d_cur = (int64_t)a * cur->x + (int64_t)b * cur->y + (int64_t)c * cur->z + (int64_t)d * cur->w;
+        const int64_t d_next = (int64_t)a * next->x + (int64_t)b * next->y + (int64_t)c * next->z + (int64_t)d * next->w;
+        if (d_cur >= 0) {
+            out[out_count++] = *cur;
+        }
+        if ((d_cur >= 0) != (d_next >= 0)) {
+            const fix16 t = fix16_ratio(d_cur, d_cur - d_next);
+            out[out_count++] = (Vec4x){
+                cur->x + (fix16)((((int64_t)next->x - cur->x) * t) >> FIX16_SHIFT),
+                cur->y + (fix16)((((int64_t)next->y - cur->y) * t) >> FIX16_SHIFT),
+                cur->z + (fix16)((((int64_t)next->z - cur->z) * t) >> FIX16_SHIFT),
+                cur->w + (fix16)((((int64_t)next->w - cur->w) * t) >> FIX16_SHIFT)
+            };
+        }
+    }
+    return out_count;
+}
+
+/**
+ * @brief Fixed-point clip_triangle(). `guard_band` is a whole number of viewports.
+ */
+static inline int clip_triangle_x(const Vec4x* tri, int outcode_union, int guard_band, Vec4x* out) {
+    Vec4x buffer[CLIP_MAX_VERTICES];
+    Vec4x* src = out;
+    Vec4x* dst = buffer;
+    int count = 3;
+    src[0] = tri[0];
+    src[1] = tri[1];
+    src[2] = tri[2];
+
+    const int planes[5][4] = {
+        {0, 0, 1, 1},
+        {1, 0, 0, guard_band},
+        {-1, 0, 0, guard_band},
+        {0, 1, 0, guard_band},
+        {0, -1, 0, guard_band},
+    };
+    for (int p = 0; p < 5 && count >= 3; ++p) {
+        if (p == 0 && !(outcode_union & CLIP_NEAR)) continue;
+        if (p > 0 && !(outcode_union & CLIP_GUARD)) break;
+        count = clip_polygon_plane_x(src, count, dst, planes[p][0], planes[p][1], planes[p][2], planes[p][3]);
+        Vec4x* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != out) {
+        for (int i = 0; i < count; ++i) out[i] = src[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Fixed-point clip_to_screen_subpixel(), for a vertex with w > 0. out_inv_w receives 1 / w.
+ */
+static inline Vec2x clip_to_screen_subpixel_x(const Vec4x* v, int screen_w, int screen_h, fix16* out_inv_w) {
+    const fix16 inv_w = fix16_reciprocal(v->w);
+    const int64_t ndc_x = ((int64_t)v->x * inv_w) >> FIX16_SHIFT;
+    const int64_t ndc_y = ((int64_t)v->y * inv_w) >> FIX16_SHIFT;
+    *out_inv_w = inv_w;
+    return (Vec2x){ (fix16)(((ndc_x + FIX16_ONE) * screen_w) / 2), (fix16)(((FIX16_ONE - ndc_y) * screen_h) / 2) };
+}
+
+
+// --- Batch Functions ---
+
+/**
+ * @brief Fixed-point transform_points(). Any of the outputs may be NULL.
+ */
+static inline void transform_points_x(const Mat4x* m, const fix16* xs, const fix16* ys, const fix16* zs, int count,
+                                      fix16* out_x, fix16* out_y, fix16* out_z, fix16* out_w)
+{
+    for (int i = 0; i < count; ++i) {
+        const fix16 x = xs[i], y = ys[i], z = zs[i];
+        if (out_x) out_x[i] = fix16_row(m->m[0], x, y, z);
+        if (out_y) out_y[i] = fix16_row(m->m[1], x, y, z);
+        if (out_z) out_z[i] = fix16_row(m->m[2], x, y, z);
+        if (out_w) out_w[i] = fix16_row(m->m[3], x, y, z);
+    }
+}
+
+/**
+ * @brief Fixed-point project_points(), dividing by w with fix16_reciprocal().
+ *
+ * out_inv_w (may be NULL) receives 1 / w, e.g. for depth. It is 0 for points behind the camera.
+ */
+static inline void project_points_x(const Mat4x* mvp, const fix16* xs, const fix16* ys, const fix16* zs, int count,
+                                    int screen_w, int screen_h, int* out_sx, int* out_sy, bool* out_visible,
+                                    fix16* out_inv_w)
+{
+    const fix16 min_w = FIX16_ONE / 1000; // Same cut-off as project_vertex()
+    for (int i = 0; i < count; ++i) {
+        const fix16 x = xs[i], y = ys[i], z = zs[i];
+        const fix16 clip_w = fix16_row(mvp->m[3], x, y, z);
+        out_visible[i] = clip_w >= min_w;
+        if (!out_visible[i]) {
+            out_sx[i] = 0;
+            out_sy[i] = 0;
+            if (out_inv_w) out_inv_w[i] = 0;
+            continue;
+        }
+        const fix16 inv_w = fix16_reciprocal(clip_w);
+        const int64_t ndc_x = ((int64_t)fix16_row(mvp->m[0], x, y, z) * inv_w) >> FIX16_SHIFT;
+        const int64_t ndc_y = ((int64_t)fix16_row(mvp->m[1], x, y, z) * inv_w) >> FIX16_SHIFT;
+        // (ndc + 1) / 2 * size, truncated towards zero like the float version.
+        out_sx[i] = (int)(((ndc_x + FIX16_ONE) * screen_w) / (2 * FIX16_ONE));
+        out_sy[i] = (int)(((FIX16_ONE - ndc_y) * screen_h) / (2 * FIX16_ONE));
+        if (out_inv_w) out_inv_w[i] = inv_w;
+    }
+}
+
+/**
+ * @brief project_points_x() without the rounding: the screen positions are in fix16 pixels.
+ */
+static inline void project_points_subpixel_x(const Mat4x* mvp, const fix16* xs, const fix16* ys, const fix16* zs,
+                                             int count, int screen_w, int screen_h, fix16* out_sx, fix16* out_sy,
+                                             bool* out_visible, fix16* out_inv_w)
+{
+    const fix16 min_w = FIX16_ONE / 1000;
+    for (int i = 0; i < count; ++i) {
+        const fix16 x = xs[i], y = ys[i], z = zs[i];
+        const fix16 clip_w = fix16_row(mvp->m[3], x, y, z);
+        out_visible[i] = clip_w >= min_w;
+        if (!out_visible[i]) {
+            out_sx[i] = 0;
+            out_sy[i] = 0;
+            if (out_inv_w) out_inv_w[i] = 0;
+            continue;
+        }
+        const fix16 inv_w = fix16_reciprocal(clip_w);
+        const int64_t ndc_x = ((int64_t)fix16_row(mvp->m[0], x, y, z) * inv_w) >> FIX16_SHIFT;
+        const int64_t ndc_y = ((int64_t)fix16_row(mvp->m[1], x, y, z) * inv_w) >> FIX16_SHIFT;
+        out_sx[i] = (fix16)(((ndc_x + FIX16_ONE) * screen_w) / 2);
+        out_sy[i] = (fix16)(((FIX16_ONE - ndc_y) * screen_h) / 2);
+        if (out_inv_w) out_inv_w[i] = inv_w;
+    }
+}
+
+#endif // MATH_3D_FIXED_H
@@ -0,0 +1,493 @@
+#ifndef MESH_3D_H
+#define MESH_3D_H
+
+#include "math_3d.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Structures ---
+
+/**
+ * @brief An indexed triangle mesh plus data precomputed from it.
+ *
+ * The vertex and index arrays are not copied, so they must outlive the mesh (they're usually
+ * global constants). Build meshes with mesh_make(), or mesh_make_quantized() for the compact
+ * format written by tools/jamesh_convert. Read the geometry through mesh_vertex(), mesh_index()
+ * and friends, which handle both.
+ */
+typedef struct Mesh {
+    const Vec3f* vertices;
+    int num_vertices;
+    const int* indices;       // Three per triangle
+    int num_indices;
+    const Vec3f* face_normals; // One unit normal per triangle, in model space
+    const Vec3f* vertex_normals; // One unit normal per vertex for smooth shading, or NULL for flat
+    const float* uvs;         // Texture coordinates (u, v) per index, in texture widths/heights, or NULL
+    Vec3f bounds_min;         // Axis-aligned bounding box
+    Vec3f bounds_max;
+    Vec3f bounds_center;      // Bounding sphere
+    float bounds_radius;
+
+    // Quantized meshes leave `vertices`, `indices` and `face_normals` NULL and use these instead.
+    const int16_t* quantized_vertices; // x, y, z per vertex
+    Vec3f quantize_scale;     // Model position = quantize_offset + quantized * quantize_scale
+    Vec3f quantize_offset;
+    const uint8_t* indices8;  // Meshes with up to 256 vertices
+    const uint16_t* indices16; // Bigger meshes
+    const uint16_t* packed_face_normals;   // Octahedral, see normal_unpack()
+    const uint16_t* packed_vertex_normals; // Or NULL (a float `vertex_normals` array also works)
+
+    // Levels of detail, see mesh_select_lod().
+    const struct Mesh* lods;  // Coarser and coarser versions, sharing this mesh's vertices
+    int num_lods;
+    float lod_error;          // For a LOD: how far the full mesh's vertices lie from it, in model units
+} Mesh;
+
+/**
+ * @brief Placement of one copy of a mesh: translate * rotate_y * rotate_x * rotate_z * scale,
+ * the same order as affine_trs_euler().
+ */
+typedef struct {
+    Vec3f position;
+    float rotation_x, rotation_y, rotation_z; // Radians
+    float scale;
+} InstanceTransform;
+
+
+// --- Packed Normals ---
+
+/**
+ * @brief Packs a unit vector into 16 bits: the octahedral mapping, 8 bits per axis.
+ * Good to about a degree, which is plenty for lighting.
+ */
+static inline uint16_t normal_pack(Vec3f n)
+{
+    float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+    if (l1 == 0.0f) {
+        return (127 << 8) | 127;
+    }
+    float x = n.x / l1, y = n.y / l1;
+    if (n.z < 0.0f) {
+        // Fold the lower half of the octahedron over the upper one.
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    // 0..254 so that 0 is exact.
+    int qx = (int)lrintf((x + 1.0f) * 127.0f);
+    int qy = (int)lrintf((y + 1.0f) * 127.0f);
+    return (uint16_t)((qx << 8) | qy);
+}
+
+static inline Vec3f normal_unpack(uint16_t packed)
+{
+    float x = (packed >> 8) / 127.0f - 1.0f;
+    float y = (packed & 0xFF) / 127.0f - 1.0f;
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f) {
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    return vec3_normalize((Vec3f){x, y, z});
+}
+
+
+// --- Mesh Access ---
+
+static inline Vec3f mesh_vertex(const Mesh* mesh, int v)
+{
+    if (mesh->vertices) {
+        return mesh->vertices[v];
+    }
+    const int16_t* q = &mesh->quantized_vertices[v * 3];
+    return (Vec3f){
+        mesh->quantize_offset.x + q[0] * mesh->quantize_scale.x,
+        mesh->quantize_offset.y + q[1] * mesh->quantize_scale.y,
+        mesh->quantize_offset.z + q[2] * mesh->quantize_scale.z
+    };
+}
+
+static inline int mesh_index(const Mesh* mesh, int i)
+{
+    if (mesh->indices) {
+        return mesh->indices[i];
+    }
+    return mesh->indices8 ? mesh->indices8[i] : mesh->indices16[i];
+}
+
+// Unit normal of triangle `t`.
+static inline Vec3f mesh_face_normal(const Mesh* mesh, int t)
+{
+    return mesh->face_normals ? mesh->face_normals[t] : normal_unpack(mesh->packed_face_normals[t]);
+}
+
+static inline bool mesh_has_vertex_normals(const Mesh* mesh)
+{
+    return mesh->vertex_normals != NULL || mesh->packed_vertex_normals != NULL;
+}
+
+static inline Vec3f mesh_vertex_normal(const Mesh* mesh, int v)
+{
+    return mesh->vertex_normals ? mesh->vertex_normals[v] : normal_unpack(mesh->packed_vertex_normals[v]);
+}
+
+static inline bool mesh_is_quantized(const Mesh* mesh)
+{
+    return mesh->vertices == NULL;
+}
+
+/**
+ * @brief For quantized meshes, the rest of the dequantization once the vertex transform has read
+ * each quantized coordinate q as q / 65536 (its bits taken as Q16.16, so loading costs nothing in
+ * fixed point). Fold it into the model matrix to transform the stored positions directly.
+ */
+static inline Affine3f mesh_dequantize_affine(const Mesh* mesh)
+{
+    Affine3f a = {{
+        {mesh->quantize_scale.x * 65536.0f, 0, 0, mesh->quantize_offset.x},
+        {0, mesh->quantize_scale.y * 65536.0f, 0, mesh->quantize_offset.y},
+        {0, 0, mesh->quantize_scale.z * 65536.0f, mesh->quantize_offset.z}
+    }};
+    return a;
+}
+
+
+// --- Mesh Functions ---
+
+// Bounding box, then a sphere around the box's center that holds every vertex.
+static inline void mesh_compute_bounds(Mesh* mesh)
+{
+    mesh->bounds_min = mesh->bounds_max = mesh->num_vertices > 0 ? mesh_vertex(mesh, 0) : (Vec3f){0, 0, 0};
+    for (int v = 1; v < mesh->num_vertices; ++v) {
+        Vec3f p = mesh_vertex(mesh, v);
+        mesh->bounds_min = (Vec3f){fminf(mesh->bounds_min.x, p.x), fminf(mesh->bounds_min.y, p.y), fminf(mesh->bounds_min.z, p.z)};
+        mesh->bounds_max = (Vec3f){fmaxf(mesh->bounds_max.x, p.x), fmaxf(mesh->bounds_max.y, p.y), fmaxf(mesh->bounds_max.z, p.z)};
+    }
+    mesh->bounds_center = (Vec3f){
+        (mesh->bounds_min.x + mesh->bounds_max.x) * 0.5f,
+        (mesh->bounds_min.y + mesh->bounds_max.y) * 0.5f,
+        (mesh->bounds_min.z + mesh->bounds_max.z) * 0.5f
+    };
+    mesh->bounds_radius = 0.0f;
+    for (int v = 0; v < mesh->num_vertices; ++v) {
+        mesh->bounds_radius = fmaxf(mesh->bounds_radius, vec3_length(vec3_subtract(mesh_vertex(mesh, v), mesh->bounds_center)));
+    }
+}
+
+/**
+ * @brief Creates a mesh, computing its face normals and bounds.
+ *
+ * @param normals_storage Room for num_indices / 3 normals. Filled here and referenced by the mesh.
+ */
+static inline Mesh mesh_make(const Vec3f* vertices, int num_vertices, const int* indices, int num_indices,
+                             Vec3f* normals_storage)
+{
+    Mesh mesh;
+    mesh.vertices = vertices;
+    mesh.num_vertices = num_vertices;
+    mesh.indices = indices;
+    mesh.num_indices = num_indices;
+    mesh.face_normals = normals_storage;
+    mesh.vertex_normals = NULL;
+    mesh.uvs = NULL;
+    mesh.quantized_vertices = NULL;
+    mesh.quantize_scale = (Vec3f){1, 1, 1};
+    mesh.quantize_offset = (Vec3f){0, 0, 0};
+    mesh.indices8 = NULL;
+    mesh.indices16 = NULL;
+    mesh.packed_face_normals = NULL;
+    mesh.packed_vertex_normals = NULL;
+    mesh.lods = NULL;
+    mesh.num_lods = 0;
+    mesh.lod_error = 0.0f;
+
+    // Face normals, with the same winding as the cross product used for lighting before.
+    for (int i = 0; i + 2 < num_indices; i += 3) {
+        Vec3f edge1 = vec3_subtract(vertices[indices[i+1]], vertices[indices[i]]);
+        Vec3f edge2 = vec3_subtract(vertices[indices[i+2]], vertices[indices[i]]);
+        normals_storage[i / 3] = vec3_normalize(vec3_cross(edge1, edge2));
+    }
+
+    mesh_compute_bounds(&mesh);
+    return mesh;
+}
+
+/**
+ * @brief Creates a mesh from the compact format written by tools/jamesh_convert: int16 positions
+ * with a per-mesh scale and offset, 8- or 16-bit indices and octahedral normals. Nothing is
+ * decoded up front, so the arrays can stay in flash.
+ *
+ * @param indices8 Indices for meshes with up to 256 vertices, or NULL to use `indices16`.
+ * @param packed_vertex_normals Per-vertex normals for smooth shading, or NULL.
+ */
+static inline Mesh mesh_make_quantized(const int16_t* positions, int num_vertices, Vec3f scale, Vec3f offset,
+                                       const uint8_t* indices8, const uint16_t* indices16, int num_indices,
+                                       const uint16_t* packed_face_normals, const uint16_t* packed_vertex_normals)
+{
+    Mesh mesh;
+    mesh.vertices = NULL;
+    mesh.num_vertices = num_vertices;
+    mesh.indices = NULL;
+    mesh.num_indices = num_indices;
+    mesh.face_normals = NULL;
+    mesh.vertex_normals = NULL;
+    mesh.uvs = NULL;
+    mesh.quantized_vertices = positions;
+    mesh.quantize_scale = scale;
+    mesh.quantize_offset = offset;
+    mesh.indices8 = indices8;
+    mesh.indices16 = indices8 ? NULL : indices16;
+    mesh.packed_face_normals = packed_face_normals;
+    mesh.packed_vertex_normals = packed_vertex_normals;
+    mesh.lods = NULL;
+    mesh.num_lods = 0;
+    mesh.lod_error = 0.0f;
+    mesh_compute_bounds(&mesh);
+    return mesh;
+}
+
+/**
+ * @brief Returns `mesh` with vertex normals, for smooth (Gouraud) shading. Each is the average
+ * of the surrounding faces' normals, weighted by their area.
+ *
+ * @param normals_storage Room for mesh.num_vertices normals. Filled here and referenced by the mesh.
+ */
+static inline Mesh mesh_with_vertex_normals(Mesh mesh, Vec3f* normals_storage)
+{
+    for (int v = 0; v < mesh.num_vertices; ++v) {
+        normals_storage[v] = (Vec3f){0, 0, 0};
+    }
+    for (int i = 0; i + 2 < mesh.num_indices; i += 3) {
+        // The unnormalized cross product is twice the triangle's area long.
+        Vec3f p0 = mesh_vertex(&mesh, mesh_index(&mesh, i));
+        Vec3f edge1 = vec3_subtract(mesh_vertex(&mesh, mesh_index(&mesh, i+1)), p0);
+        Vec3f edge2 = vec3_subtract(mesh_vertex(&mesh, mesh_index(&mesh, i+2)), p0);
+        Vec3f n = vec3_cross(edge1, edge2);
+        for (int c = 0; c < 3; ++c) {
+            Vec3f* sum = &normals_storage[mesh_index(&mesh, i + c)];
+            *sum = (Vec3f){sum->x + n.x, sum->y + n.y, sum->z + n.z};
+        }
+    }
+    for (int v = 0; v < mesh.num_vertices; ++v) {
+        normals_storage[v] = vec3_normalize(normals_storage[v]);
+    }
+    mesh.vertex_normals = normals_storage;
+    return mesh;
+}
+
+/**
+ * @brief Returns `mesh` with texture coordinates from a box projection: each triangle takes its
+ * (u, v) from the two model-space axes its face normal points along the least. Good enough for
+ * rocks and flat surfaces, which need no unwrapping.
+ *
+ * UVs are stored per index rather than per vertex, so triangles sharing a vertex can still be
+ * projected along different axes.
+ *
+ * @param uv_storage Room for mesh.num_indices * 2 floats. Filled here and referenced by the mesh.
+ * @param scale Texture repeats per model-space unit.
+ */
+static inline Mesh mesh_with_box_uvs(Mesh mesh, float* uv_storage, float scale)
+{
+    for (int i = 0; i + 2 < mesh.num_indices; i += 3) {
+        Vec3f n = mesh_face_normal(&mesh, i / 3);
+        float ax = fabsf(n.x), ay = fabsf(n.y), az = fabsf(n.z);
+        for (int c = 0; c < 3; ++c) {
+            Vec3f p = mesh_vertex(&mesh, mesh_index(&mesh, i + c));
+            float u, v;
+            if (ax >= ay && ax >= az) {
+                u = p.z; v = p.y;
+            } else if (ay >= az) {
+                u = p.x; v = p.z;
+            } else {
+                u = p.x; v = p.y;
+            }
+            uv_storage[(i + c) * 2] = u * scale;
+            uv_storage[(i + c) * 2 + 1] = v * scale;
+        }
+    }
+    mesh.uvs = uv_storage;
+    return mesh;
+}
+
+/**
+ * @brief Returns `mesh` with levels of detail, coarsest last. Each LOD is a mesh over the same
+ * vertices with fewer triangles and its `lod_error` set, as written by tools/jamesh_convert --lods.
+ */
+static inline Mesh mesh_with_lods(Mesh mesh, const Mesh* lods, int num_lods)
+{
+    mesh.lods = lods;
+    mesh.num_lods = num_lods;
+    return mesh;
+}
+
+static inline Mesh mesh_with_lod_error(Mesh lod, float error)
+{
+    lod.lod_error = error;
+    return lod;
+}
+
+/**
+ * @brief The coarsest level of detail that still looks right when the mesh's bounding sphere
+ * covers `projected_radius` pixels (see sphere_projected_radius()): its error must stay under
+ * `max_pixel_error` pixels. Returns the mesh itself if it has no LODs or none is good enough.
+ */
+static inline const Mesh* mesh_select_lod(const Mesh* mesh, float projected_radius, float max_pixel_error)
+{
+    const Mesh* selected = mesh;
+    for (int i = 0; i < mesh->num_lods; ++i) {
+        if (mesh->lods[i].lod_error * projected_radius > max_pixel_error * mesh->bounds_radius) {
+            break;
+        }
+        selected = &mesh->lods[i];
+    }
+    return selected;
+}
+
+/**
+ * @brief True if the mesh, placed by `model_matrix`, is entirely outside the view volume given
+ * by world-space `planes` from frustum_planes(). `scale` is the model's (uniform) scale.
+ */
+static inline bool mesh_outside_frustum(const Mesh* mesh, const Vec4f planes[6], const Affine3f* model_matrix, float scale) {
+    Vec3f center = affine_transform_point(model_matrix, mesh->bounds_center);
+    return sphere_outside_frustum(planes, center, mesh->bounds_radius * fabsf(scale));
+}
+
+static inline int mesh_num_triangles(const Mesh* mesh) {
+    return mesh->num_indices / 3;
+}
+
+
+// --- Binary Meshes ---
+
+/*
+ * Binary mesh file, written by `tools/jamesh_convert --bin`:
+ *
+ *   MeshFileHeader
+ *   MeshFileLod[num_lods]
+ *   positions        int16 x, y, z per vertex
+ *   indices          uint8 or uint16, three per triangle, for the full mesh and then each LOD
+ *   face normals     uint16 per triangle, octahedral (normal_pack()), likewise
+ *   vertex normals   uint16 per vertex, if the mesh has them
+ *
+ * Each array starts on a 4-byte boundary. All fields are little-endian. mesh_from_memory()
+ * points the mesh straight into the data, so a file can be memory-mapped or linked into flash.
+ */
+#define MESH_FILE_MAGIC 0x48534D4Au // "JMSH"
+#define MESH_FILE_VERSION 2
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t index_size;            // Bytes per index: 1 or 2
+    uint32_t num_vertices;
+    uint32_t num_indices;
+    float scale[3];                 // Model position = offset + quantized * scale
+    float offset[3];
+    uint32_t positions_offset;      // Byte offsets from the start of the file
+    uint32_t indices_offset;
+    uint32_t face_normals_offset;
+    uint32_t vertex_normals_offset; // 0 if the mesh has no vertex normals
+    uint32_t file_size;
+    uint32_t num_lods;              // Entries in the MeshFileLod table right after this header
+} MeshFileHeader;
+
+typedef struct {
+    uint32_t num_indices;
+    uint32_t indices_offset;
+    uint32_t face_normals_offset;
+    float error;                    // Mesh::lod_error
+} MeshFileLod;
+
+// True if `bytes` at `offset` lie inside the file described by `header`, past the header.
+static inline bool mesh_file_range_ok(const MeshFileHeader* header, uint32_t offset, uint64_t bytes)
+{
+    return offset % 4 == 0 && offset >= sizeof(MeshFileHeader) && offset + bytes <= header->file_size;
+}
+
+// Checks one index set of a mesh file, returning its indices through `indices8` or `indices16`.
+static inline bool mesh_file_indices_ok(const MeshFileHeader* h, uint32_t num_indices, uint32_t indices_offset,
+                                        uint32_t face_normals_offset, const uint8_t** indices8, const uint16_t** indices16)
+{
+    if (num_indices % 3 != 0 || num_indices > INT32_MAX / 2 ||
+        !mesh_file_range_ok(h, indices_offset, (uint64_t)num_indices * h->index_size) ||
+        !mesh_file_range_ok(h, face_normals_offset, (uint64_t)(num_indices / 3) * sizeof(uint16_t))) {
+        return false;
+    }
+    const uint8_t* base = (const uint8_t*)h;
+    *indices8 = h->index_size == 1 ? base + indices_offset : NULL;
+    *indices16 = h->index_size == 2 ? (const uint16_t*)(base + indices_offset) : NULL;
+    // Check the indices once here so drawing never has to.
+    for (uint32_t i = 0; i < num_indices; ++i) {
+        if ((*indices8 ? (*indices8)[i] : (*indices16)[i]) >= h->num_vertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Makes `out` a view of a binary mesh already in memory (4-byte aligned). The data must
+ * outlive the mesh.
+ *
+ * @param lod_storage Room for up to `max_lods` meshes to hold the file's levels of detail, which
+ *                    `out` then refers to. Can be NULL (with `max_lods` 0) to skip them.
+ * @return false if the data isn't a valid mesh file, leaving `out` and `lod_storage` untouched.
+ */
+static inline bool mesh_from_memory(const void* data, size_t size, Mesh* out, Mesh* lod_storage, int max_lods)
+{
+    if (!data || size < sizeof(MeshFileHeader) || ((uintptr_t)data & 3) != 0) {
+        return false;
+    }
+    const MeshFileHeader* h = (const MeshFileHeader*)data;
+    if (h->magic != MESH_FILE_MAGIC || h->version != MESH_FILE_VERSION || h->file_size > size) {
+        return false;
+    }
+    if ((h->index_size != 1 && h->index_size != 2) || h->num_vertices > 65536 ||
+        (uint64_t)sizeof(MeshFileHeader) + (uint64_t)h->num_lods * sizeof(MeshFileLod) > h->file_size) {
+        return false;
+    }
+    const uint8_t* base = (const uint8_t*)data;
+    const uint8_t* indices8;
+    const uint16_t* indices16;
+    if (!mesh_file_range_ok(h, h->positions_offset, (uint64_t)h->num_vertices * 3 * sizeof(int16_t)) ||
+        (h->vertex_normals_offset != 0 &&
+         !mesh_file_range_ok(h, h->vertex_normals_offset, (uint64_t)h->num_vertices * sizeof(uint16_t))) ||
+        !mesh_file_indices_ok(h, h->num_indices, h->indices_offset, h->face_normals_offset, &indices8, &indices16)) {
+        return false;
+    }
+
+    const int16_t* positions = (const int16_t*)(base + h->positions_offset);
+    const Vec3f scale = {h->scale[0], h->scale[1], h->scale[2]};
+    const Vec3f offset = {h->offset[0], h->offset[1], h->offset[2]};
+    const uint16_t* vertex_normals = h->vertex_normals_offset ? (const uint16_t*)(base + h->vertex_normals_offset) : NULL;
+    const MeshFileLod* file_lods = (const MeshFileLod*)(base + sizeof(MeshFileHeader));
+    const int num_lods = (int)h->num_lods < max_lods ? (int)h->num_lods : max_lods;
+    // Check every LOD before writing any, so a bad file leaves lod_storage untouched too.
+    for (int i = 0; i < num_lods; ++i) {
+        const MeshFileLod* l = &file_lods[i];
+        const uint8_t* lod_indices8;
+        const uint16_t* lod_indices16;
+        if (!mesh_file_indices_ok(h, l->num_indices, l->indices_offset, l->face_normals_offset, &lod_indices8, &lod_indices16)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < num_lods; ++i) {
+        const MeshFileLod* l = &file_lods[i];
+        const uint8_t* lod_indices8 = h->index_size == 1 ? base + l->indices_offset : NULL;
+        const uint16_t* lod_indices16 = h->index_size == 2 ? (const uint16_t*)(base + l->indices_offset) : NULL;
+        lod_storage[i] = mesh_with_lod_error(
+            mesh_make_quantized(positions, (int)h->num_vertices, scale, offset, lod_indices8, lod_indices16,
+                                (int)l->num_indices, (const uint16_t*)(base + l->face_normals_offset), vertex_normals),
+            l->error);
+    }
+    *out = mesh_with_lods(
+        mesh_make_quantized(positions, (int)h->num_vertices, scale, offset, indices8, indices16, (int)h->num_indices,
+                            (const uint16_t*)(base + h->face_normals_offset), vertex_normals),
+        lod_storage, num_lods);
+    return true;
+}
+
+#endif // MESH_3D_H
@@ -0,0 +1,64 @@
+#ifndef MYAPPLET_MODEL_H
+#define MYAPPLET_MODEL_H
+
+#include "mesh_3d.h"
+
+// Generated by tools/jamesh_convert from myapplet_model.obj. Do not edit by hand.
+
+const int MYAPPLET_MODEL_NUM_VERTICES = 42;
+const int MYAPPLET_MODEL_NUM_INDICES = 225;
+
+const int16_t MYAPPLET_MODEL_POSITIONS[MYAPPLET_MODEL_NUM_VERTICES * 3] = {
+    466, -4571, 31097, 1796, -9168, -28733, -10544, -32562, 18820, 6635, -7218, 24348, 
+    6502, 22963, 31131, -212, -6225, 30260, -212, -4386, 29938, -21806, 1503, 20121, 
+    -7034, 25687, 30817, -346, 13535, 29551, -2713, -3635, 32008, 2949, -5527, 31501, 
+    -3000, -9365, 31089, -259, -27948, 28041, -8303, 13358, 32305, -15363, 9112, 27934, 
+    -11553, 3293, 28978, 8237, 13334, 32767, 5894, 4790, 30533, 11144, 2666, 28086, 
+    15145, 8740, 27267, -6227, 4748, 30417, -21597, 13547, 21533, 24145, 8390, 19415, 
+    -9667, 32767, 6925, -23335, 18023, -18637, -7051, -8846, 16851, 9905, -32767, 20361, 
+    4422, -14713, 11471, 7906, 23186, -32767, 12543, 30627, 5602, 19448, 15038, 14287, 
+    -17618, -2687, -15124, -32767, 1406, -19031, 24828, 14567, -10863, 20649, 525, -10876, 
+    -21738, 681, -11097, -23529, 12563, -8591, -32724, 14912, -18258, 32767, 14124, -19017, 
+    32338, 1063, -19698, 18867, -1742, -16133
+};
+
+const uint8_t MYAPPLET_MODEL_INDICES[MYAPPLET_MODEL_NUM_INDICES] = {
+    7, 26, 10, 4, 9, 17, 14, 9, 8, 22, 14, 8, 
+    23, 4, 20, 7, 15, 22, 11, 3, 18, 18, 21, 11, 
+    27, 13, 2, 11, 13, 27, 13, 12, 2, 0, 6, 5, 
+    0, 6, 10, 6, 11, 21, 10, 6, 21, 3, 20, 19, 
+    15, 7, 16, 23, 31, 4, 28, 27, 2, 28, 2, 26, 
+    25, 24, 29, 30, 31, 34, 22, 24, 25, 9, 4, 31, 
+    8, 9, 22, 25, 37, 22, 1, 35, 28, 41, 29, 34, 
+    25, 1, 32, 23, 35, 34, 37, 38, 36, 7, 37, 36, 
+    35, 39, 34, 40, 39, 35, 38, 33, 36, 37, 25, 38, 
+    33, 38, 32, 3, 11, 27, 2, 12, 26, 3, 23, 20, 
+    22, 15, 14, 10, 21, 7, 28, 32, 1, 21, 9, 14, 
+    11, 12, 13, 0, 11, 6, 10, 11, 0, 12, 11, 10, 
+    12, 10, 26, 18, 3, 19, 16, 7, 21, 4, 17, 20, 
+    18, 9, 21, 3, 27, 28, 9, 30, 24, 29, 41, 1, 
+    25, 29, 1, 24, 30, 29, 29, 30, 34, 36, 26, 7, 
+    22, 9, 24, 23, 34, 31, 22, 37, 7, 35, 3, 28, 
+    34, 40, 41, 1, 41, 35, 40, 35, 41, 32, 36, 33, 
+    32, 38, 25, 28, 26, 32, 18, 17, 9, 9, 31, 30, 
+    36, 32, 26, 35, 23, 3, 34, 39, 40
+};
+
+const uint16_t MYAPPLET_MODEL_FACE_NORMALS[MYAPPLET_MODEL_NUM_INDICES / 3] = {
+    25155, 26503, 38278, 22411, 43150, 19577, 47726, 32392, 31797, 41071, 23150, 16775, 
+    39142, 24675, 42652, 46423, 23147, 44983, 56324, 286, 18666, 49067, 16821, 9694, 
+    59881, 7057, 46888, 63286, 5669, 56665, 20588, 5227, 43887, 43130, 22395, 28353, 
+    63979, 50563, 12943, 41311, 22929, 23417, 22045, 38261, 33137, 42209, 38866, 33392, 
+    9855, 36190, 42775, 43922, 32393, 61103, 34492, 60968, 796, 40695, 49874, 21040, 
+    28849, 46520, 3200, 47181, 7659, 35119, 37426, 27195, 61185, 22565, 26739, 39592, 
+    20532, 45374, 1485
+};
+
+static const Mesh MYAPPLET_MODEL_MESH = mesh_make_quantized(
+    MYAPPLET_MODEL_POSITIONS, MYAPPLET_MODEL_NUM_VERTICES,
+    (Vec3f){1.52592547e-05f, 1.24352091e-05f, 1.01338392e-05f},
+    (Vec3f){0.00322900712f, -0.00423550606f, 0.00685450435f},
+    MYAPPLET_MODEL_INDICES, NULL, MYAPPLET_MODEL_NUM_INDICES,
+    MYAPPLET_MODEL_FACE_NORMALS, NULL);
+
+#endif // MYAPPLET_MODEL_H
@@ -0,0 +1,35 @@
+#ifndef SHIP_MESH_H
+#define SHIP_MESH_H
+
+#include "mesh_3d.h"
+
+// Generated by tools/jamesh_convert from ship.obj. Do not edit by hand.
+
+const int SHIP_NUM_VERTICES = 15;
+const int SHIP_NUM_INDICES = 27;
+
+const int16_t SHIP_POSITIONS[SHIP_NUM_VERTICES * 3] = {
+    0, 0, -32767, 0, -32767, 32767, -2634, 32767, 32767, 2634, 32767, 32767, 
+    -32767, 0, 19660, 32767, 0, 19660, -10185, 9570, 7679, 10185, 9570, 7679, 
+    -31843, -8138, 16968, 31843, -8138, 16968, -31843, -8138, 16968, -30316, -6847, -15718, 
+    -27363, -9923, 15661, 27363, -9923, 15661, 30316, -6847, -15718
+};
+
+const uint8_t SHIP_INDICES[SHIP_NUM_INDICES] = {
+    2, 1, 3, 4, 1, 2, 5, 3, 1, 4, 6, 1, 
+    0, 7, 1, 1, 7, 5, 1, 6, 0, 11, 12, 10, 
+    13, 14, 9
+};
+
+const uint16_t SHIP_FACE_NORMALS[SHIP_NUM_INDICES / 3] = {
+    32639, 25465, 39801, 22790, 45095, 42246, 20007, 29960, 35080
+};
+
+static const Mesh SHIP_MESH = mesh_make_quantized(
+    SHIP_POSITIONS, SHIP_NUM_VERTICES,
+    (Vec3f){2.65492417e-05f, 4.57777651e-06f, 1.90740684e-05f},
+    (Vec3f){0.0f, 0.0942919999f, -0.219292f},
+    SHIP_INDICES, NULL, SHIP_NUM_INDICES,
+    SHIP_FACE_NORMALS, NULL);
+
+#endif // SHIP_MESH_H
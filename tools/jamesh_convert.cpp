@@ -0,0 +1,577 @@
+// jamesh_convert - turns Wavefront OBJ models into compact quantized meshes (see mesh_3d.h).
+//
+// Build (host machine, not the target):
+//   g++ -std=c++20 -O2 -o tools/jamesh_convert tools/jamesh_convert.cpp
+//
+// Usage:
+//   jamesh_convert [options] -o ship_mesh.h ship.obj
+//
+// Options:
+//   -o <file>        Output header, with the arrays and a `<NAME>_MESH` built by mesh_make_quantized().
+//   --bin <file>     Also (or instead) write a binary mesh for mesh_from_memory().
+//   --name <name>    Prefix for the generated arrays (default: the OBJ's file name in capitals).
+//   --smooth         Also store per-vertex normals, for smooth shading.
+//   --flip           Reverse the winding of every triangle.
+//   --lods <n>       Also make up to n levels of detail, each with about half the triangles of the
+//                    one before, by edge-collapse decimation (see mesh_select_lod()).
+//
+// Positions become int16 with a per-mesh scale and offset, indices uint8 (up to 256 vertices)
+// or uint16, and normals 16-bit octahedral. Faces with more than three corners are split into
+// fans; texture coordinates and OBJ normals are ignored.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../mesh_3d.h" // normal_pack() and the binary mesh layout
+
+struct Model {
+    std::vector<Vec3f> vertices;
+    std::vector<int> indices; // Three per triangle
+};
+
+static std::string file_name(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static std::string stem(const std::string& path) {
+    std::string name = file_name(path);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+// Upper-case C identifier made from `s`.
+static std::string sanitize(const std::string& s) {
+    std::string out;
+    for (char c : s) out += isalnum(static_cast<unsigned char>(c)) ? char(toupper(static_cast<unsigned char>(c))) : '_';
+    if (out.empty() || isdigit(static_cast<unsigned char>(out[0]))) out = "M_" + out;
+    return out;
+}
+
+static Model load_obj(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    Model model;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(f, line)) {
+        ++line_number;
+        std::istringstream ls(line);
+        std::string tag;
+        ls >> tag;
+        if (tag == "v") {
+            Vec3f v;
+            if (!(ls >> v.x >> v.y >> v.z)) throw std::runtime_error(path + ":" + std::to_string(line_number) + ": bad vertex");
+            model.vertices.push_back(v);
+        } else if (tag == "f") {
+            // Corners look like "7", "7/2", "7//3" or "7/2/3"; only the position index is used.
+            std::vector<int> corners;
+            std::string corner;
+            while (ls >> corner) {
+                int index = std::stoi(corner.substr(0, corner.find('/')));
+                index = index < 0 ? int(model.vertices.size()) + index : index - 1;
+                if (index < 0 || index >= int(model.vertices.size())) {
+                    throw std::runtime_error(path + ":" + std::to_string(line_number) + ": vertex index out of range");
+                }
+                corners.push_back(index);
+            }
+            if (corners.size() < 3) throw std::runtime_error(path + ":" + std::to_string(line_number) + ": face with fewer than 3 corners");
+            for (size_t c = 1; c + 1 < corners.size(); ++c) {
+                model.indices.insert(model.indices.end(), {corners[0], corners[c], corners[c + 1]});
+            }
+        }
+    }
+    if (model.indices.empty()) throw std::runtime_error(path + ": no faces");
+    return model;
+}
+
+// --- Decimation ---
+
+// Symmetric 4x4 error quadric (Garland & Heckbert): the sum of squared distances to a set of planes.
+struct Quadric {
+    double q[10] = {}; // Upper triangle, row by row
+
+    static Quadric plane(double a, double b, double c, double d, double weight) {
+        Quadric r;
+        const double p[4] = {a, b, c, d};
+        for (int i = 0, k = 0; i < 4; ++i) {
+            for (int j = i; j < 4; ++j) r.q[k++] = p[i] * p[j] * weight;
+        }
+        return r;
+    }
+    void add(const Quadric& o) {
+        for (int i = 0; i < 10; ++i) q[i] += o.q[i];
+    }
+    double error(const Vec3f& v) const {
+        const double x = v.x, y = v.y, z = v.z;
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x +
+               q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y +
+               q[7] * z * z + 2 * q[8] * z + q[9];
+    }
+};
+
+static Vec3f triangle_cross(const std::vector<Vec3f>& v, int a, int b, int c) {
+    return vec3_cross(vec3_subtract(v[b], v[a]), vec3_subtract(v[c], v[a]));
+}
+
+/**
+ * Removes triangles by collapsing edges, always moving one end onto the other, so every level of
+ * detail still uses (a subset of) the original vertices. Each step picks the collapse that adds
+ * the least quadric error and doesn't flip any triangle.
+ */
+class Decimator {
+public:
+    explicit Decimator(const Model& model)
+        : vertices(model.vertices), indices(model.indices), quadrics(model.vertices.size()), used(model.vertices.size()) {
+        for (int v : indices) used[v] = true;
+        std::map<std::pair<int, int>, int> edge_count;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            Vec3f n = vec3_normalize(triangle_cross(vertices, indices[i], indices[i + 1], indices[i + 2]));
+            const Vec3f& p = vertices[indices[i]];
+            Quadric plane = Quadric::plane(n.x, n.y, n.z, -vec3_dot(n, p), 1.0);
+            for (int c = 0; c < 3; ++c) {
+                quadrics[indices[i + c]].add(plane);
+                int a = indices[i + c], b = indices[i + (c + 1) % 3];
+                ++edge_count[{std::min(a, b), std::max(a, b)}];
+            }
+        }
+        // Open edges (like a wing's outline) get a steep plane through them so they keep their shape.
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            Vec3f n = vec3_normalize(triangle_cross(vertices, indices[i], indices[i + 1], indices[i + 2]));
+            for (int c = 0; c < 3; ++c) {
+                int a = indices[i + c], b = indices[i + (c + 1) % 3];
+                if (edge_count[{std::min(a, b), std::max(a, b)}] != 1) continue;
+                Vec3f side = vec3_normalize(vec3_cross(vec3_subtract(vertices[b], vertices[a]), n));
+                Quadric plane = Quadric::plane(side.x, side.y, side.z, -vec3_dot(side, vertices[a]), 10.0);
+                quadrics[a].add(plane);
+                quadrics[b].add(plane);
+            }
+        }
+    }
+
+    size_t num_triangles() const { return indices.size() / 3; }
+    const std::vector<int>& current_indices() const { return indices; }
+
+    // Collapses edges until at most `target` triangles are left. Returns false if it got stuck first.
+    bool reduce_to(size_t target) {
+        while (num_triangles() > target) {
+            double best_cost = INFINITY;
+            int best_from = -1, best_to = -1;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (int c = 0; c < 3; ++c) {
+                    for (int dir = 0; dir < 2; ++dir) {
+                        int from = indices[i + (dir ? c : (c + 1) % 3)];
+                        int to = indices[i + (dir ? (c + 1) % 3 : c)];
+                        Quadric merged = quadrics[from];
+                        merged.add(quadrics[to]);
+                        double cost = merged.error(vertices[to]);
+                        if (cost < best_cost && collapse_ok(from, to)) {
+                            best_cost = cost;
+                            best_from = from;
+                            best_to = to;
+                        }
+                    }
+                }
+            }
+            if (best_from < 0) return false;
+            quadrics[best_to].add(quadrics[best_from]);
+            std::vector<int> kept;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                int t[3] = {indices[i], indices[i + 1], indices[i + 2]};
+                for (int& v : t) if (v == best_from) v = best_to;
+                if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) continue;
+                kept.insert(kept.end(), t, t + 3);
+            }
+            indices.swap(kept);
+        }
+        return true;
+    }
+
+    // How far the original vertices lie from the current surface.
+    float error() const {
+        double worst = 0;
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            if (!used[v]) continue;
+            const Vec3f& p = vertices[v];
+            double nearest = INFINITY;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                nearest = std::min(nearest, point_triangle_distance(p, vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]));
+            }
+            worst = std::max(worst, nearest);
+        }
+        return float(worst);
+    }
+
+private:
+    // Moving `from` onto `to` must not flip or flatten any triangle that keeps its area.
+    bool collapse_ok(int from, int to) const {
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            int t[3] = {indices[i], indices[i + 1], indices[i + 2]};
+            bool has_from = false, has_to = false;
+            for (int v : t) {
+                has_from |= v == from;
+                has_to |= v == to;
+            }
+            if (!has_from || has_to) continue;
+            Vec3f before = triangle_cross(vertices, t[0], t[1], t[2]);
+            for (int& v : t) if (v == from) v = to;
+            Vec3f after = triangle_cross(vertices, t[0], t[1], t[2]);
+            if (vec3_dot(before, after) <= 0.2f * vec3_length(before) * vec3_length(after)) return false;
+        }
+        return true;
+    }
+
+    static double point_triangle_distance(const Vec3f& p, const Vec3f& a, const Vec3f& b, const Vec3f& c) {
+        Vec3f n = vec3_cross(vec3_subtract(b, a), vec3_subtract(c, a));
+        float n_len = vec3_length(n);
+        if (n_len > 0) {
+            // Inside the triangle: distance to its plane.
+            n = {n.x / n_len, n.y / n_len, n.z / n_len};
+            float d = vec3_dot(vec3_subtract(p, a), n);
+            Vec3f q = {p.x - n.x * d, p.y - n.y * d, p.z - n.z * d};
+            const Vec3f* corners[3] = {&a, &b, &c};
+            bool inside = true;
+            for (int e = 0; e < 3; ++e) {
+                const Vec3f& u = *corners[e];
+                const Vec3f& v = *corners[(e + 1) % 3];
+                if (vec3_dot(vec3_cross(vec3_subtract(v, u), vec3_subtract(q, u)), n) < 0) inside = false;
+            }
+            if (inside) return std::fabs(d);
+        }
+        // Otherwise the nearest point is on an edge.
+        auto segment = [&](const Vec3f& u, const Vec3f& v) {
+            Vec3f uv = vec3_subtract(v, u);
+            float len2 = vec3_dot(uv, uv);
+            float t = len2 > 0 ? std::clamp(vec3_dot(vec3_subtract(p, u), uv) / len2, 0.0f, 1.0f) : 0.0f;
+            Vec3f q = {u.x + uv.x * t, u.y + uv.y * t, u.z + uv.z * t};
+            return double(vec3_length(vec3_subtract(p, q)));
+        };
+        return std::min({segment(a, b), segment(b, c), segment(c, a)});
+    }
+
+    std::vector<Vec3f> vertices;
+    std::vector<int> indices;
+    std::vector<Quadric> quadrics;
+    std::vector<bool> used; // Vertices the full mesh uses
+};
+
+// --- Quantization ---
+
+struct Lod {
+    std::vector<uint16_t> indices;
+    std::vector<uint16_t> face_normals;
+    float error = 0;
+};
+
+struct Quantized {
+    std::vector<int16_t> positions; // x, y, z per vertex
+    Vec3f scale;
+    Vec3f offset;
+    std::vector<uint16_t> indices;
+    int index_size = 1;
+    std::vector<uint16_t> face_normals;
+    std::vector<uint16_t> vertex_normals; // Empty unless --smooth
+    std::vector<Lod> lods;
+};
+
+// Packed face normals, from the original positions and with the same winding as mesh_make().
+static std::vector<uint16_t> pack_face_normals(const std::vector<Vec3f>& vertices, const std::vector<int>& indices) {
+    std::vector<uint16_t> normals;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        normals.push_back(normal_pack(vec3_normalize(triangle_cross(vertices, indices[i], indices[i + 1], indices[i + 2]))));
+    }
+    return normals;
+}
+
+static Quantized quantize(const Model& model, bool smooth, int max_lods) {
+    if (model.vertices.size() > 65536) throw std::runtime_error("more than 65536 vertices");
+    Quantized q;
+    Vec3f lo = model.vertices[0], hi = model.vertices[0];
+    for (const Vec3f& v : model.vertices) {
+        lo = {std::min(lo.x, v.x), std::min(lo.y, v.y), std::min(lo.z, v.z)};
+        hi = {std::max(hi.x, v.x), std::max(hi.y, v.y), std::max(hi.z, v.z)};
+    }
+    // Centered on the bounding box so each axis uses the whole int16 range.
+    q.offset = {(lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f};
+    auto axis_scale = [](float l, float h) { return h > l ? (h - l) * 0.5f / 32767.0f : 1.0f / 32767.0f; };
+    q.scale = {axis_scale(lo.x, hi.x), axis_scale(lo.y, hi.y), axis_scale(lo.z, hi.z)};
+    auto to_int16 = [](float v) { return int16_t(std::clamp(std::lround(v), -32767L, 32767L)); };
+    for (const Vec3f& v : model.vertices) {
+        q.positions.push_back(to_int16((v.x - q.offset.x) / q.scale.x));
+        q.positions.push_back(to_int16((v.y - q.offset.y) / q.scale.y));
+        q.positions.push_back(to_int16((v.z - q.offset.z) / q.scale.z));
+    }
+
+    q.index_size = model.vertices.size() <= 256 ? 1 : 2;
+    q.indices.assign(model.indices.begin(), model.indices.end());
+
+    q.face_normals = pack_face_normals(model.vertices, model.indices);
+    if (smooth) {
+        // Area-weighted, like mesh_with_vertex_normals(). LODs share these.
+        std::vector<Vec3f> sums(model.vertices.size(), Vec3f{0, 0, 0});
+        for (size_t i = 0; i < model.indices.size(); i += 3) {
+            Vec3f n = triangle_cross(model.vertices, model.indices[i], model.indices[i + 1], model.indices[i + 2]);
+            for (int c = 0; c < 3; ++c) {
+                Vec3f& sum = sums[model.indices[i + c]];
+                sum = {sum.x + n.x, sum.y + n.y, sum.z + n.z};
+            }
+        }
+        for (const Vec3f& sum : sums) q.vertex_normals.push_back(normal_pack(vec3_normalize(sum)));
+    }
+
+    Decimator decimator(model);
+    // Stop at 4 triangles, the fewest that can still enclose a volume.
+    while (int(q.lods.size()) < max_lods && decimator.num_triangles() > 4) {
+        const size_t before = decimator.num_triangles();
+        decimator.reduce_to(std::max<size_t>(before / 2, 4));
+        // Not worth a level if the decimator got stuck early.
+        if (decimator.num_triangles() * 4 > before * 3) break;
+        Lod lod;
+        lod.indices.assign(decimator.current_indices().begin(), decimator.current_indices().end());
+        lod.face_normals = pack_face_normals(model.vertices, decimator.current_indices());
+        lod.error = decimator.error();
+        // A coarser level that is no worse makes the previous one useless.
+        if (!q.lods.empty() && lod.error <= q.lods.back().error) q.lods.pop_back();
+        q.lods.push_back(std::move(lod));
+    }
+    return q;
+}
+
+template <typename T>
+static void write_values(std::ostream& os, const std::vector<T>& values, int per_line) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % per_line == 0) os << "    ";
+        os << values[i];
+        if (i + 1 < values.size()) os << ", ";
+        if ((i + 1) % per_line == 0 || i + 1 == values.size()) os << "\n";
+    }
+}
+
+static std::string float_literal(float f) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9gf", f);
+    std::string s = buf;
+    if (s.find_first_of(".e") == std::string::npos) s.insert(s.size() - 1, ".0");
+    return s;
+}
+
+static std::string vec3_literal(Vec3f v) {
+    return "(Vec3f){" + float_literal(v.x) + ", " + float_literal(v.y) + ", " + float_literal(v.z) + "}";
+}
+
+static void write_header(const std::string& path, const std::string& source, const std::string& name, const Quantized& q) {
+    std::string guard = sanitize(stem(path)) + "_H";
+    const std::string nv = name + "_NUM_VERTICES";
+    const std::string ni = name + "_NUM_INDICES";
+
+    std::ostringstream os;
+    os << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+    os << "#include \"mesh_3d.h\"\n\n";
+    os << "// Generated by tools/jamesh_convert from " << source << ". Do not edit by hand.\n\n";
+    os << "const int " << nv << " = " << q.positions.size() / 3 << ";\n";
+    os << "const int " << ni << " = " << q.indices.size() << ";\n\n";
+    os << "const int16_t " << name << "_POSITIONS[" << nv << " * 3] = {\n";
+    write_values(os, q.positions, 12);
+    os << "};\n\n";
+    const std::string index_type = q.index_size == 1 ? "uint8_t " : "uint16_t ";
+    os << "const " << index_type << name << "_INDICES[" << ni << "] = {\n";
+    write_values(os, q.indices, 12);
+    os << "};\n\n";
+    os << "const uint16_t " << name << "_FACE_NORMALS[" << ni << " / 3] = {\n";
+    write_values(os, q.face_normals, 12);
+    os << "};\n\n";
+    if (!q.vertex_normals.empty()) {
+        os << "const uint16_t " << name << "_VERTEX_NORMALS[" << nv << "] = {\n";
+        write_values(os, q.vertex_normals, 12);
+        os << "};\n\n";
+    }
+    for (size_t l = 0; l < q.lods.size(); ++l) {
+        const std::string lod = name + "_LOD" + std::to_string(l + 1);
+        os << "const " << index_type << lod << "_INDICES[" << q.lods[l].indices.size() << "] = {\n";
+        write_values(os, q.lods[l].indices, 12);
+        os << "};\n\n";
+        os << "const uint16_t " << lod << "_FACE_NORMALS[" << q.lods[l].face_normals.size() << "] = {\n";
+        write_values(os, q.lods[l].face_normals, 12);
+        os << "};\n\n";
+    }
+
+    // mesh_make_quantized() for one index set; LODs share everything else.
+    auto make = [&](const std::string& prefix, const std::string& num_indices, const std::string& indent) {
+        std::ostringstream m;
+        m << "mesh_make_quantized(\n";
+        m << indent << "    " << name << "_POSITIONS, " << nv << ",\n";
+        m << indent << "    " << vec3_literal(q.scale) << ",\n";
+        m << indent << "    " << vec3_literal(q.offset) << ",\n";
+        if (q.index_size == 1) {
+            m << indent << "    " << prefix << "_INDICES, NULL, " << num_indices << ",\n";
+        } else {
+            m << indent << "    NULL, " << prefix << "_INDICES, " << num_indices << ",\n";
+        }
+        m << indent << "    " << prefix << "_FACE_NORMALS, " << (q.vertex_normals.empty() ? "NULL" : name + "_VERTEX_NORMALS") << ")";
+        return m.str();
+    };
+    if (q.lods.empty()) {
+        os << "static const Mesh " << name << "_MESH = " << make(name, ni, "") << ";\n";
+    } else {
+        os << "// Levels of detail, coarsest last. See mesh_select_lod().\n";
+        os << "static const Mesh " << name << "_LODS[" << q.lods.size() << "] = {\n";
+        for (size_t l = 0; l < q.lods.size(); ++l) {
+            const std::string lod = name + "_LOD" + std::to_string(l + 1);
+            os << "    mesh_with_lod_error(" << make(lod, std::to_string(q.lods[l].indices.size()), "    ") << ", "
+               << float_literal(q.lods[l].error) << ")" << (l + 1 < q.lods.size() ? "," : "") << "\n";
+        }
+        os << "};\n\n";
+        os << "static const Mesh " << name << "_MESH = mesh_with_lods(" << make(name, ni, "") << ",\n";
+        os << "    " << name << "_LODS, " << q.lods.size() << ");\n";
+    }
+    os << "\n#endif // " << guard << "\n";
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f << os.str();
+}
+
+static void write_bin(const std::string& path, const Quantized& q) {
+    std::vector<uint8_t> blob(sizeof(MeshFileHeader) + q.lods.size() * sizeof(MeshFileLod));
+    auto align = [&]() { blob.resize((blob.size() + 3) / 4 * 4, 0); };
+    auto append = [&](const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        blob.insert(blob.end(), b, b + n);
+        align();
+    };
+    auto append_indices = [&](const std::vector<uint16_t>& indices) {
+        const uint32_t offset = uint32_t(blob.size());
+        if (q.index_size == 1) {
+            std::vector<uint8_t> narrow(indices.begin(), indices.end());
+            append(narrow.data(), narrow.size());
+        } else {
+            append(indices.data(), indices.size() * sizeof(uint16_t));
+        }
+        return offset;
+    };
+    auto append_normals = [&](const std::vector<uint16_t>& normals) {
+        const uint32_t offset = uint32_t(blob.size());
+        append(normals.data(), normals.size() * sizeof(uint16_t));
+        return offset;
+    };
+
+    MeshFileHeader header{};
+    header.magic = MESH_FILE_MAGIC;
+    header.version = MESH_FILE_VERSION;
+    header.index_size = uint16_t(q.index_size);
+    header.num_vertices = uint32_t(q.positions.size() / 3);
+    header.num_indices = uint32_t(q.indices.size());
+    header.scale[0] = q.scale.x; header.scale[1] = q.scale.y; header.scale[2] = q.scale.z;
+    header.offset[0] = q.offset.x; header.offset[1] = q.offset.y; header.offset[2] = q.offset.z;
+    header.num_lods = uint32_t(q.lods.size());
+
+    header.positions_offset = uint32_t(blob.size());
+    append(q.positions.data(), q.positions.size() * sizeof(int16_t));
+    header.indices_offset = append_indices(q.indices);
+    header.face_normals_offset = append_normals(q.face_normals);
+    if (!q.vertex_normals.empty()) {
+        header.vertex_normals_offset = append_normals(q.vertex_normals);
+    }
+    std::vector<MeshFileLod> lods(q.lods.size());
+    for (size_t l = 0; l < q.lods.size(); ++l) {
+        lods[l].num_indices = uint32_t(q.lods[l].indices.size());
+        lods[l].indices_offset = append_indices(q.lods[l].indices);
+        lods[l].face_normals_offset = append_normals(q.lods[l].face_normals);
+        lods[l].error = q.lods[l].error;
+    }
+    header.file_size = uint32_t(blob.size());
+    memcpy(blob.data(), &header, sizeof(header));
+    if (!lods.empty()) memcpy(blob.data() + sizeof(header), lods.data(), lods.size() * sizeof(MeshFileLod));
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f.write(reinterpret_cast<const char*>(blob.data()), std::streamsize(blob.size()));
+    printf("wrote %s: %zu bytes\n", path.c_str(), blob.size());
+}
+
+static void usage() {
+    std::cerr << "usage: jamesh_convert [--name NAME] [--smooth] [--flip] [--lods N] [-o out.h] [--bin out.jmsh] model.obj\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string out_path;
+    std::string bin_path;
+    std::string name;
+    std::string obj_path;
+    bool smooth = false;
+    bool flip = false;
+    int max_lods = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error(arg + " needs a value");
+                return argv[++i];
+            };
+            if (arg == "-o") {
+                out_path = value();
+            } else if (arg == "--bin") {
+                bin_path = value();
+            } else if (arg == "--name") {
+                name = sanitize(value());
+            } else if (arg == "--smooth") {
+                smooth = true;
+            } else if (arg == "--flip") {
+                flip = true;
+            } else if (arg == "--lods") {
+                max_lods = std::stoi(value());
+                if (max_lods < 0) throw std::runtime_error("--lods must not be negative");
+            } else if (!arg.empty() && arg[0] == '-') {
+                usage();
+                return 1;
+            } else if (obj_path.empty()) {
+                obj_path = arg;
+            } else {
+                throw std::runtime_error("only one model per run");
+            }
+        }
+        if ((out_path.empty() && bin_path.empty()) || obj_path.empty()) {
+            usage();
+            return 1;
+        }
+        if (name.empty()) name = sanitize(stem(obj_path));
+
+        Model model = load_obj(obj_path);
+        if (flip) {
+            for (size_t i = 0; i < model.indices.size(); i += 3) std::swap(model.indices[i + 1], model.indices[i + 2]);
+        }
+        Quantized q = quantize(model, smooth, max_lods);
+
+        const size_t float_bytes = model.vertices.size() * sizeof(Vec3f) + model.indices.size() * sizeof(int);
+        const size_t compact_bytes = q.positions.size() * sizeof(int16_t) + q.indices.size() * q.index_size +
+                                     (q.face_normals.size() + q.vertex_normals.size()) * sizeof(uint16_t);
+        printf("%-24s %zu vertices, %zu triangles: float=%zu (without normals)  quantized=%zu\n", name.c_str(),
+               model.vertices.size(), model.indices.size() / 3, float_bytes, compact_bytes);
+        for (size_t l = 0; l < q.lods.size(); ++l) {
+            printf("%-24s LOD%zu: %zu triangles, error %g\n", "", l + 1, q.lods[l].indices.size() / 3, q.lods[l].error);
+        }
+
+        if (!out_path.empty()) {
+            write_header(out_path, file_name(obj_path), name, q);
+            printf("wrote %s\n", out_path.c_str());
+        }
+        if (!bin_path.empty()) {
+            write_bin(bin_path, q);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "jamesh_convert: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,933 @@
+// jasprite_convert - turns PNG/PPM/BMP images into constexpr JaSprite headers.
+//
+// Build (host machine, not the target):
+//   g++ -std=c++20 -O2 -o tools/jasprite_convert tools/jasprite_convert.cpp
+//
+// Usage:
+//   jasprite_convert [options] -o sprites.h image1.png [--format rle image2.bmp ...]
+//
+// Options apply to every image listed after them, so encodings can be chosen per asset:
+//   -o <file>            Output header.
+//   --pack <file>        Also (or instead) write a binary sprite pack for JaAssetPack.h.
+//   --namespace <name>   Namespace for the generated data (default: Sprites).
+//   --format <fmt>       raw | packed | rle | auto (default: auto, picks the smallest encoding).
+//   --colors <n>         Maximum palette size, 2-256 (default: 256). Images with more colors are median-cut.
+//   --alpha <n>          Pixels with alpha below this become the transparent entry (default: 128).
+//   --anim <name> <n>    The next n images are frames of one animation (see JaSpriteAnimation.h).
+//                        They share a palette; the first becomes a keyframe sprite called <name>
+//                        and the rest are stored as changed-pixel runs in <name>_deltas.
+//                        Packs only store the keyframe.
+//
+// All images in one run go into the same header/pack, and sprites whose palettes come out
+// identical share a single palette array.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../JaAssetPack.h" // JADRAW_RGBA, JaSpriteEncoding and the pack file layout
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> rgba; // JADRAW_RGBA layout, row-major
+};
+
+static std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(f), {});
+}
+
+static uint32_t be32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]; }
+static uint32_t le32(const uint8_t* p) { return (uint32_t(p[3]) << 24) | (uint32_t(p[2]) << 16) | (uint32_t(p[1]) << 8) | p[0]; }
+static uint16_t le16(const uint8_t* p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+// --- Inflate (RFC 1951), just enough for PNG IDAT streams ---
+
+namespace inflate {
+
+    struct BitReader {
+        const uint8_t* data;
+        size_t size;
+        size_t pos = 0;
+        uint32_t bitbuf = 0;
+        int bitcount = 0;
+
+        uint32_t bits(int n) {
+            while (bitcount < n) {
+                if (pos >= size) throw std::runtime_error("inflate: unexpected end of data");
+                bitbuf |= uint32_t(data[pos++]) << bitcount;
+                bitcount += 8;
+            }
+            uint32_t v = bitbuf & ((1u << n) - 1);
+            bitbuf >>= n;
+            bitcount -= n;
+            return v;
+        }
+        void align() { bitbuf = 0; bitcount = 0; }
+    };
+
+    // Canonical Huffman table: symbol counts per code length plus symbols sorted by code.
+    struct Huffman {
+        uint16_t counts[16] = {};
+        std::vector<uint16_t> symbols;
+
+        void build(const uint8_t* lengths, int n) {
+            std::fill(std::begin(counts), std::end(counts), 0);
+            for (int i = 0; i < n; ++i) counts[lengths[i]]++;
+            counts[0] = 0;
+            uint16_t offsets[16] = {};
+            for (int i = 1; i < 16; ++i) offsets[i] = offsets[i - 1] + counts[i - 1];
+            symbols.assign(n, 0);
+            for (int i = 0; i < n; ++i) {
+                if (lengths[i]) symbols[offsets[lengths[i]]++] = uint16_t(i);
+            }
+        }
+
+        int decode(BitReader& br) const {
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len < 16; ++len) {
+                code |= int(br.bits(1));
+                int count = counts[len];
+                if (code - first < count) return symbols[index + (code - first)];
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            throw std::runtime_error("inflate: bad huffman code");
+        }
+    };
+
+    static const uint16_t LEN_BASE[] = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+    static const uint8_t  LEN_EXTRA[] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+    static const uint16_t DIST_BASE[] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+    static const uint8_t  DIST_EXTRA[] = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+
+    static void inflate_block(BitReader& br, std::vector<uint8_t>& out, const Huffman& lit, const Huffman& dist) {
+        for (;;) {
+            int sym = lit.decode(br);
+            if (sym < 256) {
+                out.push_back(uint8_t(sym));
+            } else if (sym == 256) {
+                return;
+            } else {
+                sym -= 257;
+                if (sym >= 29) throw std::runtime_error("inflate: bad length symbol");
+                size_t len = LEN_BASE[sym] + br.bits(LEN_EXTRA[sym]);
+                int dsym = dist.decode(br);
+                if (dsym >= 30) throw std::runtime_error("inflate: bad distance symbol");
+                size_t d = DIST_BASE[dsym] + br.bits(DIST_EXTRA[dsym]);
+                if (d > out.size()) throw std::runtime_error("inflate: distance too far back");
+                size_t from = out.size() - d;
+                for (size_t i = 0; i < len; ++i) out.push_back(out[from + i]);
+            }
+        }
+    }
+
+    // Decompresses a zlib stream (2-byte header, deflate data, adler32 which is not checked).
+    static std::vector<uint8_t> zlib_decompress(const std::vector<uint8_t>& in) {
+        if (in.size() < 2 || (in[0] & 0x0F) != 8) throw std::runtime_error("zlib: unsupported compression method");
+        BitReader br{in.data() + 2, in.size() - 2};
+        std::vector<uint8_t> out;
+        bool last = false;
+        while (!last) {
+            last = br.bits(1);
+            uint32_t type = br.bits(2);
+            if (type == 0) {
+                br.align();
+                if (br.pos + 4 > br.size) throw std::runtime_error("inflate: truncated stored block");
+                size_t len = le16(br.data + br.pos);
+                br.pos += 4;
+                if (br.pos + len > br.size) throw std::runtime_error("inflate: truncated stored block");
+                out.insert(out.end(), br.data + br.pos, br.data + br.pos + len);
+                br.pos += len;
+            } else if (type == 1) {
+                uint8_t lengths[288 + 30];
+                std::fill(lengths, lengths + 144, 8);
+                std::fill(lengths + 144, lengths + 256, 9);
+                std::fill(lengths + 256, lengths + 280, 7);
+                std::fill(lengths + 280, lengths + 288, 8);
+                std::fill(lengths + 288, lengths + 318, 5);
+                Huffman lit, dist;
+                lit.build(lengths, 288);
+                dist.build(lengths + 288, 30);
+                inflate_block(br, out, lit, dist);
+            } else if (type == 2) {
+                int hlit = int(br.bits(5)) + 257;
+                int hdist = int(br.bits(5)) + 1;
+                int hclen = int(br.bits(4)) + 4;
+                static const uint8_t ORDER[19] = {16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15};
+                uint8_t cl_lengths[19] = {};
+                for (int i = 0; i < hclen; ++i) cl_lengths[ORDER[i]] = uint8_t(br.bits(3));
+                Huffman cl;
+                cl.build(cl_lengths, 19);
+                uint8_t lengths[288 + 32] = {};
+                int n = 0;
+                while (n < hlit + hdist) {
+                    int sym = cl.decode(br);
+                    if (sym < 16) {
+                        lengths[n++] = uint8_t(sym);
+                    } else {
+                        int repeat = 0;
+                        uint8_t value = 0;
+                        if (sym == 16) {
+                            if (n == 0) throw std::runtime_error("inflate: repeat with no previous length");
+                            value = lengths[n - 1];
+                            repeat = 3 + int(br.bits(2));
+                        } else if (sym == 17) {
+                            repeat = 3 + int(br.bits(3));
+                        } else {
+                            repeat = 11 + int(br.bits(7));
+                        }
+                        if (n + repeat > hlit + hdist) throw std::runtime_error("inflate: too many code lengths");
+                        while (repeat--) lengths[n++] = value;
+                    }
+                }
+                Huffman lit, dist;
+                lit.build(lengths, hlit);
+                dist.build(lengths + hlit, hdist);
+                inflate_block(br, out, lit, dist);
+            } else {
+                throw std::runtime_error("inflate: invalid block type");
+            }
+        }
+        return out;
+    }
+
+} // inflate
+
+// --- Image loaders ---
+
+static Image load_png(const std::vector<uint8_t>& file) {
+    static const uint8_t SIG[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    if (file.size() < 8 || memcmp(file.data(), SIG, 8) != 0) throw std::runtime_error("png: bad signature");
+
+    int width = 0, height = 0, depth = 0, color_type = 0, interlace = 0;
+    std::vector<uint32_t> plte;
+    std::vector<uint8_t> trns;
+    std::vector<uint8_t> idat;
+    size_t pos = 8;
+    while (pos + 12 <= file.size()) {
+        uint32_t len = be32(&file[pos]);
+        std::string type(reinterpret_cast<const char*>(&file[pos + 4]), 4);
+        const uint8_t* data = &file[pos + 8];
+        if (pos + 12 + len > file.size()) throw std::runtime_error("png: truncated chunk " + type);
+        if (type == "IHDR") {
+            width = int(be32(data));
+            height = int(be32(data + 4));
+            depth = data[8];
+            color_type = data[9];
+            interlace = data[12];
+        } else if (type == "PLTE") {
+            for (uint32_t i = 0; i + 2 < len; i += 3) plte.push_back(JADRAW_RGBA(data[i], data[i + 1], data[i + 2], 255));
+        } else if (type == "tRNS") {
+            trns.assign(data, data + len);
+        } else if (type == "IDAT") {
+            idat.insert(idat.end(), data, data + len);
+        } else if (type == "IEND") {
+            break;
+        }
+        pos += 12 + len;
+    }
+    if (width <= 0 || height <= 0) throw std::runtime_error("png: missing IHDR");
+    if (interlace != 0) throw std::runtime_error("png: interlaced images are not supported, re-save without Adam7");
+
+    int channels = 0;
+    switch (color_type) {
+        case 0: channels = 1; break; // gray
+        case 2: channels = 3; break; // RGB
+        case 3: channels = 1; break; // palette
+        case 4: channels = 2; break; // gray + alpha
+        case 6: channels = 4; break; // RGBA
+        default: throw std::runtime_error("png: unknown color type");
+    }
+    const size_t bits_pp = size_t(channels) * depth;
+    const size_t stride = (size_t(width) * bits_pp + 7) / 8;
+    const size_t bpp = std::max<size_t>(1, bits_pp / 8); // filter byte distance
+
+    std::vector<uint8_t> raw = inflate::zlib_decompress(idat);
+    if (raw.size() < (stride + 1) * height) throw std::runtime_error("png: image data too short");
+
+    // Undo the per-row filters in place.
+    std::vector<uint8_t> px(stride * height);
+    for (int y = 0; y < height; ++y) {
+        uint8_t filter = raw[y * (stride + 1)];
+        const uint8_t* src = &raw[y * (stride + 1) + 1];
+        uint8_t* row = &px[y * stride];
+        const uint8_t* prev = y > 0 ? &px[(y - 1) * stride] : nullptr;
+        for (size_t i = 0; i < stride; ++i) {
+            int a = i >= bpp ? row[i - bpp] : 0;
+            int b = prev ? prev[i] : 0;
+            int c = (prev && i >= bpp) ? prev[i - bpp] : 0;
+            int pred = 0;
+            switch (filter) {
+                case 0: pred = 0; break;
+                case 1: pred = a; break;
+                case 2: pred = b; break;
+                case 3: pred = (a + b) / 2; break;
+                case 4: {
+                    int p = a + b - c;
+                    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                    break;
+                }
+                default: throw std::runtime_error("png: bad filter type");
+            }
+            row[i] = uint8_t(src[i] + pred);
+        }
+    }
+
+    // Reads sample `n` of a row at the image bit depth, scaled to 8 bits (palette indices are left unscaled).
+    auto sample = [&](const uint8_t* row, size_t n, bool scale) -> int {
+        if (depth == 8) return row[n];
+        if (depth == 16) return row[n * 2];
+        size_t bit = n * depth;
+        int v = (row[bit / 8] >> (8 - depth - int(bit % 8))) & ((1 << depth) - 1);
+        return scale ? v * 255 / ((1 << depth) - 1) : v;
+    };
+    auto sample_raw16 = [&](const uint8_t* row, size_t n) -> int {
+        return depth == 16 ? (row[n * 2] << 8) | row[n * 2 + 1] : sample(row, n, false);
+    };
+
+    Image img;
+    img.width = width;
+    img.height = height;
+    img.rgba.resize(size_t(width) * height);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = &px[y * stride];
+        for (int x = 0; x < width; ++x) {
+            uint32_t c = 0;
+            switch (color_type) {
+                case 0: {
+                    int g = sample(row, x, true);
+                    bool transparent = trns.size() >= 2 && sample_raw16(row, x) == ((trns[0] << 8) | trns[1]);
+                    c = JADRAW_RGBA(g, g, g, transparent ? 0 : 255);
+                    break;
+                }
+                case 2: {
+                    int r = sample(row, x * 3, true), g = sample(row, x * 3 + 1, true), b = sample(row, x * 3 + 2, true);
+                    bool transparent = trns.size() >= 6 &&
+                        sample_raw16(row, x * 3) == ((trns[0] << 8) | trns[1]) &&
+                        sample_raw16(row, x * 3 + 1) == ((trns[2] << 8) | trns[3]) &&
+                        sample_raw16(row, x * 3 + 2) == ((trns[4] << 8) | trns[5]);
+                    c = JADRAW_RGBA(r, g, b, transparent ? 0 : 255);
+                    break;
+                }
+                case 3: {
+                    int i = sample(row, x, false);
+                    if (size_t(i) >= plte.size()) throw std::runtime_error("png: palette index out of range");
+                    c = plte[i];
+                    if (size_t(i) < trns.size()) c = (c & 0xFFFFFF00u) | trns[i];
+                    break;
+                }
+                case 4: {
+                    int g = sample(row, x * 2, true), a = sample(row, x * 2 + 1, true);
+                    c = JADRAW_RGBA(g, g, g, a);
+                    break;
+                }
+                case 6: {
+                    c = JADRAW_RGBA(sample(row, x * 4, true), sample(row, x * 4 + 1, true),
+                                    sample(row, x * 4 + 2, true), sample(row, x * 4 + 3, true));
+                    break;
+                }
+            }
+            img.rgba[size_t(y) * width + x] = c;
+        }
+    }
+    return img;
+}
+
+static Image load_ppm(const std::vector<uint8_t>& file) {
+    size_t pos = 0;
+    auto next_token = [&]() -> std::string {
+        for (;;) {
+            while (pos < file.size() && isspace(file[pos])) ++pos;
+            if (pos < file.size() && file[pos] == '#') {
+                while (pos < file.size() && file[pos] != '\n') ++pos;
+                continue;
+            }
+            break;
+        }
+        std::string tok;
+        while (pos < file.size() && !isspace(file[pos])) tok += char(file[pos++]);
+        return tok;
+    };
+    std::string magic = next_token();
+    if (magic != "P6" && magic != "P3") throw std::runtime_error("ppm: only P3 and P6 are supported");
+    Image img;
+    img.width = std::stoi(next_token());
+    img.height = std::stoi(next_token());
+    int maxval = std::stoi(next_token());
+    if (img.width <= 0 || img.height <= 0 || maxval <= 0 || maxval > 65535) throw std::runtime_error("ppm: bad header");
+    pos++; // single whitespace after maxval
+    img.rgba.resize(size_t(img.width) * img.height);
+    const int bytes = maxval > 255 ? 2 : 1;
+    for (size_t i = 0; i < img.rgba.size(); ++i) {
+        int rgb[3];
+        for (int ch = 0; ch < 3; ++ch) {
+            int v;
+            if (magic == "P3") {
+                v = std::stoi(next_token());
+            } else {
+                if (pos + bytes > file.size()) throw std::runtime_error("ppm: image data too short");
+                v = bytes == 2 ? (file[pos] << 8) | file[pos + 1] : file[pos];
+                pos += bytes;
+            }
+            rgb[ch] = v * 255 / maxval;
+        }
+        img.rgba[i] = JADRAW_RGBA(rgb[0], rgb[1], rgb[2], 255);
+    }
+    return img;
+}
+
+static Image load_bmp(const std::vector<uint8_t>& file) {
+    if (file.size() < 54 || file[0] != 'B' || file[1] != 'M') throw std::runtime_error("bmp: bad signature");
+    uint32_t data_offset = le32(&file[10]);
+    uint32_t header_size = le32(&file[14]);
+    int32_t width = int32_t(le32(&file[18]));
+    int32_t height = int32_t(le32(&file[22]));
+    uint16_t bits = le16(&file[28]);
+    uint32_t compression = le32(&file[30]);
+    uint32_t colors_used = le32(&file[46]);
+    if (compression != 0 && !(compression == 3 && bits == 32)) throw std::runtime_error("bmp: compressed bitmaps are not supported");
+    bool top_down = height < 0;
+    if (top_down) height = -height;
+    if (width <= 0 || height <= 0) throw std::runtime_error("bmp: bad dimensions");
+
+    std::vector<uint32_t> palette;
+    if (bits <= 8) {
+        size_t count = colors_used ? colors_used : (1u << bits);
+        size_t p = 14 + header_size;
+        for (size_t i = 0; i < count && p + 4 <= file.size(); ++i, p += 4) {
+            palette.push_back(JADRAW_RGBA(file[p + 2], file[p + 1], file[p], 255));
+        }
+    }
+    const size_t stride = ((size_t(width) * bits + 31) / 32) * 4;
+    if (data_offset + stride * height > file.size()) throw std::runtime_error("bmp: image data too short");
+
+    Image img;
+    img.width = width;
+    img.height = height;
+    img.rgba.resize(size_t(width) * height);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = &file[data_offset + stride * (top_down ? y : height - 1 - y)];
+        for (int x = 0; x < width; ++x) {
+            uint32_t c;
+            switch (bits) {
+                case 32: c = JADRAW_RGBA(row[x * 4 + 2], row[x * 4 + 1], row[x * 4], row[x * 4 + 3]); break;
+                case 24: c = JADRAW_RGBA(row[x * 3 + 2], row[x * 3 + 1], row[x * 3], 255); break;
+                case 8: case 4: case 1: {
+                    size_t bit = size_t(x) * bits;
+                    int i = (row[bit / 8] >> (8 - bits - int(bit % 8))) & ((1 << bits) - 1);
+                    if (size_t(i) >= palette.size()) throw std::runtime_error("bmp: palette index out of range");
+                    c = palette[i];
+                    break;
+                }
+                default: throw std::runtime_error("bmp: unsupported bit depth");
+            }
+            img.rgba[size_t(y) * width + x] = c;
+        }
+    }
+    // 32-bit BMPs written without alpha leave the channel at zero; treat those as opaque.
+    if (bits == 32 && std::all_of(img.rgba.begin(), img.rgba.end(), [](uint32_t c) { return (c & 0xFF) == 0; })) {
+        for (uint32_t& c : img.rgba) c |= 0xFF;
+    }
+    return img;
+}
+
+static Image load_image(const std::string& path) {
+    std::vector<uint8_t> file = read_file(path);
+    if (file.size() >= 8 && file[0] == 0x89 && file[1] == 'P') return load_png(file);
+    if (file.size() >= 2 && file[0] == 'B' && file[1] == 'M') return load_bmp(file);
+    if (file.size() >= 2 && file[0] == 'P' && (file[1] == '6' || file[1] == '3')) return load_ppm(file);
+    throw std::runtime_error(path + ": unrecognized image format (expected PNG, PPM or BMP)");
+}
+
+// --- Quantization ---
+
+struct Indexed {
+    std::vector<uint32_t> palette;
+    std::vector<uint8_t> indices;
+};
+
+// Median cut over the opaque colors. Returns at most `max_colors` representative colors.
+static std::vector<uint32_t> median_cut(const std::vector<uint32_t>& colors, size_t max_colors) {
+    struct Box { std::vector<uint32_t> colors; };
+    auto channel = [](uint32_t c, int ch) { return int((c >> (24 - ch * 8)) & 0xFF); };
+    std::vector<Box> boxes{Box{colors}};
+    while (boxes.size() < max_colors) {
+        // Split the box with the widest channel range.
+        int best = -1, best_range = 0, best_ch = 0;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].colors.size() < 2) continue;
+            for (int ch = 0; ch < 3; ++ch) {
+                auto [lo, hi] = std::minmax_element(boxes[i].colors.begin(), boxes[i].colors.end(),
+                    [&](uint32_t a, uint32_t b) { return channel(a, ch) < channel(b, ch); });
+                int range = channel(*hi, ch) - channel(*lo, ch);
+                if (range > best_range) { best = int(i); best_range = range; best_ch = ch; }
+            }
+        }
+        if (best < 0) break;
+        std::vector<uint32_t>& c = boxes[best].colors;
+        std::sort(c.begin(), c.end(), [&](uint32_t a, uint32_t b) { return channel(a, best_ch) < channel(b, best_ch); });
+        Box upper{std::vector<uint32_t>(c.begin() + c.size() / 2, c.end())};
+        c.resize(c.size() / 2);
+        boxes.push_back(std::move(upper));
+    }
+    std::vector<uint32_t> result;
+    for (const Box& box : boxes) {
+        uint64_t sum[3] = {};
+        for (uint32_t c : box.colors) for (int ch = 0; ch < 3; ++ch) sum[ch] += channel(c, ch);
+        size_t n = box.colors.size();
+        result.push_back(JADRAW_RGBA(sum[0] / n, sum[1] / n, sum[2] / n, 255));
+    }
+    return result;
+}
+
+static Indexed quantize(const Image& img, size_t max_colors, int alpha_threshold) {
+    const uint32_t TRANSPARENT = JADRAW_RGBA(0, 0, 0, 0);
+    bool has_transparent = false;
+    std::vector<uint32_t> opaque;
+    std::map<uint32_t, int> seen;
+    for (uint32_t c : img.rgba) {
+        if (int(c & 0xFF) < alpha_threshold) { has_transparent = true; continue; }
+        c |= 0xFF;
+        if (seen.emplace(c, 0).second) opaque.push_back(c);
+    }
+
+    Indexed out;
+    if (has_transparent) out.palette.push_back(TRANSPARENT); // index 0, like the hand-made sprites
+    size_t budget = max_colors - out.palette.size();
+    std::vector<uint32_t> colors = opaque.size() <= budget ? opaque : median_cut(opaque, budget);
+    out.palette.insert(out.palette.end(), colors.begin(), colors.end());
+
+    std::map<uint32_t, uint8_t> lookup;
+    auto nearest = [&](uint32_t c) -> uint8_t {
+        auto it = lookup.find(c);
+        if (it != lookup.end()) return it->second;
+        int best = -1;
+        long best_d = 0;
+        for (size_t i = has_transparent ? 1 : 0; i < out.palette.size(); ++i) {
+            long d = 0;
+            for (int ch = 0; ch < 3; ++ch) {
+                long diff = long((c >> (24 - ch * 8)) & 0xFF) - long((out.palette[i] >> (24 - ch * 8)) & 0xFF);
+                d += diff * diff;
+            }
+            if (best < 0 || d < best_d) { best = int(i); best_d = d; }
+        }
+        return lookup[c] = uint8_t(best);
+    };
+    out.indices.reserve(img.rgba.size());
+    for (uint32_t c : img.rgba) {
+        out.indices.push_back(int(c & 0xFF) < alpha_threshold ? 0 : nearest(c | 0xFF));
+    }
+    return out;
+}
+
+// --- Encoders (must match JaSpriteEncoding in JaDraw.h) ---
+
+enum class Format { RAW, PACKED, RLE, AUTO };
+
+static int packed_bits(size_t palette_size) {
+    if (palette_size <= 2) return 1;
+    if (palette_size <= 4) return 2;
+    if (palette_size <= 16) return 4;
+    return 0; // not packable
+}
+
+static std::vector<uint8_t> encode_packed(const Indexed& ix, int w, int h, int bits) {
+    const size_t stride = (size_t(w) * bits + 7) / 8;
+    std::vector<uint8_t> out(stride * h, 0);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            size_t bit = size_t(x) * bits;
+            out[y * stride + bit / 8] |= uint8_t(ix.indices[size_t(y) * w + x] << (8 - bits - int(bit % 8)));
+        }
+    }
+    return out;
+}
+
+static std::vector<uint8_t> encode_rle(const Indexed& ix, int w, int h) {
+    std::vector<uint8_t> out;
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* row = &ix.indices[size_t(y) * w];
+        for (int x = 0; x < w;) {
+            int run = 1;
+            while (x + run < w && run < 255 && row[x + run] == row[x]) ++run;
+            out.push_back(uint8_t(run));
+            out.push_back(row[x]);
+            x += run;
+        }
+    }
+    return out;
+}
+
+// --- Header output ---
+
+struct Sprite {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    Indexed indexed;
+    Format format = Format::RAW;
+    int bits = 8;
+    std::vector<uint8_t> data;
+    std::string palette_owner; // name of the sprite whose palette array this one reuses
+    std::vector<std::vector<uint8_t>> deltas; // animation only, see JaSpriteFrameDelta
+};
+
+// Changed-pixel runs turning frame `from` into frame `to` (JaSpriteFrameDelta layout).
+static std::vector<uint8_t> encode_delta(const uint8_t* from, const uint8_t* to, int w, int h) {
+    // An unchanged gap shorter than a run header is cheaper to copy than to split the run over.
+    const int MERGE_GAP = 3;
+    std::vector<uint8_t> out;
+    for (int y = 0; y < h; ++y) {
+        const size_t row = size_t(y) * w;
+        int x = 0;
+        while (x < w) {
+            if (from[row + x] == to[row + x]) { ++x; continue; }
+            int end = x + 1; // one past the last changed pixel in this run
+            int scan = end;
+            while (scan < w && scan - x < 255) {
+                if (from[row + scan] != to[row + scan]) {
+                    end = scan + 1;
+                } else if (scan - end >= MERGE_GAP) {
+                    break;
+                }
+                ++scan;
+            }
+            const size_t offset = row + x;
+            out.push_back(uint8_t(offset & 0xFF));
+            out.push_back(uint8_t(offset >> 8));
+            out.push_back(uint8_t(end - x));
+            out.insert(out.end(), to + offset, to + row + end);
+            x = end;
+        }
+    }
+    return out;
+}
+
+static std::string sanitize(std::string s) {
+    for (char& c : s) if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+    if (s.empty() || isdigit(static_cast<unsigned char>(s[0]))) s = "_" + s;
+    return s;
+}
+
+static std::string stem(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = base.find_last_of('.');
+    return dot == std::string::npos ? base : base.substr(0, dot);
+}
+
+static const char* format_name(Format f) {
+    switch (f) {
+        case Format::RAW: return "raw";
+        case Format::PACKED: return "packed";
+        case Format::RLE: return "rle";
+        default: return "auto";
+    }
+}
+
+static void write_bytes(std::ostream& os, const std::vector<uint8_t>& data, int per_line) {
+    char buf[8];
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (i % per_line == 0) os << "        ";
+        snprintf(buf, sizeof(buf), "0x%02x", data[i]);
+        os << buf;
+        if (i + 1 < data.size()) os << ", ";
+        if ((i + 1) % per_line == 0 || i + 1 == data.size()) os << "\n";
+    }
+}
+
+static void write_header(const std::string& path, const std::string& ns, const std::vector<Sprite>& sprites) {
+    std::string guard = sanitize(stem(path));
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) { return char(toupper(c)); });
+    guard += "_H";
+
+    std::ostringstream os;
+    os << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+    os << "#include \"JaDraw.h\" // Includes JaSprite definition\n";
+    if (std::any_of(sprites.begin(), sprites.end(), [](const Sprite& s) { return !s.deltas.empty(); })) {
+        os << "#include \"JaSpriteAnimation.h\"\n";
+    }
+    os << "\n";
+    os << "// Generated by tools/jasprite_convert. Do not edit by hand.\n\n";
+    os << "namespace " << ns << " {\n";
+    for (const Sprite& s : sprites) {
+        const std::string& n = s.name;
+        os << "\n";
+        os << "    constexpr int " << n << "_width = " << s.width << ";\n";
+        os << "    constexpr int " << n << "_height = " << s.height << ";\n\n";
+        if (s.palette_owner.empty()) {
+            os << "    constexpr uint32_t " << n << "_palette_data[] = {\n";
+            for (size_t i = 0; i < s.indexed.palette.size(); ++i) {
+                uint32_t c = s.indexed.palette[i];
+                os << "        JADRAW_RGBA(" << (c >> 24) << ", " << ((c >> 16) & 0xFF) << ", "
+                   << ((c >> 8) & 0xFF) << ", " << (c & 0xFF) << ")" << (i + 1 < s.indexed.palette.size() ? "," : "") << "\n";
+            }
+            os << "    };\n";
+        }
+        const std::string palette = (s.palette_owner.empty() ? n : s.palette_owner) + "_palette_data";
+        if (s.format == Format::RAW) {
+            os << "    constexpr uint8_t " << n << "_pixel_data[" << n << "_width * " << n << "_height] = {\n";
+            write_bytes(os, s.data, std::min(s.width, 32));
+        } else {
+            os << "    constexpr uint8_t " << n << "_pixel_data[] = {\n";
+            write_bytes(os, s.data, 16);
+        }
+        os << "    };\n\n";
+        os << "    constexpr JaSprite " << n << "(" << n << "_width, " << n << "_height, std::span{" << palette
+           << "}, std::span{" << n << "_pixel_data}";
+        if (s.format == Format::PACKED) os << ", JaSpriteEncoding::PACKED, " << s.bits;
+        if (s.format == Format::RLE) os << ", JaSpriteEncoding::RLE";
+        os << ");\n";
+        if (!s.deltas.empty()) {
+            for (size_t f = 0; f < s.deltas.size(); ++f) {
+                if (s.deltas[f].empty()) continue;
+                os << "\n    constexpr uint8_t " << n << "_delta" << f << "[] = {\n";
+                write_bytes(os, s.deltas[f], 16);
+                os << "    };\n";
+            }
+            os << "\n    constexpr JaSpriteFrameDelta " << n << "_deltas[] = {\n";
+            for (size_t f = 0; f < s.deltas.size(); ++f) {
+                if (s.deltas[f].empty()) {
+                    os << "        JaSpriteFrameDelta{}";
+                } else {
+                    os << "        JaSpriteFrameDelta{std::span{" << n << "_delta" << f << "}}";
+                }
+                os << (f + 1 < s.deltas.size() ? ",\n" : "\n");
+            }
+            os << "    };\n";
+        }
+    }
+    os << "}\n\n#endif // " << guard << "\n";
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f << os.str();
+}
+
+static JaSpriteEncoding to_encoding(Format f) {
+    return f == Format::PACKED ? JaSpriteEncoding::PACKED : f == Format::RLE ? JaSpriteEncoding::RLE : JaSpriteEncoding::RAW;
+}
+
+static void write_pack(const std::string& path, const std::vector<Sprite>& sprites) {
+    std::vector<uint8_t> blob;
+    auto align = [&]() { blob.resize((blob.size() + JAPACK_ALIGN - 1) / JAPACK_ALIGN * JAPACK_ALIGN, 0); };
+    auto append = [&](const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        blob.insert(blob.end(), b, b + n);
+    };
+
+    std::vector<size_t> order(sprites.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return japackHash(sprites[a].name.c_str()) < japackHash(sprites[b].name.c_str());
+    });
+
+    // Header and index first; the index is patched once blob offsets are known.
+    JaPackHeader header{};
+    header.magic = JAPACK_MAGIC;
+    header.version = JAPACK_VERSION;
+    header.entry_size = sizeof(JaPackEntry);
+    header.sprite_count = uint32_t(sprites.size());
+    header.index_offset = sizeof(JaPackHeader);
+    std::vector<JaPackEntry> entries(sprites.size());
+    blob.resize(sizeof(JaPackHeader) + entries.size() * sizeof(JaPackEntry));
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        entries[i].name_offset = uint32_t(blob.size());
+        append(sprites[order[i]].name.c_str(), sprites[order[i]].name.size() + 1);
+    }
+    std::map<std::string, uint32_t> palette_offsets;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Sprite& s = sprites[order[i]];
+        JaPackEntry& e = entries[i];
+        e.name_hash = japackHash(s.name.c_str());
+        e.width = uint16_t(s.width);
+        e.height = uint16_t(s.height);
+        e.encoding = uint8_t(to_encoding(s.format));
+        e.bits_per_pixel = uint8_t(s.bits);
+        e.palette_count = uint16_t(s.indexed.palette.size());
+        const std::string& owner = s.palette_owner.empty() ? s.name : s.palette_owner;
+        auto it = palette_offsets.find(owner);
+        if (it == palette_offsets.end()) {
+            align();
+            it = palette_offsets.emplace(owner, uint32_t(blob.size())).first;
+            append(s.indexed.palette.data(), s.indexed.palette.size() * sizeof(uint32_t));
+        }
+        e.palette_offset = it->second;
+        align();
+        e.pixel_offset = uint32_t(blob.size());
+        e.pixel_size = uint32_t(s.data.size());
+        append(s.data.data(), s.data.size());
+    }
+    align();
+    header.file_size = uint32_t(blob.size());
+    memcpy(blob.data(), &header, sizeof(header));
+    memcpy(blob.data() + header.index_offset, entries.data(), entries.size() * sizeof(JaPackEntry));
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f.write(reinterpret_cast<const char*>(blob.data()), std::streamsize(blob.size()));
+    printf("wrote %s: %zu sprites, %zu bytes\n", path.c_str(), sprites.size(), blob.size());
+}
+
+// Picks an encoding for an indexed image and registers its palette for sharing.
+static Sprite make_sprite(const std::string& name, Indexed indexed, int width, int height, Format format,
+                          std::map<std::vector<uint32_t>, std::string>& palettes) {
+    Sprite s;
+    s.name = name;
+    s.width = width;
+    s.height = height;
+    s.indexed = std::move(indexed);
+
+    // Candidate encodings; ties go to the cheaper decoder (raw, then packed, then RLE).
+    std::vector<uint8_t> raw = s.indexed.indices;
+    int bits = packed_bits(s.indexed.palette.size());
+    std::vector<uint8_t> packed = bits ? encode_packed(s.indexed, s.width, s.height, bits) : std::vector<uint8_t>{};
+    std::vector<uint8_t> rle = encode_rle(s.indexed, s.width, s.height);
+    Format chosen = format;
+    if (chosen == Format::AUTO) {
+        chosen = Format::RAW;
+        size_t best = raw.size();
+        if (bits && packed.size() < best) { chosen = Format::PACKED; best = packed.size(); }
+        if (rle.size() < best) { chosen = Format::RLE; best = rle.size(); }
+    }
+    if (chosen == Format::PACKED && !bits) {
+        throw std::runtime_error(name + ": " + std::to_string(s.indexed.palette.size()) +
+                                 " colors is too many for packed format (max 16)");
+    }
+    s.format = chosen;
+    s.bits = chosen == Format::PACKED ? bits : 8;
+    s.data = chosen == Format::RAW ? raw : chosen == Format::PACKED ? packed : rle;
+
+    auto [it, inserted] = palettes.emplace(s.indexed.palette, s.name);
+    if (!inserted) s.palette_owner = it->second;
+
+    const size_t palette_bytes = s.indexed.palette.size() * 4;
+    printf("%-24s %4dx%-4d %3zu colors  palette=%zu%s  raw=%zu  packed=", s.name.c_str(), s.width, s.height,
+           s.indexed.palette.size(), palette_bytes, inserted ? "" : " (shared)", raw.size());
+    if (bits) printf("%zu(%dbpp)", packed.size(), bits); else printf("-");
+    printf("  rle=%zu  -> %s\n", rle.size(), format_name(chosen));
+    return s;
+}
+
+static void usage() {
+    std::cerr << "usage: jasprite_convert [--namespace N] [--format raw|packed|rle|auto] [--colors N] [--alpha N]\n"
+                 "                        [-o out.h] [--pack out.jpk] image [image ...] [--anim name n frame ...]\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string out_path;
+    std::string pack_path;
+    std::string ns = "Sprites";
+    Format format = Format::AUTO;
+    size_t max_colors = 256;
+    int alpha_threshold = 128;
+    std::vector<Sprite> sprites;
+    std::map<std::vector<uint32_t>, std::string> palettes;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error(arg + " needs a value");
+                return argv[++i];
+            };
+            if (arg == "-o") {
+                out_path = value();
+            } else if (arg == "--pack") {
+                pack_path = value();
+            } else if (arg == "--namespace") {
+                ns = value();
+            } else if (arg == "--colors") {
+                max_colors = std::stoul(value());
+                if (max_colors < 2 || max_colors > 256) throw std::runtime_error("--colors must be 2-256");
+            } else if (arg == "--alpha") {
+                alpha_threshold = std::stoi(value());
+            } else if (arg == "--format") {
+                std::string f = value();
+                if (f == "raw") format = Format::RAW;
+                else if (f == "packed") format = Format::PACKED;
+                else if (f == "rle") format = Format::RLE;
+                else if (f == "auto") format = Format::AUTO;
+                else throw std::runtime_error("unknown format " + f);
+            } else if (arg == "--anim") {
+                std::string name = sanitize(value());
+                int count = std::stoi(value());
+                if (count < 1 || i + count >= argc) throw std::runtime_error("--anim needs a name, a frame count and that many images");
+                // Quantize every frame together by stacking them into one tall image.
+                Image stacked;
+                for (int f = 0; f < count; ++f) {
+                    Image img = load_image(argv[++i]);
+                    if (f == 0) {
+                        stacked.width = img.width;
+                    } else if (img.width != stacked.width || img.height != stacked.height / f) {
+                        throw std::runtime_error(std::string(argv[i]) + ": animation frames must all be the same size");
+                    }
+                    stacked.height += img.height;
+                    stacked.rgba.insert(stacked.rgba.end(), img.rgba.begin(), img.rgba.end());
+                }
+                const int h = stacked.height / count;
+                if (size_t(stacked.width) * h > 65536) throw std::runtime_error(name + ": animation frames are limited to 65536 pixels");
+                Indexed all = quantize(stacked, max_colors, alpha_threshold);
+                const size_t frame_size = size_t(stacked.width) * h;
+                Indexed key{all.palette, std::vector<uint8_t>(all.indices.begin(), all.indices.begin() + frame_size)};
+                Sprite s = make_sprite(name, key, stacked.width, h, format, palettes);
+                size_t delta_bytes = 0;
+                for (int f = 0; f < count; ++f) {
+                    const uint8_t* from = &all.indices[frame_size * f];
+                    const uint8_t* to = &all.indices[frame_size * ((f + 1) % count)];
+                    s.deltas.push_back(encode_delta(from, to, stacked.width, h));
+                    delta_bytes += s.deltas.back().size();
+                }
+                printf("%-24s %d frames: raw frames=%zu  keyframe+deltas=%zu\n", "", count,
+                       frame_size * count, s.data.size() + delta_bytes);
+                sprites.push_back(std::move(s));
+            } else if (!arg.empty() && arg[0] == '-') {
+                usage();
+                return 1;
+            } else {
+                Image img = load_image(arg);
+                sprites.push_back(make_sprite(sanitize(stem(arg)), quantize(img, max_colors, alpha_threshold),
+                                              img.width, img.height, format, palettes));
+            }
+        }
+        if ((out_path.empty() && pack_path.empty()) || sprites.empty()) {
+            usage();
+            return 1;
+        }
+        if (!out_path.empty()) {
+            write_header(out_path, ns, sprites);
+
+            size_t total = 0;
+            for (const Sprite& s : sprites) {
+                total += s.data.size() + (s.palette_owner.empty() ? s.indexed.palette.size() * 4 : 0);
+                for (const std::vector<uint8_t>& d : s.deltas) total += d.size();
+            }
+            printf("wrote %s: %zu sprites, %zu palettes, %zu bytes of sprite data\n",
+                   out_path.c_str(), sprites.size(), palettes.size(), total);
+        }
+        if (!pack_path.empty()) {
+            for (const Sprite& s : sprites) {
+                if (s.width > 0xFFFF || s.height > 0xFFFF) throw std::runtime_error(s.name + ": too large for a sprite pack");
+            }
+            write_pack(pack_path, sprites);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "jasprite_convert: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}